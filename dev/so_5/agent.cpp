@@ -849,6 +849,16 @@ agent_t::so_was_defined() const
 	return agent_status_t::not_defined_yet != m_current_status;
 }
 
+void
+agent_t::so_set_static_handler_finder(
+	static_handler_finder_t finder ) noexcept
+{
+	// Static event handlers can't be used with message delivery tracing
+	// because the search for an event handler has to be traced.
+	if( &agent_t::handler_finder_msg_tracing_disabled == m_handler_finder )
+		m_static_handler_finder = finder;
+}
+
 environment_t &
 agent_t::so_environment() const noexcept
 {
@@ -1010,6 +1020,10 @@ agent_t::destroy_all_subscriptions_and_filters() noexcept
 {
 	drop_all_delivery_filters();
 	m_subscriptions->drop_all_subscriptions();
+
+	// Static event handlers mustn't be used after the removal of
+	// all subscriptions.
+	m_static_handler_finder = nullptr;
 }
 
 agent_ref_t
@@ -1147,6 +1161,10 @@ agent_t::so_destroy_deadletter_subscription(
 	ensure_operation_is_on_working_thread( "do_drop_deadletter_handler" );
 
 	m_subscriptions->drop_subscription( mbox, msg_type, deadletter_state );
+
+	// The removed deadletter handler can be one of static event handlers.
+	// The usual search in the subscription storage will be used from now.
+	m_static_handler_finder = nullptr;
 }
 
 abstract_message_sink_t &
@@ -1374,6 +1392,13 @@ agent_t::demand_handler_on_message(
 {
 	message_limit::control_block_t::decrement( d.m_limit );
 
+	if( const auto static_finder = d.m_receiver->m_static_handler_finder )
+		if( const auto static_handler = static_finder( d ) )
+		{
+			process_message( working_thread_id, d, static_handler );
+			return;
+		}
+
 	auto handler = d.m_receiver->m_handler_finder(
 			d, "demand_handler_on_message" );
 	if( handler )
@@ -1408,12 +1433,13 @@ agent_t::get_demand_handler_on_enveloped_msg_ptr() noexcept
 	return &agent_t::demand_handler_on_enveloped_msg;
 }
 
+template< typename Handler >
 void
-agent_t::process_message(
+agent_t::call_event_handler(
 	current_thread_id_t working_thread_id,
 	execution_demand_t & d,
 	thread_safety_t thread_safety,
-	event_handler_method_t method )
+	Handler && handler )
 {
 	impl::agent_impl::working_thread_id_sentinel_t sentinel{
 			d.m_receiver->m_working_thread_id,
@@ -1427,7 +1453,7 @@ agent_t::process_message(
 
 	try
 	{
-		method( d.m_message_ref );
+		handler( d.m_message_ref );
 	}
 	catch( const std::exception & x )
 	{
@@ -1441,6 +1467,29 @@ agent_t::process_message(
 	}
 }
 
+void
+agent_t::process_message(
+	current_thread_id_t working_thread_id,
+	execution_demand_t & d,
+	thread_safety_t thread_safety,
+	event_handler_method_t method )
+{
+	call_event_handler( working_thread_id, d, thread_safety,
+			[&method]( message_ref_t & msg ) { method( msg ); } );
+}
+
+void
+agent_t::process_message(
+	current_thread_id_t working_thread_id,
+	execution_demand_t & d,
+	static_event_handler_pfn_t handler )
+{
+	call_event_handler( working_thread_id, d, so_5::not_thread_safe,
+			[&d, handler]( message_ref_t & msg ) {
+				handler( *(d.m_receiver), msg );
+			} );
+}
+
 void
 agent_t::process_enveloped_msg(
 	current_thread_id_t working_thread_id,
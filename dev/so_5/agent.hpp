@@ -2269,6 +2269,69 @@ class SO_5_TYPE agent_t
 		 * \}
 		 */
 
+		/*!
+		 * \name Methods for static dispatching of messages.
+		 * \{
+		 */
+		/*!
+		 * \brief Type of event handler that is called directly, without
+		 * type-erasure of event_handler_method_t.
+		 *
+		 * \since v.5.8.5
+		 */
+		using static_event_handler_pfn_t = void (*)(
+				agent_t & /* receiver */,
+				message_ref_t & /* message */ );
+
+		/*!
+		 * \brief Type of function for searching a static event handler
+		 * for a demand.
+		 *
+		 * Should return nullptr if there is no static event handler
+		 * for the demand. In that case the usual search in the
+		 * subscription storage will be performed.
+		 *
+		 * \since v.5.8.5
+		 */
+		using static_handler_finder_t = static_event_handler_pfn_t (*)(
+				const execution_demand_t & /* demand */ ) noexcept;
+
+		/*!
+		 * \brief Set a function for searching static event handlers.
+		 *
+		 * \note
+		 * This is low-level method intended to be used by libraries writters.
+		 * See so_5::static_agent_t as an example.
+		 *
+		 * \attention
+		 * The static event handler is used instead of the search in the
+		 * subscription storage. So the result of \a finder has to be
+		 * consistent with subscriptions of the agent: if \a finder returns
+		 * a handler for a demand then the usual search would find the
+		 * equivalent handler for that demand.
+		 *
+		 * \note
+		 * The finder is reset (and the usual search in the subscription
+		 * storage is used after that) when all subscriptions of the agent
+		 * are destroyed (for example, by so_deactivate_agent()) and
+		 * when any deadletter handler is dropped.
+		 *
+		 * \note
+		 * Static event handlers aren't used if message delivery tracing is
+		 * turned on. It's necessary for tracing of event handler search.
+		 *
+		 * \note
+		 * Static event handlers are always treated as not thread-safe ones.
+		 *
+		 * \since v.5.8.5
+		 */
+		void
+		so_set_static_handler_finder(
+			static_handler_finder_t finder ) noexcept;
+		/*!
+		 * \}
+		 */
+
 	public:
 		//! Access to the SObjectizer Environment which this agent is belong.
 		/*!
@@ -2498,6 +2561,43 @@ class SO_5_TYPE agent_t
 			//! Delivery filter as lambda-function or functional object.
 			Lambda && lambda );
 
+		/*!
+		 * \brief Set a keyed delivery filter.
+		 *
+		 * A message is delivered only if the key extracted from the
+		 * message is equal to \a key. Standard MPMC mboxes index such
+		 * filters by keys, so the cost of delivery doesn't depend on the
+		 * count of subscribers that wait for other keys.
+		 *
+		 * \tparam Key_Extractor type of lambda-function or functional object
+		 * that extracts a key from a message. It must be a stateless type
+		 * (like a lambda-function without captures).
+		 *
+		 * \par Usage sample:
+		 \code
+		 void instrument_listener::so_define_agent() {
+		 	so_set_keyed_delivery_filter( quotes,
+				[]( const quote & msg ) -> const std::string & {
+					return msg.m_symbol;
+				},
+				std::string{ "AAPL" } );
+			...
+		 }
+		 \endcode
+		 *
+		 * \since v.5.8.5
+		 */
+		template< typename Key_Extractor, typename Key >
+		void
+		so_set_keyed_delivery_filter(
+			//! Message box from which message is expected.
+			//! This must be MPMC-mbox.
+			const mbox_t & mbox,
+			//! Key extractor as lambda-function or functional object.
+			Key_Extractor && extractor,
+			//! The expected value of the key.
+			Key && key );
+
 		/*!
 		 * \brief Drop a delivery filter.
 		 *
@@ -2822,6 +2922,15 @@ class SO_5_TYPE agent_t
 		 */
 		handler_finder_t m_handler_finder;
 
+		/*!
+		 * \brief Function for searching static event handlers.
+		 *
+		 * It's nullptr if static event handlers aren't used.
+		 *
+		 * \since v.5.8.5
+		 */
+		static_handler_finder_t m_static_handler_finder{ nullptr };
+
 		/*!
 		 * \brief All agent's subscriptions.
 		 *
@@ -3208,6 +3317,32 @@ class SO_5_TYPE agent_t
 			thread_safety_t thread_safety,
 			event_handler_method_t method );
 
+		/*!
+		 * \brief Actual implementation of message handling by a static
+		 * event handler.
+		 *
+		 * \since v.5.8.5
+		 */
+		static void
+		process_message(
+			current_thread_id_t working_thread_id,
+			execution_demand_t & d,
+			static_event_handler_pfn_t handler );
+
+		/*!
+		 * \brief Call of an event handler with the respect to
+		 * the handler's thread safety and exceptions thrown out.
+		 *
+		 * \since v.5.8.5
+		 */
+		template< typename Handler >
+		static void
+		call_event_handler(
+			current_thread_id_t working_thread_id,
+			execution_demand_t & d,
+			thread_safety_t thread_safety,
+			Handler && handler );
+
 		/*!
 		 * \brief Actual implementation of enveloped message handling.
 		 *
@@ -3453,6 +3588,34 @@ agent_t::so_set_delivery_filter_for_mutable_msg(
 				} );
 	}
 
+template< typename Key_Extractor, typename Key >
+void
+agent_t::so_set_keyed_delivery_filter(
+	const mbox_t & mbox,
+	Key_Extractor && extractor,
+	Key && key )
+	{
+		using namespace so_5::details::lambda_traits;
+
+		using extractor_type = std::remove_reference_t< Key_Extractor >;
+		using argument_type =
+				typename argument_type_if_lambda< extractor_type >::type;
+		using key_type = std::decay_t<
+				std::invoke_result_t< extractor_type, const argument_type & > >;
+
+		ensure_not_signal< argument_type >();
+
+		do_set_delivery_filter(
+				mbox,
+				message_payload_type< argument_type >::subscription_type_index(),
+				delivery_filter_unique_ptr_t{
+					new low_level_api::keyed_lambda_as_filter_t<
+								extractor_type, argument_type, key_type >(
+							std::move( extractor ),
+							key_type( std::forward< Key >( key ) ) )
+				} );
+	}
+
 //
 // subscription_bind_t implementation
 //
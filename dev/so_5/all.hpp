@@ -31,9 +31,14 @@
 #include <so_5/disp/thread_pool/pub.hpp>
 #include <so_5/disp/adv_thread_pool/pub.hpp>
 #include <so_5/disp/nef_thread_pool/pub.hpp>
+#include <so_5/disp/prio_thread_pool/pub.hpp>
+#include <so_5/disp/edf_one_thread/pub.hpp>
+#include <so_5/disp/epoll_one_thread/pub.hpp>
+#include <so_5/disp/sharded_one_thread/pub.hpp>
 #include <so_5/disp/prio_one_thread/strictly_ordered/pub.hpp>
 #include <so_5/disp/prio_one_thread/quoted_round_robin/pub.hpp>
 #include <so_5/disp/prio_dedicated_threads/one_per_prio/pub.hpp>
+#include <so_5/disp/affinity_work_thread.hpp>
 
 #include <so_5/version.hpp>
 
@@ -43,3 +48,9 @@
 
 #include <so_5/msg_tracing_individual.hpp>
 
+#include <so_5/shared_buffer.hpp>
+
+#include <so_5/static_agent.hpp>
+
+#include <so_5/coro.hpp>
+
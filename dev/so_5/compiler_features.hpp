@@ -20,3 +20,14 @@
 	#define SO_5_CLANG
 #endif
 
+
+/*!
+ * \brief Defined if C++20 coroutines are supported.
+ *
+ * \since v.5.8.5
+ */
+#if defined( __cpp_impl_coroutine ) && defined( __has_include )
+	#if __has_include( <coroutine> )
+		#define SO_5_HAVE_COROUTINES
+	#endif
+#endif
@@ -20,6 +20,7 @@
 #include <so_5/agent.hpp>
 #include <so_5/disp_binder.hpp>
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -1168,6 +1169,16 @@ class coop_t : public std::enable_shared_from_this<coop_t>
 		 */
 		coop_shptr_t m_next_in_final_dereg_chain;
 
+		/*!
+		 * \brief The moment when the coop was added to the chain
+		 * for the final deregistration.
+		 *
+		 * It's used for the run-time monitoring only.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::chrono::steady_clock::time_point m_final_dereg_enqueued_at;
+
 		/*!
 		 * \brief Increment usage count for the coop.
 		 *
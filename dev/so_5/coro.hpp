@@ -0,0 +1,902 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Support for C++20 coroutines inside agents.
+ *
+ * \note
+ * This header requires C++20 coroutines. It's empty if coroutines
+ * aren't supported by the compiler (see SO_5_HAVE_COROUTINES).
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/compiler_features.hpp>
+
+#if defined( SO_5_HAVE_COROUTINES )
+
+#include <so_5/agent.hpp>
+#include <so_5/mchain.hpp>
+#include <so_5/message_holder.hpp>
+#include <so_5/send_functions.hpp>
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace so_5
+{
+
+namespace coro
+{
+
+template< typename T = void >
+class task_t;
+
+namespace details
+{
+
+//
+// detached_exception_slot
+//
+/*!
+ * \brief A place for an exception from a detached coroutine.
+ *
+ * A detached coroutine (started by spawn()) has nobody to get its
+ * exception. The exception is stored here and rethrown by
+ * resume_coroutine() on the same thread.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+inline std::exception_ptr &
+detached_exception_slot() noexcept
+	{
+		static thread_local std::exception_ptr slot;
+		return slot;
+	}
+
+//
+// resume_coroutine
+//
+/*!
+ * \brief Resume a coroutine and rethrow an exception from
+ * a detached coroutine if it finished with an exception.
+ *
+ * The exception goes to the event handler of the agent, so
+ * the agent's exception reaction is applied.
+ *
+ * \since v.5.8.5
+ */
+inline void
+resume_coroutine( std::coroutine_handle<> h )
+	{
+		h.resume();
+
+		auto & slot = detached_exception_slot();
+		if( slot )
+			std::rethrow_exception( std::exchange( slot, std::exception_ptr{} ) );
+	}
+
+//
+// promise_base_t
+//
+/*!
+ * \brief The common part of all promise types of task_t.
+ *
+ * \since v.5.8.5
+ */
+class promise_base_t
+	{
+	public :
+		//! Awaiter for the final suspension point.
+		/*!
+		 * Transfers control to the awaiting coroutine or destroys
+		 * the frame of a detached coroutine.
+		 */
+		struct final_awaiter_t
+			{
+				[[nodiscard]]
+				bool
+				await_ready() const noexcept { return false; }
+
+				template< typename Promise >
+				[[nodiscard]]
+				std::coroutine_handle<>
+				await_suspend( std::coroutine_handle< Promise > h ) noexcept
+					{
+						promise_base_t & p = h.promise();
+						if( p.m_continuation )
+							return p.m_continuation;
+
+						if( p.m_detached )
+							{
+								if( p.m_exception )
+									detached_exception_slot() = std::move(p.m_exception);
+								h.destroy();
+							}
+
+						return std::noop_coroutine();
+					}
+
+				void
+				await_resume() const noexcept {}
+			};
+
+		[[nodiscard]]
+		std::suspend_always
+		initial_suspend() const noexcept { return {}; }
+
+		[[nodiscard]]
+		final_awaiter_t
+		final_suspend() const noexcept { return {}; }
+
+		void
+		unhandled_exception() noexcept
+			{
+				m_exception = std::current_exception();
+			}
+
+		//! The coroutine to be resumed when this one completes.
+		std::coroutine_handle<> m_continuation;
+
+		//! The outermost coroutine of a detached chain.
+		/*!
+		 * It's destroyed if a wait can't be completed anymore
+		 * (for example, the agent is deregistered).
+		 */
+		std::coroutine_handle<> m_root;
+
+		//! Is this coroutine started by spawn()?
+		bool m_detached{ false };
+
+		//! An exception from the body of the coroutine.
+		std::exception_ptr m_exception;
+	};
+
+//
+// promise_value_t
+//
+/*!
+ * \brief Storage for a value returned by a coroutine.
+ *
+ * \since v.5.8.5
+ */
+template< typename T >
+class promise_value_t
+	{
+		std::optional< T > m_value;
+
+	public :
+		template< typename V >
+		void
+		return_value( V && v )
+			{
+				m_value.emplace( std::forward<V>(v) );
+			}
+
+		[[nodiscard]]
+		T
+		take_value()
+			{
+				return std::move( *m_value );
+			}
+	};
+
+template<>
+class promise_value_t< void >
+	{
+	public :
+		void
+		return_void() const noexcept {}
+
+		void
+		take_value() const noexcept {}
+	};
+
+//
+// root_of
+//
+/*!
+ * \brief Get the root of a detached chain for the awaiting coroutine.
+ *
+ * An empty handle is returned if the awaiting coroutine isn't a task_t.
+ *
+ * \since v.5.8.5
+ */
+template< typename Promise >
+[[nodiscard]]
+std::coroutine_handle<>
+root_of( std::coroutine_handle< Promise > h ) noexcept
+	{
+		if constexpr( std::is_base_of_v< promise_base_t, Promise > )
+			return h.promise().m_root;
+		else
+			return {};
+	}
+
+//
+// msg_receive_timeout
+//
+//! A signal about the timeout for receive_next().
+struct msg_receive_timeout final : public so_5::signal_t {};
+
+//
+// msg_mchain_not_empty
+//
+//! A signal about a new message in a notifying mchain.
+struct msg_mchain_not_empty final : public so_5::signal_t {};
+
+//
+// result_traits_t
+//
+/*!
+ * \brief Type of the result of receive_next() and the way to fill it.
+ *
+ * It's std::optional<so_5::message_holder_t<Msg>> for a message and
+ * bool for a signal.
+ *
+ * \since v.5.8.5
+ */
+template<
+	typename Msg,
+	bool Is_Signal = message_payload_type< Msg >::is_signal >
+struct result_traits_t
+	{
+		using result_t = std::optional< so_5::message_holder_t< Msg > >;
+
+		static void
+		store( result_t & to, mhood_t< Msg > & cmd )
+			{
+				to = cmd.make_holder();
+			}
+	};
+
+template< typename Msg >
+struct result_traits_t< Msg, true >
+	{
+		using result_t = bool;
+
+		static void
+		store( result_t & to, mhood_t< Msg > & ) noexcept
+			{
+				to = true;
+			}
+	};
+
+//
+// mbox_source_t
+//
+/*!
+ * \brief A source of a message for the awaiter: a message box.
+ *
+ * The message is received via a deadletter handler, so the agent can
+ * have ordinary subscriptions to other messages from the same mbox.
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg >
+class mbox_source_t
+	{
+		mbox_t m_from;
+
+	public :
+		using traits_t = result_traits_t< Msg >;
+
+		explicit mbox_source_t( mbox_t from )
+			:	m_from{ std::move(from) }
+			{}
+
+		[[nodiscard]]
+		bool
+		try_receive( typename traits_t::result_t & ) const noexcept
+			{
+				// Messages sent before the start of the wait aren't stored.
+				return false;
+			}
+
+		template< typename State >
+		void
+		subscribe( agent_t & agent, const std::shared_ptr< State > & state )
+			{
+				agent.so_subscribe_deadletter_handler( m_from,
+					[state]( mhood_t< Msg > cmd ) {
+						// The handler will be destroyed inside complete().
+						auto s = state;
+						traits_t::store( s->result(), cmd );
+						s->complete();
+					} );
+			}
+
+		void
+		unsubscribe( agent_t & agent )
+			{
+				agent.so_drop_deadletter_handler< Msg >( m_from );
+			}
+	};
+
+//
+// mchain_source_t
+//
+/*!
+ * \brief A source of a message for the awaiter: a notifying mchain.
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg >
+class mchain_source_t
+	{
+		mchain_t m_chain;
+		mbox_t m_notification_mbox;
+
+	public :
+		using traits_t = result_traits_t< Msg >;
+
+		mchain_source_t( mchain_t chain, mbox_t notification_mbox )
+			:	m_chain{ std::move(chain) }
+			,	m_notification_mbox{ std::move(notification_mbox) }
+			{}
+
+		[[nodiscard]]
+		bool
+		try_receive( typename traits_t::result_t & to ) const
+			{
+				bool received = false;
+				so_5::receive(
+						so_5::from( m_chain ).handle_n( 1 ).no_wait_on_empty(),
+						[&]( mhood_t< Msg > cmd ) {
+							traits_t::store( to, cmd );
+							received = true;
+						} );
+
+				return received;
+			}
+
+		template< typename State >
+		void
+		subscribe( agent_t & agent, const std::shared_ptr< State > & state )
+			{
+				agent.so_subscribe_deadletter_handler( m_notification_mbox,
+					[state]( mhood_t< msg_mchain_not_empty > ) {
+						auto s = state;
+						if( s->source().try_receive( s->result() ) )
+							s->complete();
+					} );
+			}
+
+		void
+		unsubscribe( agent_t & agent )
+			{
+				agent.so_drop_deadletter_handler< msg_mchain_not_empty >(
+						m_notification_mbox );
+			}
+	};
+
+//
+// wait_state_t
+//
+/*!
+ * \brief The state of a suspended receive operation.
+ *
+ * It's shared between deadletter handlers. If the handlers are destroyed
+ * without the completion of the wait (the agent is deregistered) then
+ * the whole suspended coroutine chain is destroyed.
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg, typename Source >
+class wait_state_t
+	{
+	public :
+		using result_t = typename result_traits_t< Msg >::result_t;
+
+		wait_state_t(
+			agent_t & agent,
+			Source & source,
+			result_t & result,
+			std::coroutine_handle<> awaiting,
+			std::coroutine_handle<> root )
+			:	m_agent{ agent }
+			,	m_source{ source }
+			,	m_result{ result }
+			,	m_awaiting{ awaiting }
+			,	m_root{ root }
+			{}
+
+		wait_state_t( const wait_state_t & ) = delete;
+		wait_state_t & operator=( const wait_state_t & ) = delete;
+
+		~wait_state_t()
+			{
+				if( !m_completed && m_root )
+					m_root.destroy();
+			}
+
+		[[nodiscard]]
+		Source &
+		source() const noexcept { return m_source; }
+
+		[[nodiscard]]
+		result_t &
+		result() const noexcept { return m_result; }
+
+		//! Subscribe to the source and to the timeout (if it's specified).
+		static void
+		start(
+			const std::shared_ptr< wait_state_t > & state,
+			std::optional< std::chrono::steady_clock::duration > timeout )
+			{
+				state->m_source.subscribe( state->m_agent, state );
+
+				if( timeout )
+					{
+						try
+							{
+								state->m_timeout_mbox =
+										state->m_agent.so_environment().create_mbox();
+								state->m_agent.so_subscribe_deadletter_handler(
+									state->m_timeout_mbox,
+									[state]( mhood_t< msg_receive_timeout > ) {
+										auto s = state;
+										s->complete();
+									} );
+
+								state->m_timer = so_5::send_periodic< msg_receive_timeout >(
+										state->m_timeout_mbox,
+										*timeout,
+										std::chrono::steady_clock::duration::zero() );
+							}
+						catch( ... )
+							{
+								state->cancel();
+								throw;
+							}
+					}
+			}
+
+		//! Finish the wait without resumption of the coroutine.
+		void
+		cancel()
+			{
+				m_completed = true;
+				m_timer.release();
+				m_source.unsubscribe( m_agent );
+				if( m_timeout_mbox )
+					m_agent.so_drop_deadletter_handler< msg_receive_timeout >(
+							m_timeout_mbox );
+			}
+
+		//! Finish the wait and resume the coroutine.
+		/*!
+		 * \attention
+		 * The caller has to hold a reference to the state because
+		 * the handlers that own the state are destroyed here.
+		 */
+		void
+		complete()
+			{
+				cancel();
+				resume_coroutine( m_awaiting );
+			}
+
+	private :
+		agent_t & m_agent;
+		Source & m_source;
+		result_t & m_result;
+
+		std::coroutine_handle<> m_awaiting;
+		std::coroutine_handle<> m_root;
+
+		mbox_t m_timeout_mbox;
+		timer_id_t m_timer;
+
+		bool m_completed{ false };
+	};
+
+//
+// receive_awaiter_t
+//
+/*!
+ * \brief Awaiter for receive_next().
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg, typename Source >
+class [[nodiscard]] receive_awaiter_t
+	{
+		using state_t = wait_state_t< Msg, Source >;
+
+	public :
+		using result_t = typename state_t::result_t;
+
+		receive_awaiter_t(
+			agent_t & agent,
+			Source source,
+			std::optional< std::chrono::steady_clock::duration > timeout )
+			:	m_agent{ agent }
+			,	m_source{ std::move(source) }
+			,	m_timeout{ timeout }
+			{}
+
+		[[nodiscard]]
+		bool
+		await_ready()
+			{
+				return m_source.try_receive( m_result );
+			}
+
+		template< typename Promise >
+		[[nodiscard]]
+		bool
+		await_suspend( std::coroutine_handle< Promise > awaiting )
+			{
+				auto state = std::make_shared< state_t >(
+						m_agent, m_source, m_result, awaiting, root_of( awaiting ) );
+				state_t::start( state, m_timeout );
+
+				// A message could be received between the check in await_ready()
+				// and the subscription.
+				if( m_source.try_receive( m_result ) )
+					{
+						state->cancel();
+						return false;
+					}
+
+				return true;
+			}
+
+		[[nodiscard]]
+		result_t
+		await_resume()
+			{
+				return std::move( m_result );
+			}
+
+	private :
+		agent_t & m_agent;
+		Source m_source;
+		std::optional< std::chrono::steady_clock::duration > m_timeout;
+
+		result_t m_result{};
+	};
+
+} /* namespace details */
+
+//
+// task_t
+//
+/*!
+ * \brief A coroutine that can be used inside an agent.
+ *
+ * The coroutine is lazy: it starts when it's awaited by another
+ * task_t or when it's passed to spawn().
+ *
+ * Usage example:
+ * \code
+ * class requester final : public so_5::agent_t
+ * {
+ * 	so_5::task<> dialog()
+ * 	{
+ * 		so_5::send< request >( m_server, ... );
+ * 		auto reply = co_await so_5::coro::receive_next< response >(
+ * 				*this, so_direct_mbox(), 5s );
+ * 		if( !reply )
+ * 			... // Timeout.
+ * 	}
+ *
+ * 	void so_evt_start() override
+ * 	{
+ * 		so_5::coro::spawn( dialog() );
+ * 	}
+ * };
+ * \endcode
+ *
+ * \since v.5.8.5
+ */
+template< typename T >
+class [[nodiscard]] task_t
+	{
+	public :
+		class promise_type
+			:	public details::promise_base_t
+			,	public details::promise_value_t< T >
+			{
+			public :
+				[[nodiscard]]
+				task_t
+				get_return_object() noexcept
+					{
+						return task_t{ handle_t::from_promise( *this ) };
+					}
+			};
+
+		using handle_t = std::coroutine_handle< promise_type >;
+
+		//! Awaiter for the result of the coroutine.
+		struct awaiter_t
+			{
+				handle_t m_handle;
+
+				[[nodiscard]]
+				bool
+				await_ready() const noexcept { return false; }
+
+				template< typename Promise >
+				[[nodiscard]]
+				std::coroutine_handle<>
+				await_suspend( std::coroutine_handle< Promise > awaiting ) noexcept
+					{
+						auto & p = m_handle.promise();
+						p.m_continuation = awaiting;
+						p.m_root = details::root_of( awaiting );
+						return m_handle;
+					}
+
+				T
+				await_resume()
+					{
+						auto & p = m_handle.promise();
+						if( p.m_exception )
+							std::rethrow_exception( p.m_exception );
+						return p.take_value();
+					}
+			};
+
+		task_t( const task_t & ) = delete;
+		task_t & operator=( const task_t & ) = delete;
+
+		task_t( task_t && other ) noexcept
+			:	m_handle{ std::exchange( other.m_handle, handle_t{} ) }
+			{}
+
+		task_t &
+		operator=( task_t && other ) noexcept
+			{
+				task_t tmp{ std::move(other) };
+				std::swap( m_handle, tmp.m_handle );
+				return *this;
+			}
+
+		~task_t()
+			{
+				if( m_handle )
+					m_handle.destroy();
+			}
+
+		//! Release the ownership of the coroutine frame.
+		[[nodiscard]]
+		handle_t
+		release() noexcept
+			{
+				return std::exchange( m_handle, handle_t{} );
+			}
+
+		//! Start the coroutine and wait for its result.
+		[[nodiscard]]
+		awaiter_t
+		operator co_await() && noexcept
+			{
+				return awaiter_t{ m_handle };
+			}
+
+	private :
+		handle_t m_handle;
+
+		explicit task_t( handle_t handle ) noexcept
+			:	m_handle{ handle }
+			{}
+	};
+
+//
+// spawn
+//
+/*!
+ * \brief Start a detached coroutine.
+ *
+ * The coroutine runs on the current thread until its first suspension.
+ * The coroutine is resumed on the working thread of the agent when an
+ * awaited message arrives.
+ *
+ * An exception from the coroutine goes to the event handler that
+ * resumed the coroutine (or to the caller of spawn()). It means that
+ * the agent's exception reaction is applied.
+ *
+ * If the agent is deregistered while the coroutine is suspended then
+ * the coroutine is destroyed.
+ *
+ * \attention
+ * spawn() has to be called on the agent's working thread (for example,
+ * from an event handler or from so_evt_start()).
+ *
+ * \since v.5.8.5
+ */
+inline void
+spawn( task_t<> task )
+	{
+		auto h = task.release();
+		h.promise().m_detached = true;
+		h.promise().m_root = h;
+
+		details::resume_coroutine( h );
+	}
+
+//
+// receive_next
+//
+/*!
+ * \brief Wait for the next message of type \a Msg from \a from.
+ *
+ * The result of `co_await` is std::optional<so_5::message_holder_t<Msg>>
+ * for a message and bool for a signal. An empty value (or false) means
+ * the timeout.
+ *
+ * \note
+ * The message is received via a deadletter handler of \a agent. So
+ * only one wait for a message of type \a Msg from \a from can be active
+ * at a time. If the agent has an ordinary subscription for \a Msg from
+ * \a from in the current state then the message goes to that
+ * subscription. Only messages sent after the start of the wait are
+ * received.
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg >
+[[nodiscard]]
+auto
+receive_next(
+	//! The agent that waits for the message.
+	agent_t & agent,
+	//! The source of the message.
+	mbox_t from,
+	//! Max time for waiting.
+	std::chrono::steady_clock::duration timeout )
+	{
+		return details::receive_awaiter_t< Msg, details::mbox_source_t< Msg > >{
+				agent,
+				details::mbox_source_t< Msg >{ std::move(from) },
+				timeout };
+	}
+
+/*!
+ * \brief Wait for the next message of type \a Msg from \a from
+ * without a timeout.
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg >
+[[nodiscard]]
+auto
+receive_next(
+	agent_t & agent,
+	mbox_t from )
+	{
+		return details::receive_awaiter_t< Msg, details::mbox_source_t< Msg > >{
+				agent,
+				details::mbox_source_t< Msg >{ std::move(from) },
+				std::nullopt };
+	}
+
+//
+// notifying_mchain_t
+//
+/*!
+ * \brief An mchain that notifies an agent about new messages.
+ *
+ * Only such an mchain can be used with receive_next() because an
+ * ordinary mchain has no way to wake up an agent.
+ *
+ * \since v.5.8.5
+ */
+class notifying_mchain_t
+	{
+		mchain_t m_chain;
+		mbox_t m_notification_mbox;
+
+	public :
+		notifying_mchain_t( mchain_t chain, mbox_t notification_mbox )
+			:	m_chain{ std::move(chain) }
+			,	m_notification_mbox{ std::move(notification_mbox) }
+			{}
+
+		//! The mchain itself.
+		[[nodiscard]]
+		const mchain_t &
+		chain() const noexcept { return m_chain; }
+
+		//! The mbox for notifications about new messages.
+		[[nodiscard]]
+		const mbox_t &
+		notification_mbox() const noexcept { return m_notification_mbox; }
+	};
+
+/*!
+ * \brief Create a notifying mchain.
+ *
+ * The not_empty_notificator of \a params is replaced.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+inline notifying_mchain_t
+make_notifying_mchain(
+	environment_t & env,
+	mchain_params_t params )
+	{
+		auto mbox = env.create_mbox();
+		params.not_empty_notificator( [mbox] {
+				so_5::send< details::msg_mchain_not_empty >( mbox );
+			} );
+
+		return { env.create_mchain( params ), std::move(mbox) };
+	}
+
+/*!
+ * \brief Wait for the next message of type \a Msg from a notifying mchain.
+ *
+ * The result of `co_await` is the same as for receive_next() for an mbox.
+ *
+ * \note
+ * Messages of other types extracted from the mchain are ignored (like
+ * for so_5::receive() without handlers for them).
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg >
+[[nodiscard]]
+auto
+receive_next(
+	//! The agent that waits for the message.
+	agent_t & agent,
+	//! The source of the message.
+	const notifying_mchain_t & from,
+	//! Max time for waiting.
+	std::chrono::steady_clock::duration timeout )
+	{
+		return details::receive_awaiter_t< Msg, details::mchain_source_t< Msg > >{
+				agent,
+				details::mchain_source_t< Msg >{
+						from.chain(), from.notification_mbox() },
+				timeout };
+	}
+
+/*!
+ * \brief Wait for the next message of type \a Msg from a notifying
+ * mchain without a timeout.
+ *
+ * \since v.5.8.5
+ */
+template< typename Msg >
+[[nodiscard]]
+auto
+receive_next(
+	agent_t & agent,
+	const notifying_mchain_t & from )
+	{
+		return details::receive_awaiter_t< Msg, details::mchain_source_t< Msg > >{
+				agent,
+				details::mchain_source_t< Msg >{
+						from.chain(), from.notification_mbox() },
+				std::nullopt };
+	}
+
+} /* namespace coro */
+
+/*!
+ * \brief A short name for so_5::coro::task_t.
+ *
+ * \since v.5.8.5
+ */
+template< typename T = void >
+using task = coro::task_t< T >;
+
+} /* namespace so_5 */
+
+#endif /* SO_5_HAVE_COROUTINES */
@@ -0,0 +1,356 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A lightweight replacement for std::function with a small buffer.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace so_5 {
+
+namespace details {
+
+//
+// small_function_t
+//
+template< typename Signature, std::size_t Buffer_Size >
+class small_function_t;
+
+/*!
+ * \brief A lightweight replacement for std::function.
+ *
+ * A callable object is stored in the internal buffer of size
+ * \a Buffer_Size if it fits into that buffer and has noexcept
+ * move constructor. Otherwise the callable object is allocated
+ * dynamically.
+ *
+ * There are several differences from std::function:
+ *
+ * - there is no RTTI-related stuff like target() and target_type();
+ * - the internal buffer is big enough to hold lambdas created for event
+ *   handlers by SObjectizer (for example, a lambda with a pointer to an
+ *   agent and a pointer to agent's method). So subscription to an event
+ *   doesn't require a memory allocation;
+ * - copy and move of trivially copyable callables are performed by
+ *   std::memcpy without indirect calls.
+ *
+ * The callable is invoked via const operator() even if the callable
+ * itself isn't const-invocable (it's the same behavior as for
+ * std::function).
+ *
+ * If an empty object is invoked then std::bad_function_call is thrown.
+ *
+ * \since v.5.8.5
+ */
+template< typename R, typename... Args, std::size_t Buffer_Size >
+class small_function_t< R(Args...), Buffer_Size >
+	{
+		//! Type of storage for a callable object.
+		struct alignas(void*) storage_t
+			{
+				unsigned char m_data[ Buffer_Size ];
+			};
+
+		//! Operations for the actual type of a callable object.
+		struct operations_t
+			{
+				//! Invocation of the callable object.
+				R (*m_invoke)( storage_t &, Args... );
+
+				//! Copy of the callable object to an uninitialized storage.
+				void (*m_copy)( const storage_t & /*from*/, storage_t & /*to*/ );
+
+				//! Move of the callable object to an uninitialized storage.
+				/*!
+				 * The source storage is destroyed after the move.
+				 */
+				void (*m_relocate)( storage_t & /*from*/, storage_t & /*to*/ ) noexcept;
+
+				//! Destruction of the callable object.
+				void (*m_destroy)( storage_t & ) noexcept;
+
+				//! Can the storage be copied by std::memcpy?
+				/*!
+				 * If it's true then m_copy, m_relocate and m_destroy aren't used.
+				 */
+				bool m_trivial;
+			};
+
+		//! Does a type F can be stored in the internal buffer?
+		template< typename F >
+		static constexpr bool fits_into_buffer =
+				sizeof(F) <= sizeof(storage_t) &&
+				alignof(storage_t) % alignof(F) == 0u &&
+				std::is_nothrow_move_constructible_v< F >;
+
+		//! Operations for the case when the callable is in the buffer.
+		template< typename F >
+		struct inplace_operations_t
+			{
+				static F &
+				get( storage_t & s ) noexcept
+					{
+						return *std::launder( reinterpret_cast< F * >( s.m_data ) );
+					}
+
+				static const F &
+				get( const storage_t & s ) noexcept
+					{
+						return *std::launder( reinterpret_cast< const F * >( s.m_data ) );
+					}
+
+				static R
+				invoke( storage_t & s, Args... args )
+					{
+						return std::invoke( get( s ), std::forward< Args >( args )... );
+					}
+
+				static void
+				copy( const storage_t & from, storage_t & to )
+					{
+						::new( static_cast< void * >( to.m_data ) ) F{ get( from ) };
+					}
+
+				static void
+				relocate( storage_t & from, storage_t & to ) noexcept
+					{
+						::new( static_cast< void * >( to.m_data ) ) F{
+								std::move( get( from ) ) };
+						destroy( from );
+					}
+
+				static void
+				destroy( storage_t & s ) noexcept
+					{
+						get( s ).~F();
+					}
+
+				static constexpr operations_t ops{
+						&invoke, &copy, &relocate, &destroy,
+						std::is_trivially_copyable_v< F > &&
+								std::is_trivially_destructible_v< F >
+					};
+			};
+
+		//! Operations for the case when the callable is allocated dynamically.
+		/*!
+		 * The buffer holds a pointer to the callable object.
+		 */
+		template< typename F >
+		struct dynamic_operations_t
+			{
+				static F *&
+				get( storage_t & s ) noexcept
+					{
+						return *std::launder( reinterpret_cast< F ** >( s.m_data ) );
+					}
+
+				static F *
+				get( const storage_t & s ) noexcept
+					{
+						return *std::launder( reinterpret_cast< F * const * >( s.m_data ) );
+					}
+
+				static R
+				invoke( storage_t & s, Args... args )
+					{
+						return std::invoke( *get( s ), std::forward< Args >( args )... );
+					}
+
+				static void
+				copy( const storage_t & from, storage_t & to )
+					{
+						::new( static_cast< void * >( to.m_data ) ) F*{
+								new F{ *get( from ) } };
+					}
+
+				static void
+				relocate( storage_t & from, storage_t & to ) noexcept
+					{
+						::new( static_cast< void * >( to.m_data ) ) F*{ get( from ) };
+					}
+
+				static void
+				destroy( storage_t & s ) noexcept
+					{
+						delete get( s );
+					}
+
+				static constexpr operations_t ops{
+						&invoke, &copy, &relocate, &destroy, false
+					};
+			};
+
+		//! Operations for an empty object.
+		struct empty_operations_t
+			{
+				[[noreturn]] static R
+				invoke( storage_t &, Args... )
+					{
+						throw std::bad_function_call{};
+					}
+
+				static constexpr operations_t ops{
+						&invoke, nullptr, nullptr, nullptr, true
+					};
+			};
+
+		//! Operations for the current callable object.
+		const operations_t * m_ops{ &empty_operations_t::ops };
+
+		//! Storage for the callable object.
+		/*!
+		 * It's mutable because operator() is const but the callable
+		 * object can be non-const invocable.
+		 *
+		 * It's value-initialized because the whole storage is copied by
+		 * std::memcpy for trivial callables even if a callable is smaller
+		 * than the storage.
+		 */
+		mutable storage_t m_storage{};
+
+		void
+		copy_from( const small_function_t & o )
+			{
+				if( o.m_ops->m_trivial )
+					std::memcpy( &m_storage, &o.m_storage, sizeof(m_storage) );
+				else
+					o.m_ops->m_copy( o.m_storage, m_storage );
+				m_ops = o.m_ops;
+			}
+
+		void
+		move_from( small_function_t & o ) noexcept
+			{
+				if( o.m_ops->m_trivial )
+					std::memcpy( &m_storage, &o.m_storage, sizeof(m_storage) );
+				else
+					o.m_ops->m_relocate( o.m_storage, m_storage );
+				m_ops = std::exchange( o.m_ops, &empty_operations_t::ops );
+			}
+
+		void
+		reset() noexcept
+			{
+				if( !m_ops->m_trivial )
+					m_ops->m_destroy( m_storage );
+				m_ops = &empty_operations_t::ops;
+			}
+
+	public:
+		small_function_t() noexcept = default;
+
+		small_function_t( std::nullptr_t ) noexcept {}
+
+		template<
+			typename F,
+			typename = std::enable_if_t<
+				!std::is_same_v< std::decay_t< F >, small_function_t > &&
+				std::is_invocable_r_v< R, std::decay_t< F > &, Args... > > >
+		small_function_t( F && f )
+			{
+				using actual_type_t = std::decay_t< F >;
+
+				if constexpr( fits_into_buffer< actual_type_t > )
+					{
+						::new( static_cast< void * >( m_storage.m_data ) )
+								actual_type_t{ std::forward< F >( f ) };
+						m_ops = &inplace_operations_t< actual_type_t >::ops;
+					}
+				else
+					{
+						::new( static_cast< void * >( m_storage.m_data ) )
+								actual_type_t*{ new actual_type_t{ std::forward< F >( f ) } };
+						m_ops = &dynamic_operations_t< actual_type_t >::ops;
+					}
+			}
+
+		small_function_t( const small_function_t & o )
+			{
+				copy_from( o );
+			}
+
+		small_function_t( small_function_t && o ) noexcept
+			{
+				move_from( o );
+			}
+
+		~small_function_t() noexcept
+			{
+				reset();
+			}
+
+		small_function_t &
+		operator=( const small_function_t & o )
+			{
+				if( this != &o )
+					{
+						small_function_t tmp{ o };
+						reset();
+						move_from( tmp );
+					}
+				return *this;
+			}
+
+		small_function_t &
+		operator=( small_function_t && o ) noexcept
+			{
+				if( this != &o )
+					{
+						reset();
+						move_from( o );
+					}
+				return *this;
+			}
+
+		small_function_t &
+		operator=( std::nullptr_t ) noexcept
+			{
+				reset();
+				return *this;
+			}
+
+		friend void
+		swap( small_function_t & a, small_function_t & b ) noexcept
+			{
+				small_function_t tmp{ std::move(a) };
+				a = std::move(b);
+				b = std::move(tmp);
+			}
+
+		//! Is there a callable object?
+		[[nodiscard]]
+		explicit operator bool() const noexcept
+			{
+				// NOTE: the address of empty_operations_t::ops isn't used
+				// here because that object can be duplicated in different
+				// modules (like DLL and EXE on Windows).
+				return nullptr != m_ops->m_copy;
+			}
+
+		//! Invocation of the callable object.
+		/*!
+		 * \throw std::bad_function_call if the object is empty.
+		 */
+		R
+		operator()( Args... args ) const
+			{
+				return m_ops->m_invoke( m_storage, std::forward< Args >( args )... );
+			}
+	};
+
+} /* namespace details */
+
+} /* namespace so_5 */
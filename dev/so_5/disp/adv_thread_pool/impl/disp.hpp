@@ -25,7 +25,10 @@
 
 #include <so_5/impl/thread_join_stuff.hpp>
 
+#include <algorithm>
 #include <forward_list>
+#include <utility>
+#include <vector>
 
 #if 0
 	#define SO_5_CHECK_INVARIANT_IMPL(what, data, file, line) \
@@ -98,6 +101,46 @@ class agent_queue_t final
 			};
 
 	public :
+		/*!
+		 * \brief A list of demands extracted from the queue by a worker.
+		 *
+		 * Demands are deleted when the list is destroyed, so execution
+		 * hints created for them remain valid until the end of processing
+		 * of the whole list.
+		 *
+		 * \since v.5.8.5
+		 */
+		class demands_batch_t
+			{
+				friend class agent_queue_t;
+
+				//! The first demand in the list.
+				demand_t * m_head{ nullptr };
+
+				explicit demands_batch_t( demand_t * head ) noexcept
+					:	m_head{ head }
+					{}
+
+			public :
+				demands_batch_t( demands_batch_t && other ) noexcept
+					:	m_head{ std::exchange( other.m_head, nullptr ) }
+					{}
+
+				demands_batch_t( const demands_batch_t & ) = delete;
+				demands_batch_t &
+				operator=( const demands_batch_t & ) = delete;
+
+				~demands_batch_t()
+					{
+						while( m_head )
+							{
+								auto to_be_deleted = m_head;
+								m_head = m_head->m_next;
+								delete to_be_deleted;
+							}
+					}
+			};
+
 		static constexpr const unsigned int thread_safe_worker = 2;
 		static constexpr const unsigned int not_thread_safe_worker = 1;
 
@@ -105,11 +148,11 @@ class agent_queue_t final
 		agent_queue_t(
 			//! Dispatcher queue to work with.
 			outliving_reference_t< dispatcher_queue_t > disp_queue,
-			//! Dummy argument. It is necessary here because of
-			//! common implementation for thread-pool and
-			//! adv-thread-pool dispatchers.
-			const bind_params_t & )
+			//! Parameters for the queue.
+			const bind_params_t & params )
 			:	m_disp_queue( disp_queue.get() )
+			,	m_max_demands_at_once(
+					std::max< std::size_t >( 1u, params.query_max_demands_at_once() ) )
 			,	m_tail_demand( &m_head_demand )
 			,	m_active( false )
 			,	m_workers( 0 )
@@ -189,23 +232,87 @@ class agent_queue_t final
 				this->push( std::move(demand) );
 			}
 
-		//! Get the information about the front demand.
+		//! Mark the queue as extracted from the dispatcher queue.
 		/*!
 		 * \attention This method must be called only on non-empty queue.
+		 *
+		 * \since v.5.8.5
 		 */
-		[[nodiscard]]
-		execution_demand_t
-		peek_front()
+		void
+		deactivate() noexcept
 			{
 				SO_5_CHECK_INVARIANT( !empty(), this )
 				SO_5_CHECK_INVARIANT( m_active, this )
 
 				m_active = false;
+			}
+
+		//! Create execution hints for demands at the head of the queue.
+		/*!
+		 * A hint for the front demand is always created. If that demand
+		 * has a thread safe event handler then hints for the subsequent
+		 * demands with thread safe handlers are created too (but no more
+		 * than max_demands_at_once in total). The collection stops at the
+		 * first demand with not thread safe event handler, so such a demand
+		 * is always processed alone.
+		 *
+		 * Hints refer to demands in the queue. Those demands have to be
+		 * extracted by take_front() before unlocking the queue.
+		 *
+		 * \attention This method must be called only on non-empty queue.
+		 *
+		 * \since v.5.8.5
+		 */
+		void
+		collect_hints( std::vector< execution_hint_t > & hints )
+			{
+				SO_5_CHECK_INVARIANT( !empty(), this )
+
+				for( auto * d = m_head_demand.m_next;
+						d && hints.size() != m_max_demands_at_once;
+						d = d->m_next )
+					{
+						auto hint = d->m_demand.m_receiver->so_create_execution_hint(
+								d->m_demand );
+						if( !hint.is_thread_safe() && !hints.empty() )
+							break;
+
+						const bool thread_safe = hint.is_thread_safe();
+						hints.push_back( std::move(hint) );
+						if( !thread_safe )
+							break;
+					}
+			}
+
+		//! Extract several demands from the head of the queue.
+		/*!
+		 * \attention The queue must contain at least \a count demands.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		demands_batch_t
+		take_front( std::size_t count ) noexcept
+			{
+				SO_5_CHECK_INVARIANT( 0u != count, this )
+
+				demands_batch_t batch{ m_head_demand.m_next };
 
-				return m_head_demand.m_next->m_demand;
+				auto * last = m_head_demand.m_next;
+				for( std::size_t i = 1u; i != count; ++i )
+					last = last->m_next;
+
+				m_head_demand.m_next = last->m_next;
+				last->m_next = nullptr;
+				if( !m_head_demand.m_next )
+					m_tail_demand = &m_head_demand;
+
+				m_size -= count;
+
+				return batch;
 			}
 
-		//! Remove the front demand.
+		//! Register a new worker for the queue.
 		/*!
 		 * \retval true queue must be activated.
 		 * \retval false queue must not be activated.
@@ -217,13 +324,8 @@ class agent_queue_t final
 			//! Must be thread_safe_worker or not_thread_safe_worker.
 			unsigned int type_of_worker )
 			{
-				SO_5_CHECK_INVARIANT( !empty(), this );
 				SO_5_CHECK_INVARIANT( !m_active, this );
 
-				delete_head();
-				if( !m_head_demand.m_next )
-					m_tail_demand = &m_head_demand;
-
 				m_workers += type_of_worker;
 
 				// Queue must be activated only if queue is not empty
@@ -336,6 +438,14 @@ class agent_queue_t final
 		//! this queue.
 		dispatcher_queue_t & m_disp_queue;
 
+		/*!
+		 * \brief Maximum count of thread safe demands to be taken
+		 * by a worker at once.
+		 *
+		 * \since v.5.8.5
+		 */
+		const std::size_t m_max_demands_at_once;
+
 		//! Object's lock.
 		spinlock_t m_lock;
 
@@ -590,6 +700,19 @@ class work_thread_template_t final : public Impl
 				return this->m_thread_id;
 			}
 
+		/*!
+		 * \brief Get the condition object used for waiting in the
+		 * dispatcher queue.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		const so_5::disp::mpmc_queue_traits::condition_t *
+		condition() const noexcept
+			{
+				return this->m_condition.get();
+			}
+
 	private :
 		//! Thread body method.
 		void
@@ -637,56 +760,66 @@ class work_thread_template_t final : public Impl
 			{
 				std::unique_lock< spinlock_t > lock( queue.lock() );
 
-				auto demand = queue.peek_front();
+				queue.deactivate();
 				if( queue.is_there_not_thread_safe_worker() )
 					// We can't process any demand until thread unsafe
 					// worker is working.
 					return;
 
-				auto hint = demand.m_receiver->so_create_execution_hint( demand );
+				queue.collect_hints( m_hints );
+				const unsigned int type_of_worker =
+						m_hints.front().is_thread_safe() ?
+								agent_queue_t::thread_safe_worker :
+								agent_queue_t::not_thread_safe_worker;
 
-				bool need_schedule = true;
-				if( !hint.is_thread_safe() )
-				{
-					if( queue.is_there_any_worker() )
+				if( agent_queue_t::not_thread_safe_worker == type_of_worker &&
+						queue.is_there_any_worker() )
+					{
 						// We can't process not thread safe demand until
 						// there are some other workers.
+						m_hints.clear();
 						return;
-					else
-						need_schedule = queue.worker_started(
-								agent_queue_t::not_thread_safe_worker );
-				}
-				else
-					// Threa-safe worker can be started.
-					need_schedule = queue.worker_started(
-							agent_queue_t::thread_safe_worker );
-
-				SO_5_CHECK_INVARIANT( !(need_schedule && queue.empty()), &queue )
-				SO_5_CHECK_INVARIANT(
-						!need_schedule || hint.is_thread_safe(), &queue );
-				SO_5_CHECK_INVARIANT( !need_schedule || queue.active(), &queue );
-
-				// Next few actions must be done on unlocked queue.
-				lock.unlock();
+					}
 
-				if( need_schedule )
-					this->m_disp_queue->schedule( &queue );
+				bool need_schedule = false;
+				{
+					// All thread safe demands collected are taken at once.
+					// Other workers can take the rest of the queue in parallel.
+					// Taken demands will be destroyed outside of the lock.
+					const auto batch = queue.take_front( m_hints.size() );
+					need_schedule = queue.worker_started( type_of_worker );
+
+					SO_5_CHECK_INVARIANT( !(need_schedule && queue.empty()), &queue )
+					SO_5_CHECK_INVARIANT(
+							!need_schedule ||
+							agent_queue_t::thread_safe_worker == type_of_worker,
+							&queue );
+					SO_5_CHECK_INVARIANT( !need_schedule || queue.active(), &queue );
+
+					// Next few actions must be done on unlocked queue.
+					lock.unlock();
+
+					if( need_schedule )
+						this->m_disp_queue->schedule( &queue );
+
+					for( const auto & hint : m_hints )
+						{
+							// For activity tracking if it is turned on.
+							this->work_started();
 
-				// For activity tracking if it is turned on.
-				this->work_started();
+							// Processing of event.
+							hint.exec( this->m_thread_id );
 
-				// Processing of event.
-				hint.exec( this->m_thread_id );
+							this->work_finished();
+						}
 
-				this->work_finished();
+					m_hints.clear();
+				}
 
 				// Next actions must be done on locked queue.
 				lock.lock();
 
-				need_schedule = queue.worker_finished(
-						hint.is_thread_safe() ?
-								agent_queue_t::thread_safe_worker :
-								agent_queue_t::not_thread_safe_worker );
+				need_schedule = queue.worker_finished( type_of_worker );
 
 				SO_5_CHECK_INVARIANT(
 						!need_schedule || queue.active(), &queue );
@@ -696,6 +829,16 @@ class work_thread_template_t final : public Impl
 				if( need_schedule )
 					this->m_disp_queue->schedule( &queue );
 			}
+
+		/*!
+		 * \brief Execution hints for demands taken from an agent queue.
+		 *
+		 * The vector is reused to avoid memory allocations on every
+		 * call to process_queue().
+		 *
+		 * \since v.5.8.5
+		 */
+		std::vector< execution_hint_t > m_hints;
 	};
 
 } /* namespace work_thread_details */
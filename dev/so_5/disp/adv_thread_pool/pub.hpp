@@ -204,9 +204,55 @@ class bind_params_t
 				return m_fifo;
 			}
 
+		/*!
+		 * \brief Set maximum count of thread safe demands to be taken
+		 * by a work thread at once.
+		 *
+		 * A work thread takes consecutive demands with thread safe event
+		 * handlers from the head of an event queue by one lock of the queue
+		 * and then processes them without any further synchronization with
+		 * other work threads. Demands with not thread safe event handlers
+		 * are always taken one by one.
+		 *
+		 * Values greater than 1 reduce contention on the event queue if
+		 * several work threads process many cheap thread safe events of
+		 * the same agent. But demands taken by one work thread are
+		 * processed sequentially, so big values can reduce the parallelism.
+		 *
+		 * Value 0 is treated as 1.
+		 *
+		 * \since v.5.8.5
+		 */
+		bind_params_t &
+		max_demands_at_once( std::size_t v )
+			{
+				m_max_demands_at_once = v;
+				return *this;
+			}
+
+		/*!
+		 * \brief Get maximum count of thread safe demands to be taken
+		 * by a work thread at once.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::size_t
+		query_max_demands_at_once() const
+			{
+				return m_max_demands_at_once;
+			}
+
 	private :
 		//! FIFO type.
 		fifo_t m_fifo = { fifo_t::cooperation };
+
+		/*!
+		 * \brief Maximum count of thread safe demands to be taken
+		 * at once.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::size_t m_max_demands_at_once = { 1 };
 	};
 
 //
@@ -0,0 +1,534 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A factory for work threads pinned to CPU cores or NUMA nodes.
+ *
+ * \since v.5.8.5
+ */
+
+#include <so_5/disp/affinity_work_thread.hpp>
+
+#include <so_5/details/suppress_exceptions.hpp>
+
+#include <so_5/exception.hpp>
+#include <so_5/ret_code.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+	#include <dirent.h>
+#endif
+
+namespace so_5::disp::affinity
+{
+
+namespace impl
+{
+
+namespace
+{
+
+void
+throw_invalid_cpu_list( std::string_view cpu_list, const char * reason )
+	{
+		SO_5_THROW_EXCEPTION(
+				rc_invalid_cpu_list,
+				std::string{ "invalid CPU list '" } + std::string{ cpu_list } +
+				"': " + reason );
+	}
+
+[[nodiscard]] std::string_view
+trim( std::string_view v ) noexcept
+	{
+		constexpr std::string_view spaces{ " \t\r\n" };
+
+		const auto first = v.find_first_not_of( spaces );
+		if( std::string_view::npos == first )
+			return std::string_view{};
+
+		const auto last = v.find_last_not_of( spaces );
+		return v.substr( first, last - first + 1u );
+	}
+
+[[nodiscard]] unsigned int
+parse_cpu_index( std::string_view whole_list, std::string_view v )
+	{
+		v = trim( v );
+		if( v.empty() )
+			throw_invalid_cpu_list( whole_list, "empty CPU index" );
+
+		unsigned int result{};
+		const auto r = std::from_chars( v.data(), v.data() + v.size(), result );
+		if( std::errc{} != r.ec || r.ptr != v.data() + v.size() )
+			throw_invalid_cpu_list( whole_list, "CPU index is not a number" );
+		if( result >= max_cpu_count )
+			throw_invalid_cpu_list( whole_list, "CPU index is too big" );
+
+		return result;
+	}
+
+#if defined(__linux__)
+
+//! Read the whole content of a file.
+/*!
+ * Returns false if the file can't be read.
+ */
+[[nodiscard]] bool
+read_file( const std::string & file_name, std::string & content )
+	{
+		std::ifstream file{ file_name };
+		if( !file )
+			return false;
+
+		std::ostringstream ss;
+		ss << file.rdbuf();
+		content = ss.str();
+
+		return true;
+	}
+
+//! Read a numeric ID from a file.
+/*!
+ * Returns 0 if the file can't be read or if the value is negative
+ * (for example, physical_package_id is -1 on some platforms).
+ */
+[[nodiscard]] unsigned int
+read_id( const std::string & file_name )
+	{
+		std::string content;
+		if( !read_file( file_name, content ) )
+			return 0u;
+
+		const auto v = trim( content );
+		int result{};
+		const auto r = std::from_chars( v.data(), v.data() + v.size(), result );
+		if( std::errc{} != r.ec || result < 0 )
+			return 0u;
+
+		return static_cast< unsigned int >( result );
+	}
+
+//! Read mapping of CPUs to NUMA nodes.
+void
+read_numa_nodes( const std::string & sysfs_root, cpu_topology_t & topology )
+	{
+		const std::string nodes_dir = sysfs_root + "/devices/system/node";
+
+		DIR * dir = ::opendir( nodes_dir.c_str() );
+		if( !dir )
+			// There is no NUMA support, all CPUs belong to the node 0.
+			return;
+
+		std::map< unsigned int, unsigned int > cpu_to_node;
+		while( const ::dirent * entry = ::readdir( dir ) )
+			{
+				const std::string_view name{ entry->d_name };
+				if( name.size() <= 4u || name.substr( 0u, 4u ) != "node" )
+					continue;
+
+				unsigned int node{};
+				const auto digits = name.substr( 4u );
+				const auto r = std::from_chars(
+						digits.data(), digits.data() + digits.size(), node );
+				if( std::errc{} != r.ec || r.ptr != digits.data() + digits.size() )
+					continue;
+
+				std::string content;
+				if( !read_file(
+						nodes_dir + "/" + std::string{ name } + "/cpulist",
+						content ) )
+					continue;
+
+				// A broken cpulist is ignored, it isn't the user's fault.
+				so_5::details::suppress_exceptions( [&] {
+						for( const auto cpu : parse_cpu_list( content ) )
+							cpu_to_node[ cpu ] = node;
+					} );
+			}
+		::closedir( dir );
+
+		for( auto & info : topology )
+			{
+				const auto it = cpu_to_node.find( info.m_cpu );
+				if( it != cpu_to_node.end() )
+					info.m_numa_node = it->second;
+			}
+	}
+
+//! Set affinity for the current thread.
+/*!
+ * Errors are ignored: the thread works without affinity in that case.
+ */
+void
+pin_current_thread( const std::vector< unsigned int > & cpus ) noexcept
+	{
+		if( cpus.empty() )
+			return;
+
+		const auto max_cpu = *std::max_element( cpus.begin(), cpus.end() );
+		const auto cpu_count = static_cast< int >( max_cpu ) + 1;
+
+		cpu_set_t * set = CPU_ALLOC( cpu_count );
+		if( !set )
+			return;
+
+		const auto set_size = CPU_ALLOC_SIZE( cpu_count );
+		CPU_ZERO_S( set_size, set );
+		for( const auto cpu : cpus )
+			CPU_SET_S( cpu, set_size, set );
+
+		(void)::pthread_setaffinity_np( ::pthread_self(), set_size, set );
+
+		CPU_FREE( set );
+	}
+
+//
+// affinity_work_thread_t
+//
+/*!
+ * \brief An implementation of work thread that sets its CPU affinity
+ * before the execution of the thread body.
+ *
+ * \since v.5.8.5
+ */
+class affinity_work_thread_t final : public abstract_work_thread_t
+	{
+		//! Actual thread.
+		std::thread m_thread;
+
+		//! CPUs the thread has to be pinned to.
+		const std::vector< unsigned int > m_cpus;
+
+	public:
+		explicit affinity_work_thread_t( std::vector< unsigned int > cpus )
+			:	m_cpus{ std::move(cpus) }
+			{}
+
+		void
+		start( body_func_t thread_body ) override
+			{
+				m_thread = std::thread{
+						[this, tb = std::move(thread_body)] {
+							pin_current_thread( m_cpus );
+
+							// All exceptions have to be intercepted and suppressed.
+							so_5::details::suppress_exceptions( [&tb]() { tb(); } );
+						}
+					};
+			}
+
+		void
+		join() override
+			{
+				m_thread.join();
+			}
+	};
+
+//
+// affinity_work_thread_factory_t
+//
+/*!
+ * \brief An implementation of work thread factory that assigns CPUs
+ * to new threads in the round-robin manner.
+ *
+ * \since v.5.8.5
+ */
+class affinity_work_thread_factory_t final
+	:	public abstract_work_thread_factory_t
+	{
+		//! Should a thread be pinned to the whole NUMA node?
+		const bool m_numa_node_granularity;
+
+		//! Topology of CPUs.
+		const cpu_topology_t m_topology;
+
+		//! Sequence of CPUs for new threads.
+		const std::vector< unsigned int > m_sequence;
+
+		//! Lock for m_next_index.
+		std::mutex m_lock;
+
+		//! Index of CPU for the next thread.
+		std::size_t m_next_index{};
+
+		[[nodiscard]] std::vector< unsigned int >
+		cpus_for( unsigned int cpu ) const
+			{
+				if( !m_numa_node_granularity )
+					return { cpu };
+
+				const auto it = std::find_if(
+						m_topology.begin(), m_topology.end(),
+						[cpu]( const cpu_info_t & info ) { return info.m_cpu == cpu; } );
+				if( it == m_topology.end() )
+					return { cpu };
+
+				std::vector< unsigned int > result;
+				for( const auto & info : m_topology )
+					if( info.m_numa_node == it->m_numa_node )
+						result.push_back( info.m_cpu );
+
+				return result;
+			}
+
+	public:
+		affinity_work_thread_factory_t(
+			const params_t & params,
+			cpu_topology_t topology )
+			:	m_numa_node_granularity{ params.numa_node_granularity() }
+			,	m_topology{ std::move(topology) }
+			,	m_sequence{ make_cpu_sequence( params, m_topology ) }
+			{}
+
+		[[nodiscard]]
+		abstract_work_thread_t &
+		acquire( so_5::environment_t & /*env*/ ) override
+			{
+				unsigned int cpu;
+				{
+					std::lock_guard< std::mutex > lock{ m_lock };
+					cpu = m_sequence[ m_next_index ];
+					m_next_index = ( m_next_index + 1u ) % m_sequence.size();
+				}
+
+				return *(new affinity_work_thread_t{ cpus_for( cpu ) });
+			}
+
+		void
+		release( abstract_work_thread_t & thread ) noexcept override
+			{
+				delete (&thread);
+			}
+	};
+
+#endif
+
+} /* namespace anonymous */
+
+} /* namespace impl */
+
+//
+// parse_cpu_list
+//
+SO_5_FUNC
+std::vector< unsigned int >
+parse_cpu_list( std::string_view cpu_list )
+	{
+		using namespace impl;
+
+		std::vector< unsigned int > result;
+
+		const auto list = trim( cpu_list );
+		if( list.empty() )
+			return result;
+
+		std::string_view::size_type pos = 0u;
+		while( pos <= list.size() )
+			{
+				auto comma = list.find( ',', pos );
+				if( std::string_view::npos == comma )
+					comma = list.size();
+
+				const auto item = list.substr( pos, comma - pos );
+				const auto dash = item.find( '-' );
+				if( std::string_view::npos == dash )
+					result.push_back( parse_cpu_index( cpu_list, item ) );
+				else
+					{
+						const auto first = parse_cpu_index(
+								cpu_list, item.substr( 0u, dash ) );
+						const auto last = parse_cpu_index(
+								cpu_list, item.substr( dash + 1u ) );
+						if( last < first )
+							throw_invalid_cpu_list( cpu_list, "invalid range" );
+
+						for( auto cpu = first; cpu <= last; ++cpu )
+							result.push_back( cpu );
+					}
+
+				pos = comma + 1u;
+			}
+
+		return result;
+	}
+
+//
+// query_cpu_topology
+//
+SO_5_FUNC
+cpu_topology_t
+query_cpu_topology( const std::string & sysfs_root )
+	{
+		cpu_topology_t result;
+
+#if defined(__linux__)
+		using namespace impl;
+
+		const std::string cpus_dir = sysfs_root + "/devices/system/cpu";
+
+		std::string online;
+		if( !read_file( cpus_dir + "/online", online ) )
+			return result;
+
+		for( const auto cpu : parse_cpu_list( online ) )
+			{
+				const std::string topology_dir =
+						cpus_dir + "/cpu" + std::to_string( cpu ) + "/topology";
+
+				result.push_back( cpu_info_t{
+						cpu,
+						read_id( topology_dir + "/core_id" ),
+						read_id( topology_dir + "/physical_package_id" ),
+						0u
+					} );
+			}
+
+		read_numa_nodes( sysfs_root, result );
+#else
+		(void)sysfs_root;
+#endif
+
+		return result;
+	}
+
+//
+// make_cpu_sequence
+//
+SO_5_FUNC
+std::vector< unsigned int >
+make_cpu_sequence(
+	const params_t & params,
+	const cpu_topology_t & topology )
+	{
+		std::vector< unsigned int > result;
+
+		switch( params.policy() )
+			{
+			case policy_t::compact:
+				{
+					cpu_topology_t sorted{ topology };
+					std::sort( sorted.begin(), sorted.end(),
+							[]( const cpu_info_t & a, const cpu_info_t & b ) {
+								return std::tie( a.m_numa_node, a.m_package, a.m_core, a.m_cpu )
+										< std::tie( b.m_numa_node, b.m_package, b.m_core, b.m_cpu );
+							} );
+					std::transform( sorted.begin(), sorted.end(),
+							std::back_inserter( result ),
+							[]( const cpu_info_t & info ) { return info.m_cpu; } );
+				}
+			break;
+
+			case policy_t::scatter:
+				{
+					// Every CPU gets the rank among hardware threads of
+					// the same core. CPUs with rank 0 go first, then CPUs with
+					// rank 1 and so on.
+					struct item_t
+						{
+							unsigned int m_rank;
+							cpu_info_t m_info;
+						};
+
+					cpu_topology_t sorted{ topology };
+					std::sort( sorted.begin(), sorted.end(),
+							[]( const cpu_info_t & a, const cpu_info_t & b ) {
+								return std::tie( a.m_numa_node, a.m_package, a.m_core, a.m_cpu )
+										< std::tie( b.m_numa_node, b.m_package, b.m_core, b.m_cpu );
+							} );
+
+					// Items are grouped by NUMA nodes.
+					std::map< unsigned int, std::vector< item_t > > nodes;
+					for( std::size_t i = 0u; i != sorted.size(); ++i )
+						{
+							const auto & info = sorted[ i ];
+							unsigned int rank = 0u;
+							if( i != 0u )
+								{
+									const auto & prev = sorted[ i - 1u ];
+									if( prev.m_numa_node == info.m_numa_node &&
+											prev.m_package == info.m_package &&
+											prev.m_core == info.m_core )
+										rank = nodes[ info.m_numa_node ].back().m_rank + 1u;
+								}
+							nodes[ info.m_numa_node ].push_back( item_t{ rank, info } );
+						}
+
+					for( auto & [node, items] : nodes )
+						std::stable_sort( items.begin(), items.end(),
+								[]( const item_t & a, const item_t & b ) {
+									return a.m_rank < b.m_rank;
+								} );
+
+					// NUMA nodes are used in the round-robin manner.
+					for( std::size_t i = 0u; result.size() != sorted.size(); ++i )
+						for( const auto & [node, items] : nodes )
+							if( i < items.size() )
+								result.push_back( items[ i ].m_info.m_cpu );
+				}
+			break;
+
+			case policy_t::explicit_list:
+				result = params.explicit_cpus();
+				for( const auto cpu : result )
+					if( cpu >= max_cpu_count )
+						SO_5_THROW_EXCEPTION( rc_invalid_cpu_list,
+								"CPU index is too big: " + std::to_string( cpu ) );
+
+				// Topology can be unavailable, CPUs are checked only if
+				// it's present.
+				if( !topology.empty() )
+					for( const auto cpu : result )
+						{
+							const bool found = std::any_of(
+									topology.begin(), topology.end(),
+									[cpu]( const cpu_info_t & info ) {
+										return info.m_cpu == cpu;
+									} );
+							if( !found )
+								SO_5_THROW_EXCEPTION( rc_invalid_cpu_list,
+										"CPU " + std::to_string( cpu ) +
+										" isn't online" );
+						}
+			break;
+			}
+
+		if( result.empty() )
+			SO_5_THROW_EXCEPTION( rc_invalid_cpu_list,
+					"there are no CPUs for work threads" );
+
+		return result;
+	}
+
+//
+// make_work_thread_factory
+//
+SO_5_FUNC
+abstract_work_thread_factory_shptr_t
+make_work_thread_factory( params_t params )
+	{
+#if defined(__linux__)
+		return std::make_shared< impl::affinity_work_thread_factory_t >(
+				params,
+				query_cpu_topology() );
+#else
+		(void)params;
+		SO_5_THROW_EXCEPTION( rc_not_implemented,
+				"so_5::disp::affinity::make_work_thread_factory isn't "
+				"supported on this platform" );
+#endif
+	}
+
+} /* namespace so_5::disp::affinity */
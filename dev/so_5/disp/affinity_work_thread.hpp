@@ -0,0 +1,342 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A factory for work threads pinned to CPU cores or NUMA nodes.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/disp/abstract_work_thread.hpp>
+
+#include <so_5/declspec.hpp>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace so_5::disp::affinity
+{
+
+//
+// cpu_info_t
+//
+/*!
+ * \brief Description of one logical CPU.
+ *
+ * \since v.5.8.5
+ */
+struct cpu_info_t
+	{
+		//! Index of the logical CPU.
+		unsigned int m_cpu;
+
+		//! ID of the physical core inside a package.
+		unsigned int m_core;
+
+		//! ID of the physical package (socket).
+		unsigned int m_package;
+
+		//! ID of the NUMA node.
+		unsigned int m_numa_node;
+	};
+
+//
+// cpu_topology_t
+//
+/*!
+ * \brief Type of container with descriptions of logical CPUs.
+ *
+ * \since v.5.8.5
+ */
+using cpu_topology_t = std::vector< cpu_info_t >;
+
+//
+// policy_t
+//
+/*!
+ * \brief Policy of the distribution of work threads between CPUs.
+ *
+ * \since v.5.8.5
+ */
+enum class policy_t
+	{
+		//! Threads are placed as close as possible.
+		/*!
+		 * Hardware threads of one core are occupied first, then cores
+		 * of one package, then packages of one NUMA node.
+		 */
+		compact,
+		//! Threads are placed as far as possible.
+		/*!
+		 * Threads are distributed between NUMA nodes in the round-robin
+		 * manner. Inside a NUMA node different physical cores are
+		 * occupied before hardware threads of the same core.
+		 */
+		scatter,
+		//! Threads are placed on CPUs from the list specified by a user.
+		explicit_list
+	};
+
+//
+// max_cpu_count
+//
+/*!
+ * \brief The max count of CPUs supported.
+ *
+ * It's the max value of NR_CPUS in the Linux kernel.
+ *
+ * \since v.5.8.5
+ */
+inline constexpr unsigned int max_cpu_count = 8192u;
+
+/*!
+ * \brief Parse a list of CPUs in Linux cpulist format.
+ *
+ * For example, "0-3,8,10-11" is parsed as {0, 1, 2, 3, 8, 10, 11}.
+ * Spaces and the trailing new line are ignored.
+ *
+ * CPU indexes must be less than max_cpu_count.
+ *
+ * \throw so_5::exception_t if \a cpu_list has invalid format.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+SO_5_FUNC
+std::vector< unsigned int >
+parse_cpu_list( std::string_view cpu_list );
+
+//
+// params_t
+//
+/*!
+ * \brief Parameters for the work thread factory with CPU affinity.
+ *
+ * Usage example:
+ * \code
+ * // Threads of the default dispatcher and of all dispatchers
+ * // without own factories will be distributed between NUMA nodes.
+ * so_5::launch( ...,
+ * 	[]( so_5::environment_params_t & params ) {
+ * 		params.work_thread_factory(
+ * 			so_5::disp::affinity::make_work_thread_factory(
+ * 				so_5::disp::affinity::params_t{}.scatter() ) );
+ * 	} );
+ * ...
+ * // Threads of this thread_pool dispatcher will work on CPUs 4-7 only.
+ * auto disp = so_5::disp::thread_pool::make_dispatcher( env, "latency",
+ * 	so_5::disp::thread_pool::disp_params_t{}
+ * 		.thread_count( 4 )
+ * 		.work_thread_factory(
+ * 			so_5::disp::affinity::make_work_thread_factory(
+ * 				so_5::disp::affinity::params_t{}.cpus( "4-7" ) ) ) );
+ * \endcode
+ *
+ * \since v.5.8.5
+ */
+class params_t
+	{
+		//! Distribution policy.
+		policy_t m_policy{ policy_t::compact };
+
+		//! CPUs for policy_t::explicit_list.
+		std::vector< unsigned int > m_cpus;
+
+		//! Should a thread be pinned to the whole NUMA node?
+		bool m_numa_node_granularity{ false };
+
+	public:
+		//! Use policy_t::compact.
+		params_t &
+		compact() &
+			{
+				m_policy = policy_t::compact;
+				return *this;
+			}
+
+		//! Use policy_t::compact.
+		[[nodiscard]]
+		params_t &&
+		compact() &&
+			{
+				return std::move( this->compact() );
+			}
+
+		//! Use policy_t::scatter.
+		params_t &
+		scatter() &
+			{
+				m_policy = policy_t::scatter;
+				return *this;
+			}
+
+		//! Use policy_t::scatter.
+		[[nodiscard]]
+		params_t &&
+		scatter() &&
+			{
+				return std::move( this->scatter() );
+			}
+
+		//! Use policy_t::explicit_list with the specified CPUs.
+		/*!
+		 * Threads will be placed on \a cpus in the specified order.
+		 * If there are more threads than items in \a cpus then the list
+		 * is reused from the beginning.
+		 */
+		params_t &
+		cpus( std::vector< unsigned int > cpus ) &
+			{
+				m_policy = policy_t::explicit_list;
+				m_cpus = std::move(cpus);
+				return *this;
+			}
+
+		//! Use policy_t::explicit_list with the specified CPUs.
+		[[nodiscard]]
+		params_t &&
+		cpus( std::vector< unsigned int > cpus ) &&
+			{
+				return std::move( this->cpus( std::move(cpus) ) );
+			}
+
+		//! Use policy_t::explicit_list with CPUs in Linux cpulist format.
+		/*!
+		 * For example: "0-3,8,10-11".
+		 *
+		 * \throw so_5::exception_t if \a cpu_list has invalid format.
+		 */
+		params_t &
+		cpus( std::string_view cpu_list ) &
+			{
+				return this->cpus( parse_cpu_list( cpu_list ) );
+			}
+
+		//! Use policy_t::explicit_list with CPUs in Linux cpulist format.
+		[[nodiscard]]
+		params_t &&
+		cpus( std::string_view cpu_list ) &&
+			{
+				return std::move( this->cpus( cpu_list ) );
+			}
+
+		//! Pin a thread to all CPUs of a NUMA node.
+		/*!
+		 * If that mode is turned on then a thread is pinned not to
+		 * a selected CPU, but to all CPUs of the NUMA node the
+		 * selected CPU belongs to. The OS scheduler can move the thread
+		 * between cores of the node, but memory allocated by the thread
+		 * remains local to the node.
+		 */
+		params_t &
+		numa_node_granularity( bool v ) & noexcept
+			{
+				m_numa_node_granularity = v;
+				return *this;
+			}
+
+		//! Pin a thread to all CPUs of a NUMA node.
+		[[nodiscard]]
+		params_t &&
+		numa_node_granularity( bool v ) && noexcept
+			{
+				return std::move( this->numa_node_granularity( v ) );
+			}
+
+		[[nodiscard]]
+		policy_t
+		policy() const noexcept { return m_policy; }
+
+		[[nodiscard]]
+		const std::vector< unsigned int > &
+		explicit_cpus() const noexcept { return m_cpus; }
+
+		[[nodiscard]]
+		bool
+		numa_node_granularity() const noexcept
+			{
+				return m_numa_node_granularity;
+			}
+	};
+
+/*!
+ * \brief Read the topology of online CPUs from sysfs.
+ *
+ * Information is read from `<sysfs_root>/devices/system/cpu` and
+ * `<sysfs_root>/devices/system/node`. If some information isn't
+ * available (for example, there is no NUMA support in the kernel)
+ * then 0 is used as ID of a core/package/NUMA node.
+ *
+ * \note
+ * It returns an empty container on platforms other than Linux.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+SO_5_FUNC
+cpu_topology_t
+query_cpu_topology(
+	//! Root of sysfs. Can be changed for testing purposes.
+	const std::string & sysfs_root = "/sys" );
+
+/*!
+ * \brief Make a sequence of CPUs for new threads with respect to
+ * the policy.
+ *
+ * The N-th thread created by a factory is placed on the item
+ * (N % size) of the sequence.
+ *
+ * \throw so_5::exception_t if the sequence is empty or if an explicit
+ * CPU is absent in \a topology.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+SO_5_FUNC
+std::vector< unsigned int >
+make_cpu_sequence(
+	const params_t & params,
+	const cpu_topology_t & topology );
+
+/*!
+ * \brief Create a work thread factory that pins threads to CPUs.
+ *
+ * The factory can be passed to so_5::environment_params_t::work_thread_factory()
+ * or to the `work_thread_factory()` method of dispatcher's disp_params_t.
+ * A separate factory can be created for every dispatcher, for example,
+ * with different lists of CPUs.
+ *
+ * A thread is pinned at the very beginning of its body, before the start
+ * of dispatcher's work. Memory allocated by the thread itself is allocated
+ * with respect to the NUMA node of the thread (according to Linux
+ * first-touch policy).
+ *
+ * \attention
+ * Data structures of a dispatcher (like demand queues) are created by
+ * the thread that creates the dispatcher, before the start of work
+ * threads. They aren't moved to the NUMA node of a work thread.
+ *
+ * \note
+ * If the affinity can't be set for a thread (for example, because
+ * of restrictions set by cgroups) then the thread works without affinity.
+ *
+ * \note
+ * Only Linux is supported now. An exception is thrown on other platforms.
+ *
+ * \throw so_5::exception_t if topology can't be detected or \a params
+ * contains invalid values.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+SO_5_FUNC
+abstract_work_thread_factory_shptr_t
+make_work_thread_factory( params_t params = params_t{} );
+
+} /* namespace so_5::disp::affinity */
@@ -0,0 +1,382 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief A demand queue for dispatcher with one common working
+ * thread and the earliest-deadline-first order of demands.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/disp/edf_one_thread/pub.hpp>
+
+#include <so_5/execution_demand.hpp>
+#include <so_5/event_queue.hpp>
+#include <so_5/agent.hpp>
+
+#include <so_5/disp/mpsc_queue_traits/pub.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace edf_one_thread {
+
+namespace impl {
+
+using clock_type_t = with_deadline_t::clock_type_t;
+
+//
+// demand_t
+//
+/*!
+ * \brief A single execution demand.
+ *
+ * \since v.5.8.5
+ */
+struct demand_t final : public execution_demand_t
+	{
+		//! Deadline of the demand.
+		/*!
+		 * It's the time of enqueueing for demands without deadlines.
+		 */
+		clock_type_t::time_point m_deadline;
+
+		//! Sequence number of the demand.
+		/*!
+		 * It's used for ordering of demands with the same deadline.
+		 */
+		std::uint_least64_t m_seq{};
+
+		//! Can the demand be expired?
+		/*!
+		 * It's true only for messages derived from with_deadline_t.
+		 */
+		bool m_may_expire{ false };
+
+		//! Initializing constructor.
+		demand_t( execution_demand_t && source )
+			:	execution_demand_t( std::move( source ) )
+			{}
+	};
+
+//
+// demand_unique_ptr_t
+//
+/*!
+ * \brief An alias for unique_ptr to demand.
+ *
+ * \since v.5.8.5
+ */
+using demand_unique_ptr_t = std::unique_ptr< demand_t >;
+
+//
+// demand_queue_t
+//
+/*!
+ * \brief A demand queue with the earliest-deadline-first order of demands.
+ *
+ * Demands are stored in a binary heap ordered by (deadline, sequence number).
+ *
+ * \since v.5.8.5
+ */
+class demand_queue_t
+	{
+	public :
+		//! This exception is thrown when pop is called after stop.
+		class shutdown_ex_t : public std::exception
+			{};
+
+		//! An event queue for one agent.
+		/*!
+		 * It's necessary for placing so_evt_finish after all
+		 * demands of the agent.
+		 */
+		class agent_queue_t final : public event_queue_t
+			{
+				friend class demand_queue_t;
+
+			public :
+				agent_queue_t( demand_queue_t & demand_queue ) noexcept
+					:	m_demand_queue{ demand_queue }
+					{}
+
+				void
+				push( execution_demand_t demand ) override
+					{
+						m_demand_queue.push( *this, std::move(demand), false );
+					}
+
+				/*!
+				 * \note
+				 * Delegates the work to the push() method.
+				 */
+				void
+				push_evt_start( execution_demand_t demand ) override
+					{
+						this->push( std::move(demand) );
+					}
+
+				/*!
+				 * \attention
+				 * Terminates the whole application if the push throws.
+				 */
+				void
+				push_evt_finish( execution_demand_t demand ) noexcept override
+					{
+						m_demand_queue.push( *this, std::move(demand), true );
+					}
+
+			private :
+				//! The main demand queue.
+				demand_queue_t & m_demand_queue;
+
+				//! The max deadline of demands of the agent.
+				/*!
+				 * \note
+				 * It's protected by the lock of the main demand queue.
+				 */
+				clock_type_t::time_point m_max_deadline{};
+			};
+
+		demand_queue_t(
+			//! Lock to be used for queue protection.
+			queue_traits::lock_unique_ptr_t lock,
+			//! Mbox for expired messages. Can be empty.
+			mbox_t expired_demands_mbox )
+			:	m_lock{ std::move(lock) }
+			,	m_expired_demands_mbox{ std::move(expired_demands_mbox) }
+			{}
+
+		//! Set the shutdown signal.
+		void
+		stop()
+			{
+				queue_traits::lock_guard_t lock{ *m_lock };
+
+				m_shutdown = true;
+
+				if( m_heap.empty() )
+					// There could be a sleeping working thread.
+					// It must be notified.
+					lock.notify_one();
+			}
+
+		//! Pop demand from the queue.
+		/*!
+		 * Expired demands are handled here and aren't returned.
+		 *
+		 * \throw shutdown_ex_t in the case when queue is shut down.
+		 */
+		[[nodiscard]]
+		demand_unique_ptr_t
+		pop()
+			{
+				for(;;)
+					{
+						auto result = extract_earliest();
+
+						if( !result->m_may_expire ||
+								clock_type_t::now() <= result->m_deadline )
+							return result;
+
+						handle_expired( *result );
+					}
+			}
+
+		//! Count of demands in the queue.
+		[[nodiscard]]
+		std::size_t
+		demands_count() const noexcept
+			{
+				return m_demands_count.load( std::memory_order_relaxed );
+			}
+
+		//! Count of expired demands since the start of the dispatcher.
+		[[nodiscard]]
+		std::size_t
+		expired_demands_count() const noexcept
+			{
+				return m_expired_demands_count.load( std::memory_order_relaxed );
+			}
+
+		//! Count of dropped demands since the start of the dispatcher.
+		[[nodiscard]]
+		std::size_t
+		dropped_demands_count() const noexcept
+			{
+				return m_dropped_demands_count.load( std::memory_order_relaxed );
+			}
+
+	private :
+		//! Queue lock.
+		queue_traits::lock_unique_ptr_t m_lock;
+
+		//! Mbox for expired messages.
+		const mbox_t m_expired_demands_mbox;
+
+		//! Shutdown flag.
+		bool m_shutdown = false;
+
+		//! Counter for sequence numbers of demands.
+		std::uint_least64_t m_last_seq{};
+
+		//! Binary heap of demands.
+		/*!
+		 * The demand with the earliest deadline is at the front.
+		 */
+		std::vector< demand_unique_ptr_t > m_heap;
+
+		/*!
+		 * \name Information for run-time monitoring.
+		 * \{
+		 */
+		std::atomic< std::size_t > m_demands_count{ 0 };
+		std::atomic< std::size_t > m_expired_demands_count{ 0 };
+		std::atomic< std::size_t > m_dropped_demands_count{ 0 };
+		/*!
+		 * \}
+		 */
+
+		//! Comparator for the heap.
+		/*!
+		 * std::push_heap/std::pop_heap make a max-heap, so the comparison
+		 * is reversed.
+		 */
+		[[nodiscard]]
+		static bool
+		is_later(
+			const demand_unique_ptr_t & a,
+			const demand_unique_ptr_t & b ) noexcept
+			{
+				if( a->m_deadline != b->m_deadline )
+					return a->m_deadline > b->m_deadline;
+				return a->m_seq > b->m_seq;
+			}
+
+		//! Push a new demand to the queue.
+		void
+		push(
+			agent_queue_t & agent_queue,
+			execution_demand_t exec_demand,
+			//! Is it so_evt_finish demand?
+			bool is_final_demand )
+			{
+				demand_unique_ptr_t demand{ new demand_t{ std::move(exec_demand) } };
+
+				demand->m_deadline = clock_type_t::now();
+				if( agent_t::get_demand_handler_on_message_ptr() ==
+						demand->m_demand_handler && demand->m_message_ref )
+					{
+						const auto * deadline = dynamic_cast< const with_deadline_t * >(
+								demand->m_message_ref.get() );
+						if( deadline )
+							{
+								demand->m_deadline = deadline->so_deadline();
+								demand->m_may_expire = true;
+							}
+					}
+
+				queue_traits::lock_guard_t lock{ *m_lock };
+
+				if( is_final_demand )
+					// so_evt_finish has to be handled after all other
+					// demands of the agent.
+					demand->m_deadline = (std::max)(
+							demand->m_deadline, agent_queue.m_max_deadline );
+				else
+					agent_queue.m_max_deadline = (std::max)(
+							demand->m_deadline, agent_queue.m_max_deadline );
+
+				demand->m_seq = ++m_last_seq;
+
+				const bool was_empty = m_heap.empty();
+
+				m_heap.push_back( std::move(demand) );
+				std::push_heap( m_heap.begin(), m_heap.end(), &is_later );
+				++m_demands_count;
+
+				if( was_empty )
+					// A sleeping working thread must be notified.
+					lock.notify_one();
+			}
+
+		//! Wait for a demand and extract the earliest one.
+		/*!
+		 * \throw shutdown_ex_t in the case when queue is shut down.
+		 */
+		[[nodiscard]]
+		demand_unique_ptr_t
+		extract_earliest()
+			{
+				queue_traits::unique_lock_t lock{ *m_lock };
+
+				while( !m_shutdown && m_heap.empty() )
+					lock.wait_for_notify();
+
+				if( m_shutdown )
+					throw shutdown_ex_t();
+
+				std::pop_heap( m_heap.begin(), m_heap.end(), &is_later );
+				demand_unique_ptr_t result = std::move( m_heap.back() );
+				m_heap.pop_back();
+				--m_demands_count;
+
+				return result;
+			}
+
+		//! Drop or redirect an expired demand.
+		/*!
+		 * \note
+		 * It's called without holding the queue lock because
+		 * the redirection can lead to a push to this queue.
+		 */
+		void
+		handle_expired( demand_t & demand )
+			{
+				++m_expired_demands_count;
+
+				// The handler won't be called, so the message limit
+				// has to be decremented here.
+				message_limit::control_block_t::decrement( demand.m_limit );
+
+				bool redirected = false;
+				if( m_expired_demands_mbox )
+					{
+						try
+							{
+								m_expired_demands_mbox->do_deliver_message(
+										message_delivery_mode_t::nonblocking,
+										demand.m_msg_type,
+										demand.m_message_ref,
+										1u );
+								redirected = true;
+							}
+						catch( ... )
+							{
+								// The message will be counted as dropped.
+							}
+					}
+
+				if( !redirected )
+					++m_dropped_demands_count;
+			}
+	};
+
+} /* namespace impl */
+
+} /* namespace edf_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
@@ -0,0 +1,289 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Functions for creating and binding of the single thread dispatcher
+ * that handles demands in the earliest-deadline-first order.
+ *
+ * \since v.5.8.5
+ */
+
+#include <so_5/disp/edf_one_thread/pub.hpp>
+
+#include <so_5/disp/edf_one_thread/impl/demand_queue.hpp>
+#include <so_5/disp/prio_one_thread/reuse/work_thread.hpp>
+
+#include <so_5/disp/reuse/actual_work_thread_factory_to_use.hpp>
+#include <so_5/disp/reuse/data_source_prefix_helpers.hpp>
+#include <so_5/disp/reuse/make_actual_dispatcher.hpp>
+
+#include <so_5/stats/repository.hpp>
+#include <so_5/stats/messages.hpp>
+#include <so_5/stats/std_names.hpp>
+
+#include <so_5/send_functions.hpp>
+
+#include <map>
+#include <mutex>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace edf_one_thread {
+
+namespace impl {
+
+namespace stats = so_5::stats;
+
+namespace {
+
+void
+send_thread_activity_stats(
+	const so_5::mbox_t &,
+	const stats::prefix_t &,
+	so_5::disp::prio_one_thread::reuse::work_thread_no_activity_tracking_t<
+			demand_queue_t > & )
+	{
+		/* Nothing to do */
+	}
+
+void
+send_thread_activity_stats(
+	const so_5::mbox_t & mbox,
+	const stats::prefix_t & prefix,
+	so_5::disp::prio_one_thread::reuse::work_thread_with_activity_tracking_t<
+			demand_queue_t > & wt )
+	{
+		so_5::send< stats::messages::work_thread_activity >(
+				mbox,
+				prefix,
+				stats::suffixes::work_thread_activity(),
+				wt.thread_id(),
+				wt.take_activity_stats() );
+	}
+
+} /* namespace anonymous */
+
+//
+// dispatcher_template_t
+//
+/*!
+ * \brief An implementation of dispatcher with one working
+ * thread and the earliest-deadline-first order of demands.
+ *
+ * \since v.5.8.5
+ */
+template< typename Work_Thread >
+class dispatcher_template_t final : public disp_binder_t
+	{
+		friend class disp_data_source_t;
+
+	public:
+		dispatcher_template_t(
+			outliving_reference_t< environment_t > env,
+			const std::string_view name_base,
+			disp_params_t params )
+			:	m_demand_queue{
+					params.queue_params().lock_factory()(),
+					params.expired_demands_mbox()
+				}
+			,	m_work_thread{
+					so_5::disp::reuse::acquire_work_thread( params, env.get() ),
+					m_demand_queue
+				}
+			,	m_data_source{
+					outliving_mutable(env.get().stats_repository()),
+					name_base,
+					outliving_mutable(*this)
+				}
+			{
+				m_work_thread.start();
+			}
+
+		~dispatcher_template_t() noexcept override
+			{
+				m_demand_queue.stop();
+				m_work_thread.join();
+			}
+
+		void
+		preallocate_resources(
+			agent_t & agent ) override
+			{
+				auto queue = std::make_unique< demand_queue_t::agent_queue_t >(
+						m_demand_queue );
+
+				std::lock_guard< std::mutex > lock{ m_agent_queues_lock };
+				m_agent_queues.emplace( &agent, std::move(queue) );
+			}
+
+		void
+		undo_preallocation(
+			agent_t & agent ) noexcept override
+			{
+				std::lock_guard< std::mutex > lock{ m_agent_queues_lock };
+				m_agent_queues.erase( &agent );
+			}
+
+		void
+		bind(
+			agent_t & agent ) noexcept override
+			{
+				std::lock_guard< std::mutex > lock{ m_agent_queues_lock };
+
+				agent.so_bind_to_dispatcher( *(m_agent_queues.find( &agent )->second) );
+			}
+
+		void
+		unbind(
+			agent_t & agent ) noexcept override
+			{
+				std::lock_guard< std::mutex > lock{ m_agent_queues_lock };
+				m_agent_queues.erase( &agent );
+			}
+
+	private:
+
+		/*!
+		 * \brief Data source for run-time monitoring of whole dispatcher.
+		 *
+		 * \since v.5.8.5
+		 */
+		class disp_data_source_t : public stats::source_t
+			{
+				//! Dispatcher to work with.
+				outliving_reference_t< dispatcher_template_t > m_dispatcher;
+
+				//! Basic prefix for data sources.
+				stats::prefix_t m_base_prefix;
+
+			public :
+				disp_data_source_t(
+					const std::string_view name_base,
+					outliving_reference_t< dispatcher_template_t > disp )
+					:	m_dispatcher{ disp }
+					,	m_base_prefix{ so_5::disp::reuse::make_disp_prefix(
+								"edf-ot",
+								name_base,
+								&(disp.get()) )
+						}
+					{}
+
+				void
+				distribute( const mbox_t & mbox ) override
+					{
+						auto & disp = m_dispatcher.get();
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_base_prefix,
+								stats::suffixes::agent_count(),
+								disp.agents_count() );
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_base_prefix,
+								stats::suffixes::work_thread_queue_size(),
+								disp.m_demand_queue.demands_count() );
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_base_prefix,
+								stats::suffixes::expired_demands_count(),
+								disp.m_demand_queue.expired_demands_count() );
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_base_prefix,
+								stats::suffixes::dropped_demands_count(),
+								disp.m_demand_queue.dropped_demands_count() );
+
+						send_thread_activity_stats(
+								mbox,
+								m_base_prefix,
+								disp.m_work_thread );
+					}
+			};
+
+		//! Demand queue for the dispatcher.
+		demand_queue_t m_demand_queue;
+
+		//! Working thread for the dispatcher.
+		Work_Thread m_work_thread;
+
+		//! Lock for the map of agent queues.
+		std::mutex m_agent_queues_lock;
+
+		//! Event queues for agents bound to the dispatcher.
+		std::map<
+					agent_t *,
+					std::unique_ptr< demand_queue_t::agent_queue_t > >
+				m_agent_queues;
+
+		//! Data source for run-time monitoring.
+		stats::auto_registered_source_holder_t< disp_data_source_t >
+				m_data_source;
+
+		[[nodiscard]]
+		std::size_t
+		agents_count()
+			{
+				std::lock_guard< std::mutex > lock{ m_agent_queues_lock };
+				return m_agent_queues.size();
+			}
+	};
+
+//
+// dispatcher_handle_maker_t
+//
+class dispatcher_handle_maker_t
+	{
+	public :
+		static dispatcher_handle_t
+		make( disp_binder_shptr_t binder ) noexcept
+			{
+				return { std::move( binder ) };
+			}
+	};
+
+} /* namespace impl */
+
+//
+// make_dispatcher
+//
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	environment_t & env,
+	const std::string_view data_sources_name_base,
+	disp_params_t params )
+	{
+		using namespace so_5::disp::reuse;
+		using namespace so_5::disp::prio_one_thread::reuse;
+
+		using dispatcher_no_activity_tracking_t =
+				impl::dispatcher_template_t<
+						work_thread_no_activity_tracking_t< impl::demand_queue_t > >;
+
+		using dispatcher_with_activity_tracking_t =
+				impl::dispatcher_template_t<
+						work_thread_with_activity_tracking_t< impl::demand_queue_t > >;
+
+		disp_binder_shptr_t binder = so_5::disp::reuse::make_actual_dispatcher<
+						disp_binder_t,
+						dispatcher_no_activity_tracking_t,
+						dispatcher_with_activity_tracking_t >(
+				outliving_mutable(env),
+				data_sources_name_base,
+				std::move(params) );
+
+		return impl::dispatcher_handle_maker_t::make( std::move(binder) );
+	}
+
+} /* namespace edf_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
@@ -0,0 +1,363 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Functions for creating and binding of the single thread dispatcher
+ * that handles demands in the earliest-deadline-first order.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/declspec.hpp>
+
+#include <so_5/disp_binder.hpp>
+#include <so_5/mbox.hpp>
+
+#include <so_5/disp/mpsc_queue_traits/pub.hpp>
+
+#include <so_5/disp/reuse/work_thread_activity_tracking.hpp>
+#include <so_5/disp/reuse/work_thread_factory_params.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace edf_one_thread {
+
+/*!
+ * \brief Alias for namespace with traits of event queue.
+ *
+ * \since v.5.8.5
+ */
+namespace queue_traits = so_5::disp::mpsc_queue_traits;
+
+//
+// with_deadline_t
+//
+/*!
+ * \brief A mixin for messages with a deadline.
+ *
+ * A message that has to be handled before some time point should be
+ * derived from so_5::message_t and from this class:
+ * \code
+ * struct msg_request final
+ * 	:	public so_5::message_t
+ * 	,	public so_5::disp::edf_one_thread::with_deadline_t
+ * {
+ * 	std::string m_id;
+ *
+ * 	msg_request( std::string id, std::chrono::milliseconds timeout )
+ * 		:	so_5::disp::edf_one_thread::with_deadline_t{ timeout }
+ * 		,	m_id{ std::move(id) }
+ * 	{}
+ * };
+ * \endcode
+ *
+ * \note
+ * The deadline is taken into account only by edf_one_thread dispatcher.
+ * Other dispatchers ignore it.
+ *
+ * \since v.5.8.5
+ */
+class with_deadline_t
+	{
+	public :
+		//! Type of clock used for deadlines.
+		using clock_type_t = std::chrono::steady_clock;
+
+		//! Initializing constructor for an absolute deadline.
+		explicit with_deadline_t(
+			clock_type_t::time_point deadline ) noexcept
+			:	m_deadline{ deadline }
+			{}
+
+		//! Initializing constructor for a deadline relative to
+		//! the current time.
+		explicit with_deadline_t(
+			clock_type_t::duration timeout ) noexcept
+			:	m_deadline{ clock_type_t::now() + timeout }
+			{}
+
+		//! Get the deadline.
+		[[nodiscard]]
+		clock_type_t::time_point
+		so_deadline() const noexcept
+			{
+				return m_deadline;
+			}
+
+	protected :
+		~with_deadline_t() noexcept = default;
+
+	private :
+		//! Time point after that the message is expired.
+		clock_type_t::time_point m_deadline;
+	};
+
+//
+// disp_params_t
+//
+/*!
+ * \brief Parameters for a dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class disp_params_t
+	:	public so_5::disp::reuse::work_thread_activity_tracking_flag_mixin_t< disp_params_t >
+	,	public so_5::disp::reuse::work_thread_factory_mixin_t< disp_params_t >
+	{
+		using activity_tracking_mixin_t = so_5::disp::reuse::
+				work_thread_activity_tracking_flag_mixin_t< disp_params_t >;
+		using thread_factory_mixin_t = so_5::disp::reuse::
+				work_thread_factory_mixin_t< disp_params_t >;
+
+	public :
+		//! Default constructor.
+		disp_params_t() = default;
+
+		friend inline void
+		swap( disp_params_t & a, disp_params_t & b ) noexcept
+			{
+				swap(
+						static_cast< activity_tracking_mixin_t & >(a),
+						static_cast< activity_tracking_mixin_t & >(b) );
+
+				swap(
+						static_cast< work_thread_factory_mixin_t & >(a),
+						static_cast< work_thread_factory_mixin_t & >(b) );
+
+				swap( a.m_queue_params, b.m_queue_params );
+				swap( a.m_expired_demands_mbox, b.m_expired_demands_mbox );
+			}
+
+		//! Setter for queue parameters.
+		disp_params_t &
+		set_queue_params( queue_traits::queue_params_t p )
+			{
+				m_queue_params = std::move(p);
+				return *this;
+			}
+
+		//! Tuner for queue parameters.
+		/*!
+		 * Accepts lambda-function or functional object which tunes
+		 * queue parameters.
+			\code
+			namespace edf_disp = so_5::disp::edf_one_thread;
+			auto disp = edf_disp::make_dispatcher( env,
+				"my_edf_disp",
+				edf_disp::disp_params_t{}.tune_queue_params(
+					[]( edf_disp::queue_traits::queue_params_t & p ) {
+						p.lock_factory( edf_disp::queue_traits::simple_lock_factory() );
+					} ) );
+			\endcode
+		 */
+		template< typename L >
+		disp_params_t &
+		tune_queue_params( L tunner )
+			{
+				tunner( m_queue_params );
+				return *this;
+			}
+
+		//! Getter for queue parameters.
+		const queue_traits::queue_params_t &
+		queue_params() const noexcept
+			{
+				return m_queue_params;
+			}
+
+		//! Setter for mbox for expired messages.
+		/*!
+		 * If this mbox is set then expired messages are redirected
+		 * to it instead of being dropped.
+		 *
+		 * \note
+		 * The redirection is performed in the nonblocking mode. If the
+		 * redirection fails (for example, if a mutable message is
+		 * redirected to a MPMC mbox) the message is dropped.
+		 */
+		disp_params_t &
+		expired_demands_mbox( mbox_t mbox )
+			{
+				m_expired_demands_mbox = std::move(mbox);
+				return *this;
+			}
+
+		//! Getter for mbox for expired messages.
+		[[nodiscard]]
+		const mbox_t &
+		expired_demands_mbox() const noexcept
+			{
+				return m_expired_demands_mbox;
+			}
+
+	private :
+		//! Queue parameters.
+		queue_traits::queue_params_t m_queue_params;
+
+		//! Mbox for expired messages.
+		/*!
+		 * Expired messages are dropped if it's empty.
+		 */
+		mbox_t m_expired_demands_mbox;
+	};
+
+namespace impl
+{
+
+class dispatcher_handle_maker_t;
+
+} /* namespace impl */
+
+//
+// dispatcher_handle_t
+//
+
+/*!
+ * \brief A handle for %edf_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class [[nodiscard]] dispatcher_handle_t
+	{
+		friend class impl::dispatcher_handle_maker_t;
+
+		//! Binder for the dispatcher.
+		disp_binder_shptr_t m_binder;
+
+		dispatcher_handle_t( disp_binder_shptr_t binder ) noexcept
+			:	m_binder{ std::move(binder) }
+			{}
+
+		//! Is this handle empty?
+		bool
+		empty() const noexcept { return !m_binder; }
+
+	public :
+		dispatcher_handle_t() noexcept = default;
+
+		//! Get a binder for that dispatcher.
+		[[nodiscard]]
+		disp_binder_shptr_t
+		binder() const noexcept
+			{
+				return m_binder;
+			}
+
+		//! Is this handle empty?
+		operator bool() const noexcept { return empty(); }
+
+		//! Does this handle contain a reference to dispatcher?
+		bool
+		operator!() const noexcept { return !empty(); }
+
+		//! Drop the content of handle.
+		void
+		reset() noexcept { m_binder.reset(); }
+	};
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of %edf_one_thread dispatcher.
+ *
+ * The dispatcher has one work thread and one queue of demands for all
+ * agents bound to it. Demands are handled in the earliest-deadline-first
+ * order:
+ *
+ * - the deadline of a message derived from with_deadline_t is the value
+ *   returned by with_deadline_t::so_deadline();
+ * - the deadline of any other demand (a signal, a message without
+ *   with_deadline_t, an enveloped message, so_evt_start/so_evt_finish)
+ *   is the time of its enqueueing. Such demands never expire.
+ *
+ * Demands with the same deadline are handled in the order of their arrival.
+ * It means that the dispatcher works as an ordinary one_thread dispatcher
+ * if there are no messages with deadlines.
+ *
+ * A message with a deadline is checked just before the execution. If its
+ * deadline has already passed then the message isn't passed to the agent,
+ * it's dropped or redirected to disp_params_t::expired_demands_mbox().
+ *
+ * \attention
+ * Messages with deadlines can be handled by an agent in an order that
+ * differs from the order of sending. The only guarantee is that
+ * so_evt_start() is handled before, and so_evt_finish() is handled after,
+ * all other demands of the agent.
+ *
+ * Counts of expired and dropped demands are distributed as run-time
+ * monitoring data (see so_5::stats::suffixes::expired_demands_count() and
+ * so_5::stats::suffixes::dropped_demands_count()).
+ *
+ * \par Usage sample
+\code
+auto edf_disp = so_5::disp::edf_one_thread::make_dispatcher(
+	env,
+	"request_processor",
+	so_5::disp::edf_one_thread::disp_params_t{}
+		.expired_demands_mbox( rejected_requests_mbox ) );
+auto coop = env.make_coop(
+	// The main dispatcher for that coop will be
+	// this instance of edf_one_thread dispatcher.
+	edf_disp.binder() );
+\endcode
+ *
+ * \since v.5.8.5
+ */
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	//! SObjectizer Environment to work in.
+	environment_t & env,
+	//! Value for creating names of data sources for
+	//! run-time monitoring.
+	const std::string_view data_sources_name_base,
+	//! Parameters for the dispatcher.
+	disp_params_t params );
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of %edf_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+inline dispatcher_handle_t
+make_dispatcher(
+	//! SObjectizer Environment to work in.
+	environment_t & env,
+	//! Value for creating names of data sources for
+	//! run-time monitoring.
+	const std::string_view data_sources_name_base )
+	{
+		return make_dispatcher( env, data_sources_name_base, disp_params_t{} );
+	}
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of %edf_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+inline dispatcher_handle_t
+make_dispatcher( environment_t & env )
+	{
+		return make_dispatcher( env, std::string_view{} );
+	}
+
+} /* namespace edf_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
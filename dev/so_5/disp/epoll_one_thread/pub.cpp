@@ -0,0 +1,701 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Functions for creating and binding of the single thread dispatcher
+ * that waits for I/O readiness of file descriptors.
+ *
+ * \since v.5.8.5
+ */
+
+#include <so_5/disp/epoll_one_thread/pub.hpp>
+
+#include <so_5/environment.hpp>
+#include <so_5/send_functions.hpp>
+#include <so_5/ret_code.hpp>
+
+#include <so_5/stats/repository.hpp>
+#include <so_5/stats/messages.hpp>
+#include <so_5/stats/std_names.hpp>
+
+#include <so_5/stats/impl/activity_tracking.hpp>
+
+#include <so_5/disp/reuse/work_thread/work_thread.hpp>
+
+#include <so_5/disp/reuse/actual_work_thread_factory_to_use.hpp>
+#include <so_5/disp/reuse/data_source_prefix_helpers.hpp>
+
+#include <so_5/details/invoke_noexcept_code.hpp>
+#include <so_5/details/rollback_on_exception.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+	#include <sys/epoll.h>
+	#include <sys/eventfd.h>
+	#include <unistd.h>
+#endif
+
+namespace so_5
+{
+
+namespace disp
+{
+
+namespace epoll_one_thread
+{
+
+namespace impl
+{
+
+#if defined(__linux__)
+
+namespace work_thread = so_5::disp::reuse::work_thread;
+namespace queue_traits = so_5::disp::mpsc_queue_traits;
+namespace stats = so_5::stats;
+
+void
+throw_errno( const char * what, int error_code )
+	{
+		SO_5_THROW_EXCEPTION( rc_io_readiness_notification_failure,
+				std::string{ what } + " failed: " +
+				std::strerror( error_code ) );
+	}
+
+//
+// io_poller_t
+//
+/*!
+ * \brief A holder of epoll and eventfd descriptors and of the
+ * registry of watched descriptors.
+ *
+ * \since v.5.8.5
+ */
+class io_poller_t final
+	{
+	public :
+		io_poller_t( outliving_reference_t< environment_t > env )
+			:	m_env{ env }
+			{
+				m_epoll_fd = ::epoll_create1( EPOLL_CLOEXEC );
+				if( -1 == m_epoll_fd )
+					throw_errno( "epoll_create1", errno );
+
+				m_event_fd = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+				if( -1 == m_event_fd )
+					{
+						const auto error_code = errno;
+						::close( m_epoll_fd );
+						throw_errno( "eventfd", error_code );
+					}
+
+				epoll_event ev{};
+				ev.events = EPOLLIN;
+				ev.data.fd = m_event_fd;
+				if( -1 == ::epoll_ctl( m_epoll_fd, EPOLL_CTL_ADD, m_event_fd, &ev ) )
+					{
+						const auto error_code = errno;
+						::close( m_event_fd );
+						::close( m_epoll_fd );
+						throw_errno( "epoll_ctl", error_code );
+					}
+			}
+
+		io_poller_t( const io_poller_t & ) = delete;
+		io_poller_t & operator=( const io_poller_t & ) = delete;
+
+		~io_poller_t() noexcept
+			{
+				::close( m_event_fd );
+				::close( m_epoll_fd );
+			}
+
+		void
+		add_fd( int fd, std::uint32_t events, mbox_t dest )
+			{
+				std::lock_guard< std::mutex > lock{ m_registry_lock };
+
+				if( m_registry.count( fd ) )
+					SO_5_THROW_EXCEPTION( rc_io_readiness_notification_failure,
+							"file descriptor is already registered: " +
+							std::to_string( fd ) );
+
+				auto it = m_registry.emplace( fd, std::move(dest) ).first;
+
+				epoll_event ev{};
+				ev.events = events;
+				ev.data.fd = fd;
+				if( -1 == ::epoll_ctl( m_epoll_fd, EPOLL_CTL_ADD, fd, &ev ) )
+					{
+						const auto error_code = errno;
+						m_registry.erase( it );
+						throw_errno( "epoll_ctl(EPOLL_CTL_ADD)", error_code );
+					}
+			}
+
+		void
+		modify_fd( int fd, std::uint32_t events )
+			{
+				std::lock_guard< std::mutex > lock{ m_registry_lock };
+
+				if( !m_registry.count( fd ) )
+					SO_5_THROW_EXCEPTION( rc_io_readiness_notification_failure,
+							"file descriptor isn't registered: " +
+							std::to_string( fd ) );
+
+				epoll_event ev{};
+				ev.events = events;
+				ev.data.fd = fd;
+				if( -1 == ::epoll_ctl( m_epoll_fd, EPOLL_CTL_MOD, fd, &ev ) )
+					throw_errno( "epoll_ctl(EPOLL_CTL_MOD)", errno );
+			}
+
+		void
+		remove_fd( int fd ) noexcept
+			{
+				std::lock_guard< std::mutex > lock{ m_registry_lock };
+
+				if( m_registry.erase( fd ) )
+					// An error is ignored because the descriptor could
+					// already be closed.
+					(void)::epoll_ctl( m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr );
+			}
+
+		//! Wake up the thread sleeping in poll().
+		void
+		wakeup() noexcept
+			{
+				const std::uint64_t v = 1u;
+				// EAGAIN means that the counter is already non-zero.
+				(void)::write( m_event_fd, &v, sizeof(v) );
+			}
+
+		//! Wait for readiness and send notifications.
+		/*!
+		 * \note
+		 * The value -1 of \a timeout_ms means infinite waiting.
+		 */
+		void
+		poll( int timeout_ms ) noexcept
+			{
+				constexpr int max_events = 64;
+				epoll_event events[ max_events ];
+
+				const int count = ::epoll_wait(
+						m_epoll_fd, events, max_events, timeout_ms );
+				for( int i = 0; i < count; ++i )
+					{
+						const int fd = events[ i ].data.fd;
+						if( m_event_fd == fd )
+							{
+								std::uint64_t v;
+								(void)::read( m_event_fd, &v, sizeof(v) );
+							}
+						else
+							notify( fd, events[ i ].events );
+					}
+			}
+
+	private :
+		//! SObjectizer Environment to work in.
+		/*!
+		 * It's necessary for logging errors.
+		 */
+		outliving_reference_t< environment_t > m_env;
+
+		int m_epoll_fd;
+		int m_event_fd;
+
+		//! Lock for the registry.
+		std::mutex m_registry_lock;
+
+		//! Registered descriptors and destinations for notifications.
+		std::map< int, mbox_t > m_registry;
+
+		void
+		notify( int fd, std::uint32_t events ) noexcept
+			{
+				mbox_t dest;
+				{
+					std::lock_guard< std::mutex > lock{ m_registry_lock };
+					auto it = m_registry.find( fd );
+					if( it == m_registry.end() )
+						// Descriptor has been removed already.
+						return;
+					dest = it->second;
+				}
+
+				try
+					{
+						so_5::send< msg_fd_ready >( dest, fd, events );
+					}
+				catch( const std::exception & x )
+					{
+						so_5::details::invoke_noexcept_code( [&] {
+								SO_5_LOG_ERROR( m_env.get().error_logger(), stream ) {
+									stream << "unable to send msg_fd_ready for "
+											"file descriptor " << fd << ": " << x.what();
+								}
+							} );
+					}
+			}
+	};
+
+//
+// epoll_lock_t
+//
+/*!
+ * \brief A lock for the demand queue that waits in epoll_wait().
+ *
+ * The work thread sleeps in epoll_wait() when the demand queue is
+ * empty. A push of a new demand wakes the work thread up via eventfd.
+ *
+ * When the demand queue isn't empty the work thread checks descriptors
+ * without blocking every time it acquires the lock (but not more
+ * often than once per io_check_period). The ID of the work thread is
+ * passed to the lock by a special demand at the start of the dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class epoll_lock_t final : public queue_traits::lock_t
+	{
+	public :
+		epoll_lock_t(
+			io_poller_t & poller,
+			std::chrono::steady_clock::duration io_check_period )
+			:	m_poller{ poller }
+			,	m_io_check_period{ io_check_period }
+			{}
+
+		void
+		lock() noexcept override
+			{
+				m_mutex.lock();
+
+				// m_worker_id is modified only under the lock.
+				if( !m_polling && so_5::query_current_thread_id() == m_worker_id )
+					{
+						const auto now = std::chrono::steady_clock::now();
+						if( now - m_last_check >= m_io_check_period )
+							{
+								m_last_check = now;
+
+								m_polling = true;
+								m_mutex.unlock();
+
+								m_poller.poll( 0 );
+
+								m_mutex.lock();
+								m_polling = false;
+							}
+					}
+			}
+
+		void
+		unlock() noexcept override
+			{
+				m_mutex.unlock();
+			}
+
+		//! Set the ID of the work thread.
+		/*!
+		 * \attention
+		 * Must be called by the work thread when the lock isn't acquired.
+		 */
+		void
+		set_worker_id( current_thread_id_t id ) noexcept
+			{
+				std::lock_guard< std::mutex > lock{ m_mutex };
+				m_worker_id = id;
+			}
+
+	protected :
+		void
+		wait_for_notify() noexcept override
+			{
+				while( !m_signaled )
+					{
+						m_waiting = true;
+						m_polling = true;
+						m_mutex.unlock();
+
+						m_poller.poll( -1 );
+
+						m_mutex.lock();
+						m_polling = false;
+						m_waiting = false;
+					}
+
+				m_signaled = false;
+				m_last_check = std::chrono::steady_clock::now();
+			}
+
+		void
+		notify_one() noexcept override
+			{
+				m_signaled = true;
+
+				// There is no need to wake up the work thread if it
+				// pushes a demand by itself.
+				if( m_waiting && so_5::query_current_thread_id() != m_worker_id )
+					m_poller.wakeup();
+			}
+
+	private :
+		io_poller_t & m_poller;
+
+		const std::chrono::steady_clock::duration m_io_check_period;
+
+		std::mutex m_mutex;
+
+		bool m_signaled{ false };
+
+		//! Is the work thread sleeping in epoll_wait()?
+		bool m_waiting{ false };
+
+		//! ID of the work thread.
+		/*!
+		 * It's unknown until the handling of the demand sent by
+		 * the dispatcher at the start.
+		 */
+		current_thread_id_t m_worker_id;
+
+		/*!
+		 * \name Data that is used only by the work thread.
+		 * \{
+		 */
+		bool m_polling{ false };
+		std::chrono::steady_clock::time_point m_last_check{};
+		/*!
+		 * \}
+		 */
+	};
+
+//
+// worker_id_setter_t
+//
+/*!
+ * \brief A message for the demand that passes the ID of the work
+ * thread to epoll_lock_t.
+ *
+ * \since v.5.8.5
+ */
+struct worker_id_setter_t final : public message_t
+	{
+		epoll_lock_t & m_lock;
+
+		worker_id_setter_t( epoll_lock_t & lock ) noexcept
+			:	m_lock{ lock }
+			{}
+
+		static void
+		demand_handler(
+			current_thread_id_t thread_id,
+			execution_demand_t & demand )
+			{
+				static_cast< worker_id_setter_t & >( *(demand.m_message_ref) )
+						.m_lock.set_worker_id( thread_id );
+			}
+	};
+
+//
+// actual_dispatcher_iface_t
+//
+/*!
+ * \brief An interface of the dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class actual_dispatcher_iface_t
+	:	public disp_binder_t
+	,	public fd_registry_t
+	{};
+
+/*!
+ * \brief Data source for epoll_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+template< typename Work_Thread >
+class data_source_t final : public stats::source_t
+	{
+	public :
+		data_source_t(
+			Work_Thread & work_thread,
+			std::atomic< std::size_t > & agents_bound,
+			const std::string_view name_base,
+			const void * pointer_to_disp )
+			:	m_work_thread{ work_thread }
+			,	m_agents_bound{ agents_bound }
+			{
+				using namespace so_5::disp::reuse;
+
+				m_base_prefix = make_disp_prefix(
+						"epoll-ot",
+						name_base,
+						pointer_to_disp );
+
+				m_work_thread_prefix = make_disp_working_thread_prefix(
+						m_base_prefix,
+						0 );
+			}
+
+		void
+		distribute( const mbox_t & mbox ) override
+			{
+				so_5::send< stats::messages::quantity< std::size_t > >(
+						mbox,
+						m_base_prefix,
+						stats::suffixes::agent_count(),
+						m_agents_bound.load( std::memory_order_acquire ) );
+
+				so_5::send< stats::messages::quantity< std::size_t > >(
+						mbox,
+						m_work_thread_prefix,
+						stats::suffixes::work_thread_queue_size(),
+						m_work_thread.demands_count() );
+
+				track_activity( mbox, m_work_thread );
+			}
+
+	private :
+		//! Prefix for dispatcher-related data.
+		stats::prefix_t m_base_prefix;
+		//! Prefix for working thread-related data.
+		stats::prefix_t m_work_thread_prefix;
+
+		//! Working thread of the dispatcher.
+		Work_Thread & m_work_thread;
+
+		//! Count of agents bound to the dispatcher.
+		std::atomic< std::size_t > & m_agents_bound;
+
+		void
+		track_activity(
+			const mbox_t &,
+			work_thread::work_thread_no_activity_tracking_t & )
+			{}
+
+		void
+		track_activity(
+			const mbox_t & mbox,
+			work_thread::work_thread_with_activity_tracking_t & wt )
+			{
+				so_5::send< stats::messages::work_thread_activity >(
+						mbox,
+						m_base_prefix,
+						stats::suffixes::work_thread_activity(),
+						wt.thread_id(),
+						wt.take_activity_stats() );
+			}
+	};
+
+//
+// actual_dispatcher_t
+//
+/*!
+ * \brief A dispatcher with the single working thread that waits
+ * in epoll_wait().
+ *
+ * \since v.5.8.5
+ */
+template< typename Work_Thread >
+class actual_dispatcher_t final : public actual_dispatcher_iface_t
+	{
+	public:
+		actual_dispatcher_t(
+			outliving_reference_t< environment_t > env,
+			const std::string_view name_base,
+			disp_params_t params )
+			:	m_poller{ env }
+			,	m_work_thread{
+					so_5::disp::reuse::acquire_work_thread( params, env.get() ),
+					[this, period = params.io_check_period()] {
+						auto lock = std::make_unique< epoll_lock_t >(
+								m_poller, period );
+						m_lock = lock.get();
+						return queue_traits::lock_unique_ptr_t{ std::move(lock) };
+					} }
+			,	m_data_source{
+					outliving_mutable(env.get().stats_repository()),
+					m_work_thread,
+					m_agents_bound,
+					name_base,
+					this }
+			{
+				m_work_thread.start();
+
+				so_5::details::do_with_rollback_on_exception(
+					[this] {
+						// It has to be the first demand for the work thread.
+						m_work_thread.event_queue().push( execution_demand_t{
+								nullptr,
+								nullptr,
+								0u,
+								typeid(worker_id_setter_t),
+								message_ref_t{ new worker_id_setter_t{ *m_lock } },
+								&worker_id_setter_t::demand_handler
+							} );
+					},
+					[this] {
+						m_work_thread.shutdown();
+						m_work_thread.wait();
+					} );
+			}
+
+		~actual_dispatcher_t() noexcept override
+			{
+				m_work_thread.shutdown();
+				m_work_thread.wait();
+			}
+
+		void
+		preallocate_resources(
+			agent_t & /*agent*/ ) override
+			{
+				// Nothing to do.
+			}
+
+		void
+		undo_preallocation(
+			agent_t & /*agent*/ ) noexcept override
+			{
+				// Nothing to do.
+			}
+
+		void
+		bind(
+			agent_t & agent ) noexcept override
+			{
+				agent.so_bind_to_dispatcher( *(m_work_thread.get_agent_binding()) );
+				++m_agents_bound;
+			}
+
+		void
+		unbind(
+			agent_t & /*agent*/ ) noexcept override
+			{
+				--m_agents_bound;
+			}
+
+		void
+		add_fd(
+			int fd,
+			std::uint32_t events,
+			mbox_t dest ) override
+			{
+				m_poller.add_fd( fd, events, std::move(dest) );
+			}
+
+		void
+		modify_fd(
+			int fd,
+			std::uint32_t events ) override
+			{
+				m_poller.modify_fd( fd, events );
+			}
+
+		void
+		remove_fd( int fd ) noexcept override
+			{
+				m_poller.remove_fd( fd );
+			}
+
+	private:
+		//! Epoll and registry of descriptors.
+		/*!
+		 * \attention
+		 * It must be created before and destroyed after the work thread.
+		 */
+		io_poller_t m_poller;
+
+		//! Lock for the demand queue.
+		/*!
+		 * It's created and owned by the work thread.
+		 */
+		epoll_lock_t * m_lock{};
+
+		//! Working thread for the dispatcher.
+		Work_Thread m_work_thread;
+
+		//! Count of agents bound to this dispatcher.
+		std::atomic< std::size_t > m_agents_bound = { 0 };
+
+		//! Data source for run-time monitoring.
+		stats::auto_registered_source_holder_t< data_source_t< Work_Thread > >
+				m_data_source;
+	};
+
+#endif
+
+//
+// dispatcher_handle_maker_t
+//
+class dispatcher_handle_maker_t
+	{
+	public :
+		static dispatcher_handle_t
+		make(
+			disp_binder_shptr_t binder,
+			fd_registry_shptr_t fd_registry ) noexcept
+			{
+				return { std::move( binder ), std::move( fd_registry ) };
+			}
+	};
+
+} /* namespace impl */
+
+//
+// make_dispatcher
+//
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	environment_t & env,
+	const std::string_view data_sources_name_base,
+	disp_params_t params )
+	{
+#if defined(__linux__)
+		using namespace so_5::disp::reuse;
+
+		using dispatcher_no_activity_tracking_t =
+				impl::actual_dispatcher_t<
+						work_thread::work_thread_no_activity_tracking_t >;
+
+		using dispatcher_with_activity_tracking_t =
+				impl::actual_dispatcher_t<
+						work_thread::work_thread_with_activity_tracking_t >;
+
+		using so_5::stats::activity_tracking_stuff::create_appropriate_disp;
+		std::shared_ptr< impl::actual_dispatcher_iface_t > disp =
+				create_appropriate_disp<
+						impl::actual_dispatcher_iface_t,
+						dispatcher_no_activity_tracking_t,
+						dispatcher_with_activity_tracking_t >(
+					outliving_mutable(env),
+					data_sources_name_base,
+					std::move(params) );
+
+		return impl::dispatcher_handle_maker_t::make( disp, disp );
+#else
+		(void)env;
+		(void)data_sources_name_base;
+		(void)params;
+		SO_5_THROW_EXCEPTION( rc_not_implemented,
+				"so_5::disp::epoll_one_thread dispatcher isn't "
+				"supported on this platform" );
+#endif
+	}
+
+} /* namespace epoll_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
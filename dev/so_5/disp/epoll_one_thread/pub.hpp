@@ -0,0 +1,389 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Functions for creating and binding of the single thread dispatcher
+ * that waits for I/O readiness of file descriptors.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/declspec.hpp>
+
+#include <so_5/disp_binder.hpp>
+#include <so_5/mbox.hpp>
+#include <so_5/message.hpp>
+
+#include <so_5/disp/reuse/work_thread_activity_tracking.hpp>
+#include <so_5/disp/reuse/work_thread_factory_params.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace epoll_one_thread {
+
+//
+// msg_fd_ready
+//
+/*!
+ * \brief Notification about readiness of a file descriptor.
+ *
+ * \since v.5.8.5
+ */
+struct msg_fd_ready final : public so_5::message_t
+	{
+		//! The file descriptor.
+		int m_fd;
+
+		//! Events reported by epoll (like EPOLLIN, EPOLLOUT, EPOLLHUP).
+		std::uint32_t m_events;
+
+		msg_fd_ready( int fd, std::uint32_t events ) noexcept
+			:	m_fd{ fd }
+			,	m_events{ events }
+			{}
+	};
+
+//
+// fd_registry_t
+//
+/*!
+ * \brief An interface for registration of file descriptors in
+ * the dispatcher.
+ *
+ * Events are specified by epoll's flags (EPOLLIN, EPOLLOUT, EPOLLET,
+ * EPOLLONESHOT and so on). Every readiness reported by epoll is sent
+ * as msg_fd_ready to the mbox specified at the registration.
+ *
+ * \note
+ * The readiness is checked when the work thread of the dispatcher sleeps
+ * and periodically when the work thread handles demands (see
+ * disp_params_t::io_check_period()). Because msg_fd_ready is handled
+ * asynchronously the usage of EPOLLONESHOT is recommended: a descriptor
+ * is reactivated by modify_fd() after handling of msg_fd_ready. Without
+ * EPOLLONESHOT or EPOLLET a descriptor in level-triggered mode can produce
+ * several msg_fd_ready before the first of them is handled.
+ *
+ * \attention
+ * A descriptor has to be removed from the registry before closing it.
+ *
+ * All methods are thread safe.
+ *
+ * \since v.5.8.5
+ */
+class SO_5_TYPE fd_registry_t
+	{
+	public :
+		fd_registry_t() = default;
+		fd_registry_t( const fd_registry_t & ) = delete;
+		fd_registry_t & operator=( const fd_registry_t & ) = delete;
+		virtual ~fd_registry_t() noexcept = default;
+
+		//! Start watching for a file descriptor.
+		/*!
+		 * \throw so_5::exception_t if \a fd is already registered or
+		 * if epoll_ctl fails.
+		 */
+		virtual void
+		add_fd(
+			//! File descriptor to watch for.
+			int fd,
+			//! Events to watch for.
+			std::uint32_t events,
+			//! Destination for msg_fd_ready.
+			mbox_t dest ) = 0;
+
+		//! Change events for an already registered file descriptor.
+		/*!
+		 * It's also used for reactivation of a descriptor registered
+		 * with EPOLLONESHOT.
+		 *
+		 * \throw so_5::exception_t if \a fd isn't registered or
+		 * if epoll_ctl fails.
+		 */
+		virtual void
+		modify_fd(
+			int fd,
+			std::uint32_t events ) = 0;
+
+		//! Stop watching for a file descriptor.
+		/*!
+		 * Does nothing if \a fd isn't registered.
+		 *
+		 * \note
+		 * A msg_fd_ready for \a fd can still be in the event queue of
+		 * the receiver after the return from that method.
+		 */
+		virtual void
+		remove_fd( int fd ) noexcept = 0;
+	};
+
+//
+// fd_registry_shptr_t
+//
+/*!
+ * \brief An alias for shared_ptr to fd_registry.
+ *
+ * \since v.5.8.5
+ */
+using fd_registry_shptr_t = std::shared_ptr< fd_registry_t >;
+
+//
+// default_io_check_period
+//
+/*!
+ * \brief Default period of checking descriptors when the demand
+ * queue isn't empty.
+ *
+ * \since v.5.8.5
+ */
+inline constexpr std::chrono::steady_clock::duration default_io_check_period =
+		std::chrono::milliseconds{ 1 };
+
+//
+// disp_params_t
+//
+/*!
+ * \brief Parameters for a dispatcher.
+ *
+ * \note
+ * There are no queue parameters: the dispatcher uses its own lock for
+ * the demand queue.
+ *
+ * \since v.5.8.5
+ */
+class disp_params_t
+	:	public so_5::disp::reuse::work_thread_activity_tracking_flag_mixin_t< disp_params_t >
+	,	public so_5::disp::reuse::work_thread_factory_mixin_t< disp_params_t >
+	{
+		using activity_tracking_mixin_t = so_5::disp::reuse::
+				work_thread_activity_tracking_flag_mixin_t< disp_params_t >;
+		using thread_factory_mixin_t = so_5::disp::reuse::
+				work_thread_factory_mixin_t< disp_params_t >;
+
+	public :
+		//! Default constructor.
+		disp_params_t() = default;
+
+		friend inline void
+		swap( disp_params_t & a, disp_params_t & b ) noexcept
+			{
+				swap(
+						static_cast< activity_tracking_mixin_t & >(a),
+						static_cast< activity_tracking_mixin_t & >(b) );
+
+				swap(
+						static_cast< work_thread_factory_mixin_t & >(a),
+						static_cast< work_thread_factory_mixin_t & >(b) );
+
+				std::swap( a.m_io_check_period, b.m_io_check_period );
+			}
+
+		//! Setter for the period of checking descriptors when
+		//! the demand queue isn't empty.
+		/*!
+		 * The work thread doesn't sleep while there are demands in the
+		 * queue. The readiness of descriptors is checked (without
+		 * blocking) not more often than once per this period to avoid
+		 * starvation of I/O under a high load. A zero value means
+		 * checking at every access to the demand queue from the
+		 * work thread.
+		 */
+		disp_params_t &
+		io_check_period( std::chrono::steady_clock::duration v ) noexcept
+			{
+				m_io_check_period = v;
+				return *this;
+			}
+
+		//! Getter for the period of checking descriptors.
+		[[nodiscard]]
+		std::chrono::steady_clock::duration
+		io_check_period() const noexcept
+			{
+				return m_io_check_period;
+			}
+
+	private :
+		//! Period of checking descriptors when the queue isn't empty.
+		std::chrono::steady_clock::duration m_io_check_period{
+				default_io_check_period };
+	};
+
+namespace impl
+{
+
+class dispatcher_handle_maker_t;
+
+} /* namespace impl */
+
+//
+// dispatcher_handle_t
+//
+
+/*!
+ * \brief A handle for %epoll_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class [[nodiscard]] dispatcher_handle_t
+	{
+		friend class impl::dispatcher_handle_maker_t;
+
+		//! Binder for the dispatcher.
+		disp_binder_shptr_t m_binder;
+
+		//! Registry of file descriptors of the dispatcher.
+		fd_registry_shptr_t m_fd_registry;
+
+		dispatcher_handle_t(
+			disp_binder_shptr_t binder,
+			fd_registry_shptr_t fd_registry ) noexcept
+			:	m_binder{ std::move(binder) }
+			,	m_fd_registry{ std::move(fd_registry) }
+			{}
+
+		//! Is this handle empty?
+		bool
+		empty() const noexcept { return !m_binder; }
+
+	public :
+		dispatcher_handle_t() noexcept = default;
+
+		//! Get a binder for that dispatcher.
+		[[nodiscard]]
+		disp_binder_shptr_t
+		binder() const noexcept
+			{
+				return m_binder;
+			}
+
+		//! Get the registry of file descriptors for that dispatcher.
+		/*!
+		 * \note
+		 * The registry holds the dispatcher alive.
+		 */
+		[[nodiscard]]
+		fd_registry_shptr_t
+		fd_registry() const noexcept
+			{
+				return m_fd_registry;
+			}
+
+		//! Is this handle empty?
+		operator bool() const noexcept { return empty(); }
+
+		//! Does this handle contain a reference to dispatcher?
+		bool
+		operator!() const noexcept { return !empty(); }
+
+		//! Drop the content of handle.
+		void
+		reset() noexcept
+			{
+				m_binder.reset();
+				m_fd_registry.reset();
+			}
+	};
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of %epoll_one_thread dispatcher.
+ *
+ * The dispatcher has one work thread, like one_thread dispatcher. But
+ * the work thread sleeps in epoll_wait() instead of a condition variable.
+ * It allows to handle notifications about readiness of file descriptors
+ * on the same thread as all other events of agents bound to the
+ * dispatcher, without an additional I/O thread.
+ *
+ * \par Usage sample
+\code
+namespace epoll_disp = so_5::disp::epoll_one_thread;
+
+class reader_t final : public so_5::agent_t {
+	epoll_disp::fd_registry_shptr_t m_registry;
+	int m_fd;
+	...
+	void so_evt_start() override {
+		m_registry->add_fd( m_fd, EPOLLIN | EPOLLONESHOT, so_direct_mbox() );
+	}
+	void so_evt_finish() override {
+		m_registry->remove_fd( m_fd );
+	}
+	void evt_ready( mhood_t< epoll_disp::msg_fd_ready > cmd ) {
+		... // Read the data.
+		m_registry->modify_fd( m_fd, EPOLLIN | EPOLLONESHOT );
+	}
+};
+...
+auto disp = epoll_disp::make_dispatcher( env, "gateway" );
+env.introduce_coop( disp.binder(), [&]( so_5::coop_t & coop ) {
+	coop.make_agent< reader_t >( disp.fd_registry(), fd );
+} );
+\endcode
+ *
+ * \note
+ * Only Linux is supported now. An exception is thrown on other platforms.
+ *
+ * \since v.5.8.5
+ */
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	//! SObjectizer Environment to work in.
+	environment_t & env,
+	//! Value for creating names of data sources for
+	//! run-time monitoring.
+	const std::string_view data_sources_name_base,
+	//! Parameters for the dispatcher.
+	disp_params_t params );
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of %epoll_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+inline dispatcher_handle_t
+make_dispatcher(
+	//! SObjectizer Environment to work in.
+	environment_t & env,
+	//! Value for creating names of data sources for
+	//! run-time monitoring.
+	const std::string_view data_sources_name_base )
+	{
+		return make_dispatcher( env, data_sources_name_base, disp_params_t{} );
+	}
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of %epoll_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+inline dispatcher_handle_t
+make_dispatcher( environment_t & env )
+	{
+		return make_dispatcher( env, std::string_view{} );
+	}
+
+} /* namespace epoll_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
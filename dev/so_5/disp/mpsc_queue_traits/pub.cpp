@@ -29,7 +29,7 @@ namespace mpsc_queue_traits {
 namespace impl {
 
 //
-// combined_lock_t
+// combined_lock_template_t
 //
 /*!
  * \since
@@ -43,12 +43,19 @@ namespace impl {
  * \attention This lock can be used only for single-consumer queues!
  * It is because there is no way found to implement notify_all on
  * just two int variables (m_waiting and m_signaled). 
+ *
+ * \note
+ * It's a template since v.5.8.5.
+ *
+ * \tparam Backoff type of action performed between checks of the
+ * m_signaled flag while waiting on spinlock.
  */
-class combined_lock_t : public lock_t
+template< typename Backoff >
+class combined_lock_template_t : public lock_t
 	{
 	public :
 		inline
-		combined_lock_t(
+		combined_lock_template_t(
 			//! Max waiting time for waiting on spinlock before switching to mutex.
 			std::chrono::high_resolution_clock::duration waiting_time )
 			:	m_waiting_time{ waiting_time }
@@ -75,13 +82,18 @@ class combined_lock_t : public lock_t
 				using clock = std::chrono::high_resolution_clock;
 
 				m_waiting = true;
-				auto stop_point = clock::now() + m_waiting_time;
+				// Max value of waiting time means infinite busy waiting.
+				const bool infinite =
+						clock::duration::max() == m_waiting_time;
+				auto stop_point = infinite ?
+						clock::time_point::max() : clock::now() + m_waiting_time;
 
+				Backoff backoff;
 				do
 					{
 						m_spinlock.unlock();
 
-						std::this_thread::yield();
+						backoff();
 
 						m_spinlock.lock();
 
@@ -92,7 +104,7 @@ class combined_lock_t : public lock_t
 								return;
 							}
 					}
-				while( stop_point > clock::now() );
+				while( infinite || stop_point > clock::now() );
 
 				// m_lock is locked now.
 
@@ -142,6 +154,21 @@ class combined_lock_t : public lock_t
 		bool m_signaled;
 	};
 
+//
+// combined_lock_t
+//
+using combined_lock_t = combined_lock_template_t< yield_backoff_t >;
+
+//
+// busy_poll_lock_t
+//
+/*!
+ * \brief Lock for busy polling of the queue.
+ *
+ * \since v.5.8.5
+ */
+using busy_poll_lock_t = combined_lock_template_t< pause_backoff_t >;
+
 //
 // simple_lock_t
 //
@@ -210,6 +237,25 @@ combined_lock_factory(
 		};
 	}
 
+//
+// busy_poll_lock_factory
+//
+SO_5_FUNC lock_factory_t
+busy_poll_lock_factory()
+	{
+		return busy_poll_lock_factory(
+				std::chrono::high_resolution_clock::duration::max() );
+	}
+
+SO_5_FUNC lock_factory_t
+busy_poll_lock_factory(
+	std::chrono::high_resolution_clock::duration idle_period )
+	{
+		return [idle_period] {
+			return lock_unique_ptr_t{ new impl::busy_poll_lock_t{ idle_period } };
+		};
+	}
+
 //
 // simple_lock_factory
 //
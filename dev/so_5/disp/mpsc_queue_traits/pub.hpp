@@ -162,6 +162,66 @@ combined_lock_factory()
 SO_5_FUNC lock_factory_t
 simple_lock_factory();
 
+/*!
+ * \brief Factory for creation of queue lock for busy polling.
+ *
+ * A consumer thread never goes to sleep on the condition variable
+ * while waiting for new events. It polls the queue with `pause`
+ * instruction between attempts (instead of `yield` used by the combined
+ * lock). It allows to reduce latency of event dispatching, but the
+ * consumer thread consumes the whole CPU core all the time.
+ *
+ * It's supposed to be used with one_thread-like dispatchers whose
+ * work threads are pinned to dedicated CPU cores.
+ *
+ * \par Usage example:
+	\code
+	auto latency_disp = so_5::disp::one_thread::make_dispatcher(
+		env,
+		"order_router",
+		so_5::disp::one_thread::disp_params_t{}
+			.tune_queue_params(
+				[]( so_5::disp::one_thread::queue_traits::queue_params_t & p ) {
+					p.lock_factory( so_5::disp::one_thread::queue_traits::busy_poll_lock_factory() );
+				} )
+			.work_thread_factory(
+				so_5::disp::affinity::make_work_thread_factory(
+					so_5::disp::affinity::params_t{}.cpus( "3" ) ) ) );
+	\endcode
+ *
+ * \since v.5.8.5
+ */
+SO_5_FUNC lock_factory_t
+busy_poll_lock_factory();
+
+/*!
+ * \brief Factory for creation of queue lock for busy polling with
+ * backoff after an idle period.
+ *
+ * A consumer thread polls the queue like in busy_poll_lock_factory(),
+ * but goes to sleep on the condition variable if there are no new
+ * events during \a idle_period.
+ *
+ * \par Usage example:
+	\code
+	auto latency_disp = so_5::disp::one_thread::make_dispatcher(
+		env,
+		"order_router",
+		so_5::disp::one_thread::disp_params_t{}.tune_queue_params(
+			[]( so_5::disp::one_thread::queue_traits::queue_params_t & p ) {
+				p.lock_factory( so_5::disp::one_thread::queue_traits::busy_poll_lock_factory(
+					// Go to sleep after 10ms without events.
+					std::chrono::milliseconds{10} ) );
+			} ) );
+	\endcode
+ *
+ * \since v.5.8.5
+ */
+SO_5_FUNC lock_factory_t
+busy_poll_lock_factory(
+	//! Max time of busy polling before switching to mutex.
+	std::chrono::high_resolution_clock::duration idle_period );
+
 //
 // unique_lock_t
 //
@@ -0,0 +1,638 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Public interface of thread pool dispatcher that
+ * takes agent priorities into account.
+ *
+ * \since v.5.8.5
+ */
+
+#include <so_5/disp/prio_thread_pool/pub.hpp>
+
+#include <so_5/disp/thread_pool/impl/work_thread_template.hpp>
+#include <so_5/disp/thread_pool/impl/basic_event_queue.hpp>
+
+#include <so_5/disp/reuse/make_actual_dispatcher.hpp>
+
+#include <so_5/ret_code.hpp>
+
+#include <so_5/disp_binder.hpp>
+#include <so_5/environment.hpp>
+
+namespace so_5
+{
+
+namespace disp
+{
+
+namespace prio_thread_pool
+{
+
+namespace impl
+{
+
+using so_5::disp::thread_pool::impl::work_thread_no_activity_tracking_t;
+using so_5::disp::thread_pool::impl::work_thread_with_activity_tracking_t;
+
+class agent_queue_t;
+
+//
+// actual_bind_params_t
+//
+/*!
+ * \brief Parameters for binding an agent with the priority of the agent.
+ *
+ * \since v.5.8.5
+ */
+struct actual_bind_params_t
+	{
+		//! Parameters specified by a user.
+		bind_params_t m_params;
+
+		//! Priority of the agent.
+		priority_t m_priority;
+	};
+
+//
+// prio_storage_t
+//
+/*!
+ * \brief Storage of non-empty agent queues with respect to priorities.
+ *
+ * There is a separate FIFO for every priority.
+ *
+ * If quotes aren't set then an agent queue with the highest priority
+ * is always taken first.
+ *
+ * If quotes are set then priorities are handled in the round-robin
+ * manner from the highest to the lowest one: up to quote agent queues
+ * are taken for the current priority and then the next priority with
+ * non-empty FIFO is selected.
+ *
+ * \note
+ * This class is used under the lock of so_5::disp::reuse::queue_of_queues_t.
+ *
+ * \since v.5.8.5
+ */
+class prio_storage_t
+	{
+		//! Type of FIFO for one priority.
+		using fifo_t = so_5::disp::reuse::intrusive_fifo_t< agent_queue_t >;
+
+	public :
+		//! Set quotes for priorities.
+		/*!
+		 * \attention
+		 * Must be called before the start of work threads.
+		 */
+		void
+		set_quotes( const quotes_t & quotes )
+			{
+				m_quotes = quotes;
+			}
+
+		[[nodiscard]]
+		bool
+		empty() const noexcept { return 0u == m_size; }
+
+		[[nodiscard]]
+		std::size_t
+		size() const noexcept { return m_size; }
+
+		[[nodiscard]]
+		bool
+		should_switch_from( const agent_queue_t & current ) const noexcept;
+
+		[[nodiscard]]
+		agent_queue_t *
+		pop() noexcept
+			{
+				const priority_t prio = m_quotes ?
+						select_priority_with_quotes() : highest_priority();
+
+				--m_size;
+				return fifo( prio ).pop();
+			}
+
+		void
+		push( agent_queue_t * queue ) noexcept;
+
+	private :
+		//! FIFOs for every priority.
+		fifo_t m_fifos[ so_5::prio::total_priorities_count ];
+
+		//! Total count of items in all FIFOs.
+		std::size_t m_size{};
+
+		//! Quotes for priorities.
+		/*!
+		 * Empty value means that quotes aren't used.
+		 */
+		so_5::optional< quotes_t > m_quotes;
+
+		//! Priority that is handled now.
+		/*!
+		 * \note
+		 * Used only if quotes are set.
+		 */
+		priority_t m_current_priority{ priority_t::p_max };
+
+		//! Count of agent queues taken for m_current_priority.
+		/*!
+		 * \note
+		 * Used only if quotes are set.
+		 */
+		std::size_t m_taken_for_current_priority{};
+
+		[[nodiscard]]
+		fifo_t &
+		fifo( priority_t priority ) noexcept
+			{
+				return m_fifos[ to_size_t( priority ) ];
+			}
+
+		[[nodiscard]]
+		const fifo_t &
+		fifo( priority_t priority ) const noexcept
+			{
+				return m_fifos[ to_size_t( priority ) ];
+			}
+
+		/*!
+		 * \brief Find the highest priority with non-empty FIFO.
+		 *
+		 * \attention
+		 * The storage mustn't be empty.
+		 */
+		[[nodiscard]]
+		priority_t
+		highest_priority() const noexcept
+			{
+				priority_t result = priority_t::p_max;
+				while( fifo( result ).empty() )
+					result = so_5::prio::prev( result );
+
+				return result;
+			}
+
+		/*!
+		 * \brief Select a priority with respect to quotes.
+		 *
+		 * \attention
+		 * The storage mustn't be empty.
+		 */
+		[[nodiscard]]
+		priority_t
+		select_priority_with_quotes() noexcept
+			{
+				if( fifo( m_current_priority ).empty() ||
+						m_taken_for_current_priority >=
+								m_quotes->query( m_current_priority ) )
+					{
+						// The next priority with non-empty FIFO has to be found.
+						// The lowest priority is followed by the highest one.
+						do
+							{
+								m_current_priority = so_5::prio::has_prev( m_current_priority ) ?
+										so_5::prio::prev( m_current_priority ) :
+										priority_t::p_max;
+							}
+						while( fifo( m_current_priority ).empty() );
+
+						m_taken_for_current_priority = 0u;
+					}
+
+				++m_taken_for_current_priority;
+
+				return m_current_priority;
+			}
+	};
+
+//
+// dispatcher_queue_t
+//
+using dispatcher_queue_t = so_5::disp::reuse::queue_of_queues_t<
+		agent_queue_t,
+		prio_storage_t >;
+
+//
+// agent_queue_t
+//
+/*!
+ * \brief Event queue for an agent with respect to the agent's priority.
+ *
+ * \since v.5.8.5
+ */
+class agent_queue_t final
+	:	public so_5::disp::thread_pool::impl::basic_event_queue_t
+	,	private so_5::atomic_refcounted_t
+	{
+		friend class so_5::intrusive_ptr_t< agent_queue_t >;
+
+		//! Short alias for the main base type.
+		using base_type_t = so_5::disp::thread_pool::impl::basic_event_queue_t;
+
+	public:
+		//! Initializing constructor.
+		agent_queue_t(
+			//! Dispatcher queue to work with.
+			outliving_reference_t< dispatcher_queue_t > disp_queue,
+			//! Parameters for the queue.
+			const actual_bind_params_t & params )
+			:	base_type_t{ params.m_params.query_max_demands_at_once() }
+			,	m_disp_queue{ disp_queue.get() }
+			,	m_priority{ params.m_priority }
+			{}
+
+		//! Priority of the agent.
+		[[nodiscard]]
+		priority_t
+		priority() const noexcept { return m_priority; }
+
+		/*!
+		 * \brief Give away a pointer to the next agent_queue.
+		 *
+		 * \note
+		 * This method is a part of interface required by
+		 * so_5::disp::reuse::intrusive_fifo_t.
+		 */
+		[[nodiscard]]
+		agent_queue_t *
+		intrusive_queue_giveout_next() noexcept
+			{
+				auto * r = m_intrusive_queue_next;
+				m_intrusive_queue_next = nullptr;
+				return r;
+			}
+
+		/*!
+		 * \brief Set a pointer to the next agent_queue.
+		 *
+		 * \note
+		 * This method is a part of interface required by
+		 * so_5::disp::reuse::intrusive_fifo_t.
+		 */
+		void
+		intrusive_queue_set_next( agent_queue_t * next ) noexcept
+			{
+				m_intrusive_queue_next = next;
+			}
+
+	protected:
+		void
+		schedule_on_disp_queue() noexcept override
+			{
+				m_disp_queue.schedule( this );
+			}
+
+	private :
+		//! Dispatcher queue with that the agent queue has to be used.
+		dispatcher_queue_t & m_disp_queue;
+
+		//! Priority of the agent.
+		const priority_t m_priority;
+
+		/*!
+		 * \brief The next item in intrusive queue of agent_queues.
+		 *
+		 * This field is necessary to implement interface required by
+		 * so_5::disp::reuse::intrusive_fifo_t.
+		 */
+		agent_queue_t * m_intrusive_queue_next{ nullptr };
+	};
+
+//
+// prio_storage_t implementation
+//
+bool
+prio_storage_t::should_switch_from(
+	const agent_queue_t & current ) const noexcept
+	{
+		if( empty() )
+			return false;
+
+		// In the round-robin mode the switch should be done as soon
+		// as possible.
+		if( m_quotes )
+			return true;
+
+		// There is no need to switch to an agent with lower priority.
+		return highest_priority() >= current.priority();
+	}
+
+void
+prio_storage_t::push( agent_queue_t * queue ) noexcept
+	{
+		fifo( queue->priority() ).push( queue );
+		++m_size;
+	}
+
+//
+// adaptation_t
+//
+/*!
+ * \brief Adaptation of common implementation of thread-pool-like dispatcher
+ * to the specific of this thread-pool dispatcher.
+ *
+ * \since v.5.8.5
+ */
+struct adaptation_t
+	{
+		[[nodiscard]]
+		static constexpr std::string_view
+		dispatcher_type_name() noexcept
+			{
+				return { "prio_tp" }; // prio_thread_pool.
+			}
+
+		[[nodiscard]]
+		static bool
+		is_individual_fifo( const actual_bind_params_t & /*params*/ ) noexcept
+			{
+				// NOTE: all agents use individual fifo.
+				return true;
+			}
+
+		static void
+		wait_for_queue_emptyness( agent_queue_t & queue ) noexcept
+			{
+				queue.wait_for_emptyness();
+			}
+	};
+
+//
+// dispatcher_template_t
+//
+/*!
+ * \brief Template for dispatcher.
+ *
+ * This template depends on work_thread type (with or without activity
+ * tracking).
+ *
+ * \since v.5.8.5
+ */
+template< typename Work_Thread >
+using dispatcher_template_t =
+		so_5::disp::thread_pool::common_implementation::dispatcher_t<
+				Work_Thread,
+				dispatcher_queue_t,
+				actual_bind_params_t,
+				adaptation_t >;
+
+//
+// actual_dispatcher_iface_t
+//
+/*!
+ * \brief An actual interface of prio-thread-pool dispatcher.
+ *
+ * This interface defines a set of methods necessary for binder.
+ *
+ * \since v.5.8.5
+ */
+class actual_dispatcher_iface_t : public basic_dispatcher_iface_t
+	{
+	public :
+		//! Preallocate all necessary resources for a new agent.
+		virtual void
+		preallocate_resources_for_agent(
+			agent_t & agent,
+			const bind_params_t & params ) = 0;
+
+		//! Undo preallocation of resources for a new agent.
+		virtual void
+		undo_preallocation_for_agent(
+			agent_t & agent ) noexcept = 0;
+
+		//! Get resources allocated for an agent.
+		[[nodiscard]]
+		virtual event_queue_t *
+		query_resources_for_agent( agent_t & agent ) noexcept = 0;
+
+		//! Unbind agent from the dispatcher.
+		virtual void
+		unbind_agent( agent_t & agent ) noexcept = 0;
+	};
+
+//
+// actual_dispatcher_iface_shptr_t
+//
+using actual_dispatcher_iface_shptr_t =
+		std::shared_ptr< actual_dispatcher_iface_t >;
+
+//
+// actual_binder_t
+//
+/*!
+ * \brief Actual implementation of dispatcher binder for %prio_thread_pool dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class actual_binder_t final : public disp_binder_t
+	{
+		//! Dispatcher to be used.
+		actual_dispatcher_iface_shptr_t m_disp;
+		//! Binding parameters.
+		const bind_params_t m_params;
+
+	public :
+		actual_binder_t(
+			actual_dispatcher_iface_shptr_t disp,
+			bind_params_t params ) noexcept
+			:	m_disp{ std::move(disp) }
+			,	m_params{ params }
+			{}
+
+		void
+		preallocate_resources(
+			agent_t & agent ) override
+			{
+				m_disp->preallocate_resources_for_agent( agent, m_params );
+			}
+
+		void
+		undo_preallocation(
+			agent_t & agent ) noexcept override
+			{
+				m_disp->undo_preallocation_for_agent( agent );
+			}
+
+		void
+		bind(
+			agent_t & agent ) noexcept override
+			{
+				auto queue = m_disp->query_resources_for_agent( agent );
+				agent.so_bind_to_dispatcher( *queue );
+			}
+
+		void
+		unbind(
+			agent_t & agent ) noexcept override
+			{
+				m_disp->unbind_agent( agent );
+			}
+	};
+
+//
+// actual_dispatcher_implementation_t
+//
+/*!
+ * \brief Actual implementation of binder for %prio_thread_pool dispatcher.
+ *
+ * \since v.5.8.5
+ */
+template< typename Work_Thread >
+class actual_dispatcher_implementation_t final
+	:	public actual_dispatcher_iface_t
+	{
+		//! Real dispatcher.
+		dispatcher_template_t< Work_Thread > m_impl;
+
+	public :
+		actual_dispatcher_implementation_t(
+			//! SObjectizer Environment to work in.
+			outliving_reference_t< environment_t > env,
+			//! Base part of data sources names.
+			const std::string_view name_base,
+			//! Dispatcher's parameters.
+			disp_params_t params )
+			:	m_impl{
+					env.get(),
+					params,
+					name_base,
+					params.thread_count(),
+					params.queue_params()
+				}
+			{
+				if( params.quotes() )
+					m_impl.dispatcher_queue().storage().set_quotes(
+							*params.quotes() );
+
+				m_impl.start( env.get() );
+			}
+
+		~actual_dispatcher_implementation_t() noexcept override
+			{
+				m_impl.shutdown_then_wait();
+			}
+
+		[[nodiscard]]
+		disp_binder_shptr_t
+		binder( bind_params_t params ) override
+			{
+				return std::make_shared< actual_binder_t >(
+						this->shared_from_this(),
+						params );
+			}
+
+		void
+		preallocate_resources_for_agent(
+			agent_t & agent,
+			const bind_params_t & params ) override
+			{
+				m_impl.preallocate_resources_for_agent(
+						agent,
+						actual_bind_params_t{ params, agent.so_priority() } );
+			}
+
+		void
+		undo_preallocation_for_agent(
+			agent_t & agent ) noexcept override
+			{
+				m_impl.undo_preallocation_for_agent( agent );
+			}
+
+		event_queue_t *
+		query_resources_for_agent( agent_t & agent ) noexcept override
+			{
+				return m_impl.query_resources_for_agent( agent );
+			}
+
+		void
+		unbind_agent( agent_t & agent ) noexcept override
+			{
+				m_impl.unbind_agent( agent );
+			}
+	};
+
+//
+// dispatcher_handle_maker_t
+//
+class dispatcher_handle_maker_t
+	{
+	public :
+		static dispatcher_handle_t
+		make( actual_dispatcher_iface_shptr_t disp ) noexcept
+			{
+				return { std::move( disp ) };
+			}
+	};
+
+} /* namespace impl */
+
+namespace
+{
+
+using namespace so_5::disp::prio_thread_pool::impl;
+
+/*!
+ * \brief Sets the thread count to default value if used do not
+ * specify actual thread count.
+ *
+ * \since v.5.8.5
+ */
+inline void
+adjust_thread_count( disp_params_t & params )
+	{
+		if( !params.thread_count() )
+			params.thread_count( default_thread_pool_size() );
+	}
+
+} /* namespace anonymous */
+
+//
+// make_dispatcher
+//
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	environment_t & env,
+	const std::string_view data_sources_name_base,
+	disp_params_t params )
+	{
+		using namespace so_5::disp::reuse;
+
+		adjust_thread_count( params );
+
+		using dispatcher_no_activity_tracking_t =
+				impl::actual_dispatcher_implementation_t<
+						impl::work_thread_no_activity_tracking_t<
+								impl::dispatcher_queue_t
+						>
+				>;
+
+		using dispatcher_with_activity_tracking_t =
+				impl::actual_dispatcher_implementation_t<
+						impl::work_thread_with_activity_tracking_t<
+								impl::dispatcher_queue_t
+						>
+				>;
+
+		auto binder = so_5::disp::reuse::make_actual_dispatcher<
+						impl::actual_dispatcher_iface_t,
+						dispatcher_no_activity_tracking_t,
+						dispatcher_with_activity_tracking_t >(
+				outliving_mutable(env),
+				data_sources_name_base,
+				std::move(params) );
+
+		return impl::dispatcher_handle_maker_t::make( std::move(binder) );
+	}
+
+} /* namespace prio_thread_pool */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
+
@@ -26,6 +26,103 @@ namespace disp
 namespace reuse
 {
 
+//
+// intrusive_fifo_t
+//
+/*!
+ * \brief Intrusive FIFO of pointers to event queues.
+ *
+ * It's the default storage for queue_of_queues_t.
+ *
+ * Requires that type \a T provides the following methods:
+ * \code
+ * T * intrusive_queue_giveout_next() noexcept;
+ * void intrusive_queue_set_next( T * next ) noexcept;
+ * \endcode
+ *
+ * \note
+ * This code was a part of queue_of_queues_t before v.5.8.5.
+ *
+ * \since v.5.8.5
+ */
+template< class T >
+class intrusive_fifo_t
+	{
+	public :
+		//! Is the storage empty?
+		[[nodiscard]]
+		bool
+		empty() const noexcept { return nullptr == m_head; }
+
+		//! Count of items in the storage.
+		[[nodiscard]]
+		std::size_t
+		size() const noexcept { return m_size; }
+
+		//! Should a worker switch from \a current queue to another one?
+		[[nodiscard]]
+		bool
+		should_switch_from( const T & /*current*/ ) const noexcept
+			{
+				return !empty();
+			}
+
+		/*!
+		 * \brief Extract the head item from the queue.
+		 *
+		 * \attention
+		 * This method must only be called if the queue isn't empty.
+		 * The method doesn't check this condition by itself.
+		 */
+		[[nodiscard]]
+		T *
+		pop() noexcept
+			{
+				auto r = m_head;
+				m_head = r->intrusive_queue_giveout_next();
+				if( !m_head )
+					m_tail = nullptr;
+				--m_size;
+
+				return r;
+			}
+
+		//! Push a new item to the end of the queue.
+		void
+		push( T * new_tail ) noexcept
+			{
+				if( m_tail )
+					{
+						m_tail->intrusive_queue_set_next( new_tail );
+						m_tail = new_tail;
+					}
+				else
+					{
+						m_head = m_tail = new_tail;
+					}
+				++m_size;
+			}
+
+	private :
+		/*!
+		 * \brief The current head of the intrusive queue.
+		 *
+		 * Holds nullptr if the queue is empty.
+		 */
+		T * m_head{ nullptr };
+
+		/*!
+		 * \brief The current tail of the intrusive queue.
+		 *
+		 * Holds nullptr if the queue is empty.
+		 * It is equal to m_head if the queue contains just one item.
+		 */
+		T * m_tail{ nullptr };
+
+		//! The current size of the intrusive queue.
+		std::size_t m_size{};
+	};
+
 //
 // queue_of_queues_t
 //
@@ -40,15 +137,35 @@ namespace reuse
  * void intrusive_queue_set_next( T * next ) noexcept;
  * \endcode
  *
+ * \note
+ * Since v.5.8.5 the order of event queues is defined by \a Storage type.
+ * It has to provide the same methods as intrusive_fifo_t.
+ *
  * \tparam T type of event queue.
  *
+ * \tparam Storage type of storage for non-empty event queues.
+ *
  * \since v.5.4.0, v.5.8.0
  */
-template< class T >
+template< class T, class Storage = intrusive_fifo_t< T > >
 class queue_of_queues_t
 	{
 	public :
 		using item_t = T;
+		using storage_t = Storage;
+
+		/*!
+		 * \brief Description of the current load of the queue.
+		 *
+		 * \since v.5.8.5
+		 */
+		struct load_t
+			{
+				//! Count of non-empty event queues waiting for a thread.
+				std::size_t m_queue_size;
+				//! Count of threads waiting for a work.
+				std::size_t m_waiting_threads;
+			};
 
 		queue_of_queues_t(
 			const so_5::disp::mpmc_queue_traits::queue_params_t & queue_params,
@@ -61,6 +178,7 @@ class queue_of_queues_t
 				// Reserve some space for storing infos about waiting
 				// customer threads.
 				m_waiting_customers.reserve( thread_count );
+				m_retired_customers.reserve( thread_count );
 			}
 
 		//! Initiate shutdown for working threads.
@@ -89,10 +207,10 @@ class queue_of_queues_t
 						if( m_shutdown )
 							break;
 
-						if( m_head )
+						if( !m_storage.empty() )
 							{
 								// The queue isn't empty, the head has to be extracted.
-								auto r = pop_head();
+								auto r = m_storage.pop();
 
 								// There could be non-empty queue and sleeping workers...
 								try_wakeup_someone_if_possible();
@@ -112,6 +230,21 @@ class queue_of_queues_t
 						// If we are here then the current wakeup procedure is
 						// finished.
 						m_wakeup_in_progress = false;
+
+						if( m_retire_requests )
+							{
+								// This thread has been selected for retirement.
+								// NOTE: there is no memory allocation because
+								// m_retired_customers is reserved in the constructor.
+								--m_retire_requests;
+								--m_max_thread_count;
+								m_retired_customers.push_back( &condition );
+
+								// There could be non-empty queue and sleeping workers...
+								try_wakeup_someone_if_possible();
+
+								break;
+							}
 					}
 				while( true );
 
@@ -133,14 +266,14 @@ class queue_of_queues_t
 				if( m_shutdown )
 					return nullptr;
 
-				if( m_head )
+				if( m_storage.should_switch_from( *current ) )
 					{
-						auto r = pop_head();
+						auto r = m_storage.pop();
 
 						// Old non-empty queue must be stored for further processing.
 						// No need to wakup someone because the length of the queue
 						// didn't changed.
-						push_to_queue( current );
+						m_storage.push( current );
 
 						return r;
 					}
@@ -154,7 +287,7 @@ class queue_of_queues_t
 			{
 				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
 
-				push_to_queue( queue );
+				m_storage.push( queue );
 
 				try_wakeup_someone_if_possible();
 			}
@@ -165,38 +298,135 @@ class queue_of_queues_t
 				return m_lock->allocate_condition();
 			}
 
-	private :
-		//! Object's lock.
-		so_5::disp::mpmc_queue_traits::lock_unique_ptr_t m_lock;
+		/*!
+		 * \brief Get access to the storage of non-empty event queues.
+		 *
+		 * Can be used for tuning the storage.
+		 *
+		 * \attention
+		 * Must be called only before the start of working threads.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		storage_t &
+		storage() noexcept
+			{
+				return m_storage;
+			}
 
-		//! Shutdown flag.
-		bool	m_shutdown{ false };
+		/*!
+		 * \brief Set the initial count of working threads that use the queue.
+		 *
+		 * It's necessary for dispatchers with elastic count of threads.
+		 * The count mustn't exceed the value of `thread_count` passed
+		 * to the constructor.
+		 *
+		 * \attention
+		 * Must be called before the start of working threads.
+		 *
+		 * \since v.5.8.5
+		 */
+		void
+		set_thread_count( std::size_t thread_count ) noexcept
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				m_max_thread_count = thread_count;
+			}
 
 		/*!
-		 * \brief The current head of the intrusive queue.
+		 * \brief Inform the queue about a new working thread.
 		 *
-		 * Holds nullptr if the queue is empty.
+		 * The total count of working threads mustn't exceed the value
+		 * of `thread_count` passed to the constructor.
 		 *
-		 * \since v.5.8.0
+		 * \since v.5.8.5
 		 */
-		T * m_head{ nullptr };
+		void
+		increment_thread_count() noexcept
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				++m_max_thread_count;
+			}
 
 		/*!
-		 * \brief The current tail of the intrusive queue.
+		 * \brief Get the current load of the queue.
 		 *
-		 * Holds nullptr if the queue is empty.
-		 * It is equal to m_head if the queue contains just one item.
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		load_t
+		query_load() noexcept
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				return { m_storage.size(), m_waiting_customers.size() };
+			}
+
+		/*!
+		 * \brief An attempt to retire one of waiting threads.
+		 *
+		 * If there is a waiting thread it's awakened and gets nullptr
+		 * from pop(), as in the case of shutdown. The condition object of
+		 * that thread is stored and can be taken by take_retired().
+		 *
+		 * \retval true if there was a waiting thread.
 		 *
-		 * \since v.5.8.0
+		 * \since v.5.8.5
 		 */
-		T * m_tail{ nullptr };
+		bool
+		try_retire_one_waiting_thread() noexcept
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				if( m_shutdown || m_waiting_customers.empty() ||
+						m_wakeup_in_progress )
+					return false;
+
+				++m_retire_requests;
+				pop_and_notify_one_waiting_customer();
+
+				return true;
+			}
 
 		/*!
-		 * \brief The current size of the intrusive queue.
+		 * \brief Take condition objects of retired threads.
+		 *
+		 * Those threads have already received nullptr from pop() and
+		 * can be joined.
 		 *
-		 * \since v.5.8.0
+		 * \since v.5.8.5
 		 */
-		std::size_t m_queue_size{};
+		void
+		take_retired(
+			std::vector< so_5::disp::mpmc_queue_traits::condition_t * > & to ) noexcept
+			{
+				std::lock_guard< so_5::disp::mpmc_queue_traits::lock_t > lock{ *m_lock };
+
+				// NOTE: there is no memory allocation because both vectors
+				// have the same capacity.
+				to.clear();
+				to.swap( m_retired_customers );
+			}
+
+	private :
+		//! Object's lock.
+		so_5::disp::mpmc_queue_traits::lock_unique_ptr_t m_lock;
+
+		//! Shutdown flag.
+		bool	m_shutdown{ false };
+
+		/*!
+		 * \brief Non-empty event queues waiting for a worker.
+		 *
+		 * \note
+		 * It was an intrusive queue with m_head and m_tail before v.5.8.5.
+		 *
+		 * \since v.5.8.5
+		 */
+		Storage m_storage;
 
 		/*!
 		 * \brief Is some working thread in wakeup process now?
@@ -210,9 +440,13 @@ class queue_of_queues_t
 		 * \brief Maximum count of working threads to be used with
 		 * that mpmc_queue.
 		 *
+		 * \note
+		 * It isn't a const since v.5.8.5 because the count of threads
+		 * can be changed by an elastic dispatcher.
+		 *
 		 * \since v.5.5.16
 		 */
-		const std::size_t m_max_thread_count;
+		std::size_t m_max_thread_count;
 
 		/*!
 		 * \brief Threshold for wake up next working thread if there are
@@ -225,6 +459,21 @@ class queue_of_queues_t
 		//! Waiting threads.
 		std::vector< so_5::disp::mpmc_queue_traits::condition_t * > m_waiting_customers;
 
+		/*!
+		 * \brief Count of waiting threads those have to be retired.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::size_t m_retire_requests{};
+
+		/*!
+		 * \brief Threads those have been retired but not taken by
+		 * take_retired() yet.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::vector< so_5::disp::mpmc_queue_traits::condition_t * > m_retired_customers;
+
 		void
 		pop_and_notify_one_waiting_customer() noexcept
 			{
@@ -252,57 +501,15 @@ class queue_of_queues_t
 		void
 		try_wakeup_someone_if_possible() noexcept
 			{
-				if( m_head &&
+				if( !m_storage.empty() &&
 						!m_waiting_customers.empty() &&
 						!m_wakeup_in_progress &&
-						( m_queue_size > m_next_thread_wakeup_threshold ||
+						( m_storage.size() > m_next_thread_wakeup_threshold ||
 						m_max_thread_count == m_waiting_customers.size() ) )
 					{
 						pop_and_notify_one_waiting_customer();
 					}
 			}
-
-		/*!
-		 * \brief Helper method that extracts the head item from the queue.
-		 *
-		 * \attention
-		 * This method must only be called if the queue isn't empty.
-		 * The method doesn't check this condition by itself.
-		 *
-		 * \since v.5.8.0
-		 */
-		[[nodiscard]]
-		T *
-		pop_head() noexcept
-			{
-				auto r = m_head;
-				m_head = r->intrusive_queue_giveout_next();
-				if( !m_head )
-					m_tail = nullptr;
-				--m_queue_size;
-
-				return r;
-			}
-
-		/*!
-		 * \brief Helper method that pushes a new item to the end of the queue.
-		 *
-		 * \since v.5.8.0
-		 */
-		void
-		push_to_queue( T * new_tail ) noexcept
-			{
-				if( m_tail )
-					{
-						m_tail->intrusive_queue_set_next( new_tail );
-						m_tail = new_tail;
-					}
-				else
-					{
-						m_head = m_tail = new_tail;
-					}
-				++m_queue_size;
-			}
 	};
 
 } /* namespace reuse */
@@ -0,0 +1,778 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Functions for creating and binding of the dispatcher with
+ * a set of one_thread-like shards and migration of agents between them.
+ *
+ * \since v.5.8.5
+ */
+
+#include <so_5/disp/sharded_one_thread/pub.hpp>
+
+#include <so_5/disp/thread_pool/impl/work_thread_template.hpp>
+#include <so_5/disp/thread_pool/impl/basic_event_queue.hpp>
+
+#include <so_5/disp/reuse/actual_work_thread_factory_to_use.hpp>
+#include <so_5/disp/reuse/data_source_prefix_helpers.hpp>
+#include <so_5/disp/reuse/make_actual_dispatcher.hpp>
+#include <so_5/disp/reuse/queue_of_queues.hpp>
+
+#include <so_5/stats/repository.hpp>
+#include <so_5/stats/messages.hpp>
+#include <so_5/stats/std_names.hpp>
+
+#include <so_5/details/rollback_on_exception.hpp>
+
+#include <so_5/send_functions.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace sharded_one_thread {
+
+namespace impl {
+
+namespace stats = so_5::stats;
+
+namespace tp_impl = so_5::disp::thread_pool::impl;
+
+class agent_queue_t;
+
+//
+// shard_queue_t
+//
+/*!
+ * \brief Type of queue of non-empty agent queues for one shard.
+ *
+ * \since v.5.8.5
+ */
+using shard_queue_t = so_5::disp::reuse::queue_of_queues_t< agent_queue_t >;
+
+//
+// shard_t
+//
+/*!
+ * \brief Data of one shard.
+ *
+ * \since v.5.8.5
+ */
+class shard_t
+	{
+	public :
+		shard_t( const queue_traits::queue_params_t & queue_params )
+			:	m_queue{ queue_params, 1u }
+			{}
+
+		[[nodiscard]]
+		shard_queue_t &
+		queue() noexcept { return m_queue; }
+
+		//! Add a non-empty agent queue to the shard.
+		void
+		schedule( agent_queue_t * queue ) noexcept
+			{
+				m_ready_queues.fetch_add( 1u, std::memory_order_relaxed );
+				m_queue.schedule( queue );
+			}
+
+		//! Inform the shard that an agent queue is taken by the work thread.
+		void
+		queue_taken() noexcept
+			{
+				m_ready_queues.fetch_sub( 1u, std::memory_order_relaxed );
+			}
+
+		//! Set the state of the work thread.
+		void
+		set_busy( bool v ) noexcept
+			{
+				m_busy.store( v, std::memory_order_relaxed );
+			}
+
+		//! Get the current load of the shard.
+		/*!
+		 * It's the count of agent queues waiting for the work thread
+		 * plus one if the work thread is busy.
+		 */
+		[[nodiscard]]
+		std::size_t
+		load() const noexcept
+			{
+				return m_ready_queues.load( std::memory_order_relaxed ) +
+						(m_busy.load( std::memory_order_relaxed ) ? 1u : 0u);
+			}
+
+		//! Count of agents assigned to that shard during the binding.
+		/*!
+		 * \note
+		 * Is protected by the dispatcher's lock.
+		 */
+		std::size_t m_agents{};
+
+	private :
+		//! Queue of non-empty agent queues.
+		shard_queue_t m_queue;
+
+		//! Count of agent queues waiting for the work thread.
+		std::atomic< std::size_t > m_ready_queues{};
+
+		//! Is the work thread processing demands now?
+		std::atomic< bool > m_busy{ false };
+	};
+
+//
+// shard_selector_t
+//
+/*!
+ * \brief An interface for the selection of a shard at a safe point.
+ *
+ * \since v.5.8.5
+ */
+class shard_selector_t
+	{
+	public :
+		//! Select a shard for an agent queue that belongs to \a current.
+		[[nodiscard]]
+		virtual shard_t &
+		select_shard( shard_t & current ) noexcept = 0;
+
+	protected :
+		~shard_selector_t() = default;
+	};
+
+//
+// agent_queue_t
+//
+/*!
+ * \brief Event queue for an agent.
+ *
+ * The queue belongs to one shard at a time. The shard can be changed
+ * only when no demands from the queue are being processed.
+ *
+ * \since v.5.8.5
+ */
+class agent_queue_t final
+	:	public tp_impl::basic_event_queue_t
+	{
+		//! Short alias for the main base type.
+		using base_type_t = tp_impl::basic_event_queue_t;
+
+	public:
+		//! Initializing constructor.
+		agent_queue_t(
+			outliving_reference_t< shard_selector_t > selector,
+			outliving_reference_t< shard_t > shard,
+			std::size_t max_demands_at_once )
+			:	base_type_t{ max_demands_at_once }
+			,	m_selector{ selector.get() }
+			,	m_shard{ &(shard.get()) }
+			{}
+
+		//! The current shard of the queue.
+		[[nodiscard]]
+		shard_t &
+		shard() const noexcept
+			{
+				return *(m_shard.load( std::memory_order_acquire ));
+			}
+
+		//! Schedule the queue on the specified shard.
+		/*!
+		 * \attention
+		 * Must be called only if no demands from the queue are being
+		 * processed and the queue isn't scheduled yet.
+		 */
+		void
+		schedule_on( shard_t & shard ) noexcept
+			{
+				m_shard.store( &shard, std::memory_order_release );
+				shard.schedule( this );
+			}
+
+		/*!
+		 * \brief Give away a pointer to the next agent_queue.
+		 *
+		 * \note
+		 * This method is a part of interface required by
+		 * so_5::disp::reuse::intrusive_fifo_t.
+		 */
+		[[nodiscard]]
+		agent_queue_t *
+		intrusive_queue_giveout_next() noexcept
+			{
+				auto * r = m_intrusive_queue_next;
+				m_intrusive_queue_next = nullptr;
+				return r;
+			}
+
+		/*!
+		 * \brief Set a pointer to the next agent_queue.
+		 *
+		 * \note
+		 * This method is a part of interface required by
+		 * so_5::disp::reuse::intrusive_fifo_t.
+		 */
+		void
+		intrusive_queue_set_next( agent_queue_t * next ) noexcept
+			{
+				m_intrusive_queue_next = next;
+			}
+
+	protected:
+		void
+		schedule_on_disp_queue() noexcept override
+			{
+				// The queue was empty, so no demands from it are being
+				// processed. It's a safe point for migration.
+				schedule_on( m_selector.select_shard( shard() ) );
+			}
+
+	private :
+		//! Selector of shards for migration.
+		shard_selector_t & m_selector;
+
+		//! The current shard of the queue.
+		std::atomic< shard_t * > m_shard;
+
+		/*!
+		 * \brief The next item in intrusive queue of agent_queues.
+		 *
+		 * This field is necessary to implement interface required by
+		 * so_5::disp::reuse::intrusive_fifo_t.
+		 */
+		agent_queue_t * m_intrusive_queue_next{ nullptr };
+	};
+
+//
+// shard_thread_template_t
+//
+/*!
+ * \brief Work thread of one shard.
+ *
+ * It's similar to the work thread of thread_pool dispatcher, but
+ * checks the possibility of migration of an agent queue after
+ * processing of max_demands_at_once demands.
+ *
+ * \since v.5.8.5
+ */
+template< typename Impl >
+class shard_thread_template_t final : public Impl
+	{
+	public :
+		//! Initializing constructor.
+		shard_thread_template_t(
+			outliving_reference_t< shard_t > shard,
+			outliving_reference_t< shard_selector_t > selector,
+			work_thread_holder_t thread_holder )
+			:	Impl( outliving_mutable( shard.get().queue() ), std::move(thread_holder) )
+			,	m_shard{ shard.get() }
+			,	m_selector{ selector.get() }
+			{}
+
+		void
+		join()
+			{
+				so_5::impl::ensure_join_from_different_thread( this->m_thread_id );
+				this->m_thread_holder.unchecked_get().join();
+			}
+
+		//! Launch work thread.
+		void
+		start()
+			{
+				this->m_thread_holder.unchecked_get().start( [this]() { body(); } );
+			}
+
+		/*!
+		 * \brief Get ID of work thread.
+		 *
+		 * \note This method returns correct value only after start
+		 * of the thread.
+		 */
+		so_5::current_thread_id_t
+		thread_id() const
+			{
+				return this->m_thread_id;
+			}
+
+	private :
+		//! The shard of that thread.
+		shard_t & m_shard;
+
+		//! Selector of shards for migration.
+		shard_selector_t & m_selector;
+
+		//! Thread body method.
+		void
+		body()
+			{
+				this->m_thread_id = so_5::query_current_thread_id();
+
+				agent_queue_t * agent_queue;
+				while( nullptr != (agent_queue = this->pop_agent_queue()) )
+					{
+						this->do_queue_processing( agent_queue );
+
+						m_shard.set_busy( false );
+					}
+			}
+
+		/*!
+		 * \brief An attempt of extraction of non-empty agent queue.
+		 *
+		 * \note This is noexcept method because its logic can't survive
+		 * an exception from m_disp_queue->pop.
+		 */
+		[[nodiscard]]
+		agent_queue_t *
+		pop_agent_queue() noexcept
+			{
+				agent_queue_t * result = nullptr;
+
+				this->wait_started();
+
+				result = this->m_disp_queue->pop( *(this->m_condition) );
+
+				this->wait_finished();
+
+				if( result )
+					{
+						m_shard.set_busy( true );
+						m_shard.queue_taken();
+					}
+
+				return result;
+			}
+
+		/*!
+		 * \brief Starts processing of demands from the queue specified.
+		 *
+		 * If \a current_queue is still non-empty after processing of
+		 * enabled number of events then it's a safe point for migration.
+		 * If the queue stays on that shard then an attempt to switch
+		 * to another queue is performed.
+		 */
+		void
+		do_queue_processing( agent_queue_t * current_queue )
+			{
+				do
+					{
+						const auto e = this->process_queue( *current_queue );
+
+						if( agent_queue_t::emptyness_t::not_empty == e )
+							{
+								auto & target = m_selector.select_shard( m_shard );
+								if( &target != &m_shard )
+									{
+										current_queue->schedule_on( target );
+										current_queue = nullptr;
+									}
+								else
+									current_queue =
+										this->m_disp_queue->try_switch_to_another(
+											current_queue );
+							}
+						else
+							// Handling of the current queue should be stopped.
+							current_queue = nullptr;
+					}
+				while( current_queue != nullptr );
+			}
+
+		//! Processing of demands from agent queue.
+		[[nodiscard]]
+		agent_queue_t::emptyness_t
+		process_queue( agent_queue_t & queue )
+			{
+				std::size_t demands_processed = 0;
+				agent_queue_t::pop_result_t pop_result;
+
+				do
+					{
+						auto & d = queue.front();
+
+						this->work_started();
+
+						d.call_handler( this->m_thread_id );
+
+						this->work_finished();
+
+						++demands_processed;
+						pop_result = queue.pop( demands_processed );
+					}
+				while( agent_queue_t::processing_continuation_t::enabled ==
+						pop_result.m_continuation );
+
+				return pop_result.m_emptyness;
+			}
+	};
+
+//
+// shard_thread_no_activity_tracking_t
+//
+using shard_thread_no_activity_tracking_t =
+	shard_thread_template_t<
+		tp_impl::work_thread_details::no_activity_tracking_impl_t<
+				shard_queue_t > >;
+
+//
+// shard_thread_with_activity_tracking_t
+//
+using shard_thread_with_activity_tracking_t =
+	shard_thread_template_t<
+		tp_impl::work_thread_details::with_activity_tracking_impl_t<
+				shard_queue_t > >;
+
+//
+// dispatcher_template_t
+//
+/*!
+ * \brief An implementation of dispatcher with several shards.
+ *
+ * \since v.5.8.5
+ */
+template< typename Work_Thread >
+class dispatcher_template_t final
+	:	public disp_binder_t
+	,	private shard_selector_t
+	{
+		friend class disp_data_source_t;
+
+	public:
+		dispatcher_template_t(
+			outliving_reference_t< environment_t > env,
+			const std::string_view name_base,
+			disp_params_t params )
+			:	m_max_demands_at_once{
+					std::max< std::size_t >( 1u, params.max_demands_at_once() ) }
+			,	m_migration_threshold{ params.migration_threshold() }
+			{
+				const auto thread_count =
+						std::max< std::size_t >( 1u, params.thread_count() );
+
+				m_shards.reserve( thread_count );
+				m_threads.reserve( thread_count );
+				for( std::size_t i = 0; i != thread_count; ++i )
+					{
+						m_shards.push_back(
+								std::make_unique< shard_t >( params.queue_params() ) );
+						m_threads.push_back( std::make_unique< Work_Thread >(
+								outliving_mutable( *(m_shards.back()) ),
+								outliving_mutable< shard_selector_t >( *this ),
+								so_5::disp::reuse::acquire_work_thread(
+										params, env.get() ) ) );
+					}
+
+				std::size_t started = 0u;
+				so_5::details::do_with_rollback_on_exception(
+						[&] {
+							for( auto & t : m_threads )
+								{
+									t->start();
+									++started;
+								}
+						},
+						[&] {
+							shutdown_then_wait( started );
+						} );
+
+				m_data_source.emplace(
+						outliving_mutable(env.get().stats_repository()),
+						name_base,
+						outliving_mutable(*this) );
+			}
+
+		~dispatcher_template_t() noexcept override
+			{
+				m_data_source.reset();
+				shutdown_then_wait( m_threads.size() );
+			}
+
+		void
+		preallocate_resources(
+			agent_t & agent ) override
+			{
+				std::lock_guard< std::mutex > lock{ m_agents_lock };
+
+				// New agent goes to the shard with the minimal count of agents.
+				auto & shard = **std::min_element(
+						m_shards.begin(), m_shards.end(),
+						[]( const auto & a, const auto & b ) {
+							return a->m_agents < b->m_agents;
+						} );
+
+				m_agents.emplace( &agent, agent_data_t{
+						std::make_unique< agent_queue_t >(
+								outliving_mutable< shard_selector_t >( *this ),
+								outliving_mutable( shard ),
+								m_max_demands_at_once ),
+						&shard } );
+				++(shard.m_agents);
+			}
+
+		void
+		undo_preallocation(
+			agent_t & agent ) noexcept override
+			{
+				std::lock_guard< std::mutex > lock{ m_agents_lock };
+
+				auto it = m_agents.find( &agent );
+				if( it != m_agents.end() )
+					{
+						// agent_queue object can be destroyed
+						// only when it is empty.
+						it->second.m_queue->wait_for_emptyness();
+
+						--(it->second.m_home_shard->m_agents);
+						m_agents.erase( it );
+					}
+			}
+
+		void
+		bind(
+			agent_t & agent ) noexcept override
+			{
+				std::lock_guard< std::mutex > lock{ m_agents_lock };
+
+				agent.so_bind_to_dispatcher(
+						*(m_agents.find( &agent )->second.m_queue) );
+			}
+
+		void
+		unbind(
+			agent_t & agent ) noexcept override
+			{
+				undo_preallocation( agent );
+			}
+
+	private:
+		/*!
+		 * \brief Data source for run-time monitoring of whole dispatcher.
+		 */
+		class disp_data_source_t : public stats::source_t
+			{
+				//! Dispatcher to work with.
+				outliving_reference_t< dispatcher_template_t > m_dispatcher;
+
+				//! Basic prefix for data sources.
+				stats::prefix_t m_base_prefix;
+
+			public :
+				disp_data_source_t(
+					const std::string_view name_base,
+					outliving_reference_t< dispatcher_template_t > disp )
+					:	m_dispatcher{ disp }
+					,	m_base_prefix{ so_5::disp::reuse::make_disp_prefix(
+								"sot", // sharded_one_thread.
+								name_base,
+								&(disp.get()) )
+						}
+					{}
+
+				void
+				distribute( const mbox_t & mbox ) override
+					{
+						auto & disp = m_dispatcher.get();
+
+						std::vector< std::size_t > demands( disp.m_shards.size(), 0u );
+						std::size_t agents = 0u;
+						{
+							std::lock_guard< std::mutex > lock{ disp.m_agents_lock };
+
+							agents = disp.m_agents.size();
+							for( const auto & [agent, data] : disp.m_agents )
+								demands[ disp.shard_index( data.m_queue->shard() ) ] +=
+										data.m_queue->size();
+						}
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_base_prefix,
+								stats::suffixes::agent_count(),
+								agents );
+
+						so_5::send< stats::messages::quantity< std::size_t > >(
+								mbox,
+								m_base_prefix,
+								stats::suffixes::migrated_agents_count(),
+								disp.m_migrations.load( std::memory_order_relaxed ) );
+
+						for( std::size_t i = 0; i != disp.m_threads.size(); ++i )
+							{
+								const auto prefix =
+										so_5::disp::reuse::make_disp_working_thread_prefix(
+												m_base_prefix, i );
+
+								so_5::send< stats::messages::quantity< std::size_t > >(
+										mbox,
+										prefix,
+										stats::suffixes::work_thread_queue_size(),
+										demands[ i ] );
+
+								auto & wt = *(disp.m_threads[ i ]);
+								wt.take_activity_stats(
+									[&]( const stats::work_thread_activity_stats_t & s ) {
+										so_5::send< stats::messages::work_thread_activity >(
+												mbox,
+												prefix,
+												stats::suffixes::work_thread_activity(),
+												wt.thread_id(),
+												s );
+									} );
+							}
+					}
+			};
+
+		//! Data for one agent.
+		struct agent_data_t
+			{
+				//! Event queue for the agent.
+				std::unique_ptr< agent_queue_t > m_queue;
+
+				//! The shard the agent was assigned to during the binding.
+				shard_t * m_home_shard;
+			};
+
+		//! Maximum count of demands to be processed at once.
+		const std::size_t m_max_demands_at_once;
+
+		//! The threshold for migration of agents.
+		const std::size_t m_migration_threshold;
+
+		//! Shards of the dispatcher.
+		std::vector< std::unique_ptr< shard_t > > m_shards;
+
+		//! Work threads of shards.
+		/*!
+		 * The thread with index i belongs to the shard with index i.
+		 */
+		std::vector< std::unique_ptr< Work_Thread > > m_threads;
+
+		//! Total count of migrations.
+		std::atomic< std::size_t > m_migrations{};
+
+		//! Lock for the map of agents.
+		std::mutex m_agents_lock;
+
+		//! Agents bound to the dispatcher.
+		std::map< agent_t *, agent_data_t > m_agents;
+
+		//! Data source for run-time monitoring.
+		/*!
+		 * It's created after the start of work threads.
+		 */
+		so_5::optional<
+					stats::auto_registered_source_holder_t< disp_data_source_t > >
+				m_data_source;
+
+		[[nodiscard]]
+		shard_t &
+		select_shard( shard_t & current ) noexcept override
+			{
+				if( !m_migration_threshold )
+					return current;
+
+				const auto current_load = current.load();
+				// There is no need to look for another shard.
+				if( current_load < m_migration_threshold )
+					return current;
+
+				shard_t * best = &current;
+				std::size_t best_load = current_load;
+				for( auto & s : m_shards )
+					{
+						const auto l = s->load();
+						if( l < best_load )
+							{
+								best = s.get();
+								best_load = l;
+							}
+					}
+
+				if( current_load - best_load < m_migration_threshold )
+					return current;
+
+				m_migrations.fetch_add( 1u, std::memory_order_relaxed );
+				return *best;
+			}
+
+		[[nodiscard]]
+		std::size_t
+		shard_index( const shard_t & shard ) const noexcept
+			{
+				std::size_t i = 0u;
+				while( m_shards[ i ].get() != &shard )
+					++i;
+
+				return i;
+			}
+
+		void
+		shutdown_then_wait( std::size_t started_threads ) noexcept
+			{
+				for( auto & s : m_shards )
+					s->queue().shutdown();
+
+				for( std::size_t i = 0; i != started_threads; ++i )
+					m_threads[ i ]->join();
+			}
+	};
+
+//
+// dispatcher_handle_maker_t
+//
+class dispatcher_handle_maker_t
+	{
+	public :
+		static dispatcher_handle_t
+		make( disp_binder_shptr_t binder ) noexcept
+			{
+				return { std::move( binder ) };
+			}
+	};
+
+} /* namespace impl */
+
+//
+// make_dispatcher
+//
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	environment_t & env,
+	const std::string_view data_sources_name_base,
+	disp_params_t params )
+	{
+		using dispatcher_no_activity_tracking_t =
+				impl::dispatcher_template_t<
+						impl::shard_thread_no_activity_tracking_t >;
+
+		using dispatcher_with_activity_tracking_t =
+				impl::dispatcher_template_t<
+						impl::shard_thread_with_activity_tracking_t >;
+
+		disp_binder_shptr_t binder = so_5::disp::reuse::make_actual_dispatcher<
+						disp_binder_t,
+						dispatcher_no_activity_tracking_t,
+						dispatcher_with_activity_tracking_t >(
+				outliving_mutable(env),
+				data_sources_name_base,
+				std::move(params) );
+
+		return impl::dispatcher_handle_maker_t::make( std::move(binder) );
+	}
+
+} /* namespace sharded_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
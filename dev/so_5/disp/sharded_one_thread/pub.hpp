@@ -0,0 +1,345 @@
+/*
+	SObjectizer 5.
+*/
+
+/*!
+ * \file
+ * \brief Functions for creating and binding of the dispatcher with
+ * a set of one_thread-like shards and migration of agents between them.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/declspec.hpp>
+
+#include <so_5/disp_binder.hpp>
+
+#include <so_5/disp/mpmc_queue_traits/pub.hpp>
+
+#include <so_5/disp/reuse/default_thread_pool_size.hpp>
+#include <so_5/disp/reuse/work_thread_activity_tracking.hpp>
+#include <so_5/disp/reuse/work_thread_factory_params.hpp>
+
+#include <string_view>
+
+namespace so_5 {
+
+namespace disp {
+
+namespace sharded_one_thread {
+
+/*!
+ * \brief Alias for namespace with traits of event queue.
+ *
+ * \since v.5.8.5
+ */
+namespace queue_traits = so_5::disp::mpmc_queue_traits;
+
+//
+// default_migration_threshold
+//
+/*!
+ * \brief The default value for disp_params_t::migration_threshold().
+ *
+ * \since v.5.8.5
+ */
+inline constexpr std::size_t default_migration_threshold = 2u;
+
+//
+// disp_params_t
+//
+/*!
+ * \brief Parameters for sharded_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class disp_params_t
+	:	public so_5::disp::reuse::work_thread_activity_tracking_flag_mixin_t< disp_params_t >
+	,	public so_5::disp::reuse::work_thread_factory_mixin_t< disp_params_t >
+	{
+		using activity_tracking_mixin_t = so_5::disp::reuse::
+				work_thread_activity_tracking_flag_mixin_t< disp_params_t >;
+		using thread_factory_mixin_t = so_5::disp::reuse::
+				work_thread_factory_mixin_t< disp_params_t >;
+
+	public :
+		//! Default constructor.
+		disp_params_t() = default;
+
+		friend inline void
+		swap( disp_params_t & a, disp_params_t & b ) noexcept
+			{
+				swap(
+						static_cast< activity_tracking_mixin_t & >(a),
+						static_cast< activity_tracking_mixin_t & >(b) );
+
+				swap(
+						static_cast< thread_factory_mixin_t & >(a),
+						static_cast< thread_factory_mixin_t & >(b) );
+
+				std::swap( a.m_thread_count, b.m_thread_count );
+				swap( a.m_queue_params, b.m_queue_params );
+				std::swap( a.m_max_demands_at_once, b.m_max_demands_at_once );
+				std::swap( a.m_migration_threshold, b.m_migration_threshold );
+			}
+
+		//! Setter for the count of shards (working threads).
+		disp_params_t &
+		thread_count( std::size_t count )
+			{
+				m_thread_count = count;
+				return *this;
+			}
+
+		//! Getter for the count of shards (working threads).
+		[[nodiscard]]
+		std::size_t
+		thread_count() const noexcept
+			{
+				return m_thread_count;
+			}
+
+		//! Setter for queue parameters.
+		disp_params_t &
+		set_queue_params( queue_traits::queue_params_t p )
+			{
+				m_queue_params = std::move(p);
+				return *this;
+			}
+
+		//! Tuner for queue parameters.
+		/*!
+		 * Accepts lambda-function or functional object which tunes
+		 * queue parameters.
+			\code
+			namespace sot_disp = so_5::disp::sharded_one_thread;
+			auto disp = sot_disp::make_dispatcher( env,
+				"my_sharded_disp",
+				sot_disp::disp_params_t{}.tune_queue_params(
+					[]( sot_disp::queue_traits::queue_params_t & p ) {
+						p.lock_factory( sot_disp::queue_traits::simple_lock_factory() );
+					} ) );
+			\endcode
+		 */
+		template< typename L >
+		disp_params_t &
+		tune_queue_params( L tunner )
+			{
+				tunner( m_queue_params );
+				return *this;
+			}
+
+		//! Getter for queue parameters.
+		[[nodiscard]]
+		const queue_traits::queue_params_t &
+		queue_params() const noexcept
+			{
+				return m_queue_params;
+			}
+
+		//! Set maximum count of demands to be processed at once.
+		/*!
+		 * A working thread processes up to that count of demands of
+		 * an agent and then checks the possibility of migration of
+		 * the agent or switching to another agent.
+		 */
+		disp_params_t &
+		max_demands_at_once( std::size_t v )
+			{
+				m_max_demands_at_once = v;
+				return *this;
+			}
+
+		//! Get maximum count of demands to be processed at once.
+		[[nodiscard]]
+		std::size_t
+		max_demands_at_once() const noexcept
+			{
+				return m_max_demands_at_once;
+			}
+
+		//! Set the threshold for migration of agents.
+		/*!
+		 * The load of a shard is the count of agents with non-empty
+		 * queues waiting for the working thread of the shard plus one
+		 * if the working thread is busy.
+		 *
+		 * An agent is moved to the least loaded shard if the load of the
+		 * agent's current shard exceeds the load of the least loaded shard
+		 * by that threshold or more.
+		 *
+		 * Zero value disables migration: agents stay on shards they were
+		 * assigned to during the binding.
+		 */
+		disp_params_t &
+		migration_threshold( std::size_t v )
+			{
+				m_migration_threshold = v;
+				return *this;
+			}
+
+		//! Get the threshold for migration of agents.
+		[[nodiscard]]
+		std::size_t
+		migration_threshold() const noexcept
+			{
+				return m_migration_threshold;
+			}
+
+	private :
+		//! Count of shards (working threads).
+		std::size_t m_thread_count{
+				so_5::disp::reuse::default_thread_pool_size() };
+
+		//! Queue parameters.
+		queue_traits::queue_params_t m_queue_params;
+
+		//! Maximum count of demands to be processed at once.
+		std::size_t m_max_demands_at_once{ 4u };
+
+		//! The threshold for migration of agents.
+		std::size_t m_migration_threshold{ default_migration_threshold };
+	};
+
+namespace impl
+{
+
+class dispatcher_handle_maker_t;
+
+} /* namespace impl */
+
+//
+// dispatcher_handle_t
+//
+
+/*!
+ * \brief A handle for sharded_one_thread dispatcher.
+ *
+ * \since v.5.8.5
+ */
+class [[nodiscard]] dispatcher_handle_t
+	{
+		friend class impl::dispatcher_handle_maker_t;
+
+		//! Binder for the dispatcher.
+		disp_binder_shptr_t m_binder;
+
+		dispatcher_handle_t( disp_binder_shptr_t binder ) noexcept
+			:	m_binder{ std::move(binder) }
+			{}
+
+		//! Is this handle empty?
+		bool
+		empty() const noexcept { return !m_binder; }
+
+	public :
+		dispatcher_handle_t() noexcept = default;
+
+		//! Get a binder for that dispatcher.
+		[[nodiscard]]
+		disp_binder_shptr_t
+		binder() const noexcept
+			{
+				return m_binder;
+			}
+
+		//! Is this handle empty?
+		operator bool() const noexcept { return empty(); }
+
+		//! Does this handle contain a reference to dispatcher?
+		bool
+		operator!() const noexcept { return !empty(); }
+
+		//! Drop the content of handle.
+		void
+		reset() noexcept { m_binder.reset(); }
+	};
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of sharded_one_thread dispatcher.
+ *
+ * The dispatcher has several working threads (shards). Every agent
+ * has its own event queue and is handled by one shard at a time,
+ * so an agent works like on one_thread dispatcher and the order of
+ * its demands is preserved.
+ *
+ * An agent is assigned to the shard with the minimal count of agents
+ * during the binding. Then the agent can be moved to another shard at
+ * safe points, when no demands of the agent are being processed:
+ *
+ * - when the agent's queue becomes non-empty;
+ * - when a working thread has processed max_demands_at_once() demands
+ *   of the agent and the agent's queue is still non-empty.
+ *
+ * The decision is based on the load of shards (see
+ * disp_params_t::migration_threshold()).
+ *
+ * \par Usage sample
+\code
+auto disp = so_5::disp::sharded_one_thread::make_dispatcher(
+	env,
+	"workers",
+	so_5::disp::sharded_one_thread::disp_params_t{}.thread_count( 4 ) );
+auto coop = env.make_coop(
+	// The main dispatcher for that coop will be
+	// this instance of sharded_one_thread dispatcher.
+	disp.binder() );
+\endcode
+ *
+ * \since v.5.8.5
+ */
+SO_5_FUNC dispatcher_handle_t
+make_dispatcher(
+	//! SObjectizer Environment to work in.
+	environment_t & env,
+	//! Value for creating names of data sources for
+	//! run-time monitoring.
+	const std::string_view data_sources_name_base,
+	//! Parameters for the dispatcher.
+	disp_params_t params );
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of sharded_one_thread dispatcher with
+ * the default parameters.
+ *
+ * \since v.5.8.5
+ */
+inline dispatcher_handle_t
+make_dispatcher(
+	//! SObjectizer Environment to work in.
+	environment_t & env,
+	//! Value for creating names of data sources for
+	//! run-time monitoring.
+	const std::string_view data_sources_name_base )
+	{
+		return make_dispatcher( env, data_sources_name_base, disp_params_t{} );
+	}
+
+//
+// make_dispatcher
+//
+/*!
+ * \brief Create an instance of sharded_one_thread dispatcher with
+ * the default parameters.
+ *
+ * \since v.5.8.5
+ */
+inline dispatcher_handle_t
+make_dispatcher( environment_t & env )
+	{
+		return make_dispatcher( env, std::string_view{} );
+	}
+
+} /* namespace sharded_one_thread */
+
+} /* namespace disp */
+
+} /* namespace so_5 */
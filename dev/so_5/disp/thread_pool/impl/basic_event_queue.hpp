@@ -18,6 +18,8 @@
 #include <so_5/outliving.hpp>
 #include <so_5/spinlocks.hpp>
 
+#include <chrono>
+
 namespace so_5
 {
 
@@ -61,8 +63,13 @@ class basic_event_queue_t
 
 	public :
 		basic_event_queue_t(
-			std::size_t max_demands_at_once )
+			std::size_t max_demands_at_once,
+			//! Time slice for the processing of demands.
+			//! Zero means that time slice isn't used.
+			std::chrono::steady_clock::duration time_slice =
+				std::chrono::steady_clock::duration::zero() )
 			:	m_max_demands_at_once( max_demands_at_once )
+			,	m_time_slice( time_slice )
 			,	m_tail_demand( &m_head_demand )
 			{}
 
@@ -212,6 +219,63 @@ class basic_event_queue_t
 				}
 			}
 
+		/*!
+		 * \brief Is the count of demands processed at once defined
+		 * by the time slice?
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		bool
+		is_time_sliced() const noexcept
+			{
+				return std::chrono::steady_clock::duration::zero() != m_time_slice;
+			}
+
+		//! Remove the front demand in the time-sliced mode.
+		/*!
+		 * Processing can be continued if the next demand is expected
+		 * to finish within the time slice. The expected duration of
+		 * the next demand is the average duration of the previous ones.
+		 *
+		 * \note
+		 * The average duration is modified without the queue's lock
+		 * because the queue is processed by one thread at a time.
+		 *
+		 * \since v.5.8.5
+		 */
+		pop_result_t
+		pop(
+			//! Time since the start of processing of the queue.
+			std::chrono::steady_clock::duration elapsed,
+			//! Duration of the last demand.
+			std::chrono::steady_clock::duration last_demand_duration )
+			{
+				// Exponential moving average with weight 1/8 for new value.
+				m_avg_demand_duration +=
+						(last_demand_duration - m_avg_demand_duration) / 8;
+
+				std::unique_ptr< demand_t > old_head;
+				{
+					std::lock_guard< spinlock_t > lock( m_lock );
+
+					old_head = remove_head();
+
+					const auto emptyness = m_head_demand.m_next ?
+							emptyness_t::not_empty : emptyness_t::empty;
+
+					if( emptyness_t::empty == emptyness )
+						m_tail_demand = &m_head_demand;
+
+					return pop_result_t{
+							emptyness_t::not_empty == emptyness &&
+									elapsed + m_avg_demand_duration < m_time_slice ?
+									processing_continuation_t::enabled :
+									processing_continuation_t::disabled,
+							emptyness };
+				}
+			}
+
 		/*!
 		 * \brief Wait while queue becomes empty.
 		 *
@@ -266,6 +330,22 @@ class basic_event_queue_t
 		//! Maximum count of demands to be processed consequently.
 		const std::size_t m_max_demands_at_once;
 
+		/*!
+		 * \brief Time slice for the processing of demands.
+		 *
+		 * Zero means that m_max_demands_at_once is used.
+		 *
+		 * \since v.5.8.5
+		 */
+		const std::chrono::steady_clock::duration m_time_slice;
+
+		/*!
+		 * \brief Average duration of a demand in the time-sliced mode.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::chrono::steady_clock::duration m_avg_demand_duration{};
+
 		//! Object's lock.
 		spinlock_t m_lock;
 
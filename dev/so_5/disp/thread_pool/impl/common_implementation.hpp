@@ -17,9 +17,19 @@
 #include <so_5/disp/reuse/queue_of_queues.hpp>
 #include <so_5/disp/reuse/thread_pool_stats.hpp>
 
+#include <so_5/disp/thread_pool/pub.hpp>
+
+#include <so_5/details/invoke_noexcept_code.hpp>
 #include <so_5/details/rollback_on_exception.hpp>
+#include <so_5/details/suppress_exceptions.hpp>
+
+#include <so_5/error_logger.hpp>
+#include <so_5/optional.hpp>
 
+#include <algorithm>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 namespace so_5 {
 
@@ -195,6 +205,12 @@ class dispatcher_t final
 		dispatcher_t & operator=( const dispatcher_t & ) = delete;
 
 		//! Constructor.
+		/*!
+		 * \note
+		 * If \a elastic isn't empty then \a thread_count is treated
+		 * as the max count of work threads and only
+		 * elastic_params_t::min_threads() threads are created at the start.
+		 */
 		template< typename Dispatcher_Params >
 		dispatcher_t(
 			environment_t & env,
@@ -202,26 +218,33 @@ class dispatcher_t final
 				& disp_params,
 			const std::string_view name_base,
 			std::size_t thread_count,
-			const so_5::disp::mpmc_queue_traits::queue_params_t & queue_params )
+			const so_5::disp::mpmc_queue_traits::queue_params_t & queue_params,
+			const so_5::optional< elastic_params_t > & elastic = {} )
 			:	m_queue{ queue_params, thread_count }
-			,	m_thread_count( thread_count )
+			,	m_thread_count( elastic ?
+					std::min( elastic->min_threads(), thread_count ) :
+					thread_count )
+			,	m_env{ env }
+			,	m_work_thread_factory{
+					so_5::disp::reuse::actual_work_thread_factory_to_use(
+							disp_params, env )
+				}
+			,	m_elastic{ elastic }
 			,	m_data_source( stats_supplier() )
 			{
 				m_threads.reserve( thread_count );
 
+				if( m_elastic )
+					{
+						m_queue.set_thread_count( m_thread_count );
+						m_retired_threads.reserve( thread_count );
+					}
+
 				for( std::size_t i = 0; i != m_thread_count; ++i )
 				{
-					// Since v.5.7.3 an instance of the actual work thread
-					// has to be acquired via factory.
-					auto work_thread_holder = acquire_work_thread(
-							disp_params, env );
-
-					m_threads.emplace_back( std::unique_ptr< Work_Thread >(
-								new Work_Thread{
-										outliving_mutable(m_queue),
-										std::move(work_thread_holder)
-								} ) );
+					m_threads.push_back( make_work_thread() );
 				}
+				m_active_threads = m_thread_count;
 
 				m_data_source.get().set_data_sources_name_base(
 						Adaptations::dispatcher_type_name(),
@@ -237,11 +260,24 @@ class dispatcher_t final
 
 				for( auto & t : m_threads )
 					t->start();
+
+				if( m_elastic )
+					m_manager_thread = std::thread{ [this] { manager_body(); } };
 			}
 
 		void
 		shutdown_then_wait() noexcept
 			{
+				if( m_manager_thread.joinable() )
+					{
+						{
+							std::lock_guard< std::mutex > lock{ m_manager_lock };
+							m_manager_shutdown = true;
+						}
+						m_manager_wakeup.notify_one();
+						m_manager_thread.join();
+					}
+
 				m_queue.shutdown();
 
 				for( auto & t : m_threads )
@@ -323,13 +359,104 @@ class dispatcher_t final
 				undo_preallocation_for_agent( agent );
 			}
 
+		/*!
+		 * \brief Get access to the dispatcher queue.
+		 *
+		 * Can be used for tuning the dispatcher queue.
+		 *
+		 * \attention
+		 * Must be called only before start().
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		Dispatcher_Queue &
+		dispatcher_queue() noexcept
+			{
+				return m_queue;
+			}
+
 	private :
 		//! Queue for active agent's queues.
 		Dispatcher_Queue m_queue;
 
 		//! Count of working threads.
+		/*!
+		 * \note
+		 * It's the initial count of threads in the elastic mode.
+		 */
 		const std::size_t m_thread_count;
 
+		/*!
+		 * \brief SObjectizer Environment to work in.
+		 *
+		 * \since v.5.8.5
+		 */
+		environment_t & m_env;
+
+		/*!
+		 * \brief Factory for work threads.
+		 *
+		 * \since v.5.8.5
+		 */
+		const abstract_work_thread_factory_shptr_t m_work_thread_factory;
+
+		/*!
+		 * \brief Parameters of the elastic mode.
+		 *
+		 * Empty value means that the elastic mode isn't used.
+		 *
+		 * \since v.5.8.5
+		 */
+		const so_5::optional< elastic_params_t > m_elastic;
+
+		/*!
+		 * \brief Count of work threads those aren't retired.
+		 *
+		 * \note
+		 * Is modified only by the manager thread after the start.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::size_t m_active_threads{};
+
+		/*!
+		 * \brief Buffer for conditions of retired work threads.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::vector< so_5::disp::mpmc_queue_traits::condition_t * >
+				m_retired_threads;
+
+		/*!
+		 * \brief Thread that creates and stops work threads in the
+		 * elastic mode.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::thread m_manager_thread;
+
+		/*!
+		 * \brief Lock for the shutdown flag of the manager thread.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::mutex m_manager_lock;
+
+		/*!
+		 * \brief Condition for the wakeup of the manager thread.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::condition_variable m_manager_wakeup;
+
+		/*!
+		 * \brief Shutdown flag for the manager thread.
+		 *
+		 * \since v.5.8.5
+		 */
+		bool m_manager_shutdown{ false };
+
 		//! Pool of work threads.
 		std::vector< std::unique_ptr< Work_Thread > > m_threads;
 
@@ -355,6 +482,157 @@ class dispatcher_t final
 		stats::manually_registered_source_holder_t< tp_stats::data_source_t >
 				m_data_source;
 
+		/*!
+		 * \brief Create a new work thread object.
+		 *
+		 * The thread isn't started.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		std::unique_ptr< Work_Thread >
+		make_work_thread()
+			{
+				// Since v.5.7.3 an instance of the actual work thread
+				// has to be acquired via factory.
+				auto & thread = m_work_thread_factory->acquire( m_env );
+				work_thread_holder_t work_thread_holder =
+						so_5::details::invoke_noexcept_code(
+							[&]() -> work_thread_holder_t {
+								return { thread, m_work_thread_factory };
+							} );
+
+				return std::unique_ptr< Work_Thread >(
+						new Work_Thread{
+								outliving_mutable(m_queue),
+								std::move(work_thread_holder)
+						} );
+			}
+
+		/*!
+		 * \brief Body of the manager thread for the elastic mode.
+		 *
+		 * \since v.5.8.5
+		 */
+		void
+		manager_body()
+			{
+				using clock_t = std::chrono::steady_clock;
+
+				// The time point from which there are idle work threads.
+				so_5::optional< clock_t::time_point > idle_since;
+
+				std::unique_lock< std::mutex > lock{ m_manager_lock };
+				while( !m_manager_wakeup.wait_for(
+						lock,
+						m_elastic->check_period(),
+						[this]{ return m_manager_shutdown; } ) )
+					{
+						lock.unlock();
+
+						join_retired_threads();
+
+						const auto load = m_queue.query_load();
+						if( 0u == load.m_waiting_threads )
+							{
+								idle_since.reset();
+
+								if( load.m_queue_size > m_elastic->backlog_threshold() &&
+										m_active_threads < m_elastic->max_threads() )
+									try_add_work_thread();
+							}
+						else
+							{
+								const auto now = clock_t::now();
+								if( !idle_since )
+									idle_since = now;
+								else if( now - *idle_since >= m_elastic->keep_alive() &&
+										m_active_threads > m_elastic->min_threads() &&
+										m_queue.try_retire_one_waiting_thread() )
+									{
+										--m_active_threads;
+										// The next thread will be retired only after
+										// yet another keep_alive period.
+										idle_since = now;
+									}
+							}
+
+						lock.lock();
+					}
+			}
+
+		/*!
+		 * \brief Creation and start of a new work thread.
+		 *
+		 * An exception is logged and ignored because the dispatcher
+		 * can continue its work with the current count of threads.
+		 *
+		 * \since v.5.8.5
+		 */
+		void
+		try_add_work_thread() noexcept
+			{
+				try
+					{
+						auto thread = make_work_thread();
+						auto & ref = *thread;
+						{
+							std::lock_guard< std::mutex > lock{ m_lock };
+							m_threads.push_back( std::move(thread) );
+						}
+
+						m_queue.increment_thread_count();
+						++m_active_threads;
+
+						ref.start();
+					}
+				catch( const std::exception & x )
+					{
+						so_5::details::suppress_exceptions( [&] {
+								SO_5_LOG_ERROR( m_env.error_logger(), stream ) {
+									stream << "unable to create a new work thread "
+											"for elastic "
+											<< Adaptations::dispatcher_type_name()
+											<< " dispatcher: " << x.what();
+								}
+							} );
+					}
+			}
+
+		/*!
+		 * \brief Join and destroy work threads those have been retired.
+		 *
+		 * \since v.5.8.5
+		 */
+		void
+		join_retired_threads() noexcept
+			{
+				m_queue.take_retired( m_retired_threads );
+				for( const auto * condition : m_retired_threads )
+					{
+						std::unique_ptr< Work_Thread > retired;
+						{
+							std::lock_guard< std::mutex > lock{ m_lock };
+							auto it = std::find_if( m_threads.begin(), m_threads.end(),
+									[condition]( const auto & t ) {
+										return t->condition() == condition;
+									} );
+							if( it != m_threads.end() )
+								{
+									retired = std::move( *it );
+									m_threads.erase( it );
+								}
+						}
+
+						// The retired thread has finished its work or is finishing
+						// it now. The holder of the thread is returned to the
+						// factory during the destruction of the work thread object.
+						if( retired )
+							retired->join();
+					}
+				m_retired_threads.clear();
+			}
+
 		//! Creation event queue for an agent with individual FIFO.
 		void
 		bind_agent_with_inidividual_fifo(
@@ -60,7 +60,8 @@ class agent_queue_t
 			//! Parameters for the queue.
 			const bind_params_t & params )
 			:	basic_event_queue_t{
-					params.query_max_demands_at_once()
+					params.query_max_demands_at_once(),
+					params.query_time_slice()
 				}
 			,	m_disp_queue{ disp_queue.get() }
 			{}
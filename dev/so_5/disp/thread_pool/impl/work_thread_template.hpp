@@ -270,6 +270,19 @@ class work_thread_template_t final : public Impl
 				return this->m_thread_id;
 			}
 
+		/*!
+		 * \brief Get the condition object used for waiting in the
+		 * dispatcher queue.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		const so_5::disp::mpmc_queue_traits::condition_t *
+		condition() const noexcept
+			{
+				return this->m_condition.get();
+			}
+
 	private :
 		//! Thread body method.
 		void
@@ -345,6 +358,9 @@ class work_thread_template_t final : public Impl
 		typename agent_queue_t::emptyness_t
 		process_queue( agent_queue_t & queue )
 			{
+				if( queue.is_time_sliced() )
+					return this->process_time_sliced_queue( queue );
+
 				std::size_t demands_processed = 0;
 				typename agent_queue_t::pop_result_t pop_result;
 
@@ -366,6 +382,44 @@ class work_thread_template_t final : public Impl
 
 				return pop_result.m_emptyness;
 			}
+
+		/*!
+		 * \brief Processing of demands from agent queue in the
+		 * time-sliced mode.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		typename agent_queue_t::emptyness_t
+		process_time_sliced_queue( agent_queue_t & queue )
+			{
+				using clock_type_t = std::chrono::steady_clock;
+
+				const auto started_at = clock_type_t::now();
+				auto last_finished_at = started_at;
+				typename agent_queue_t::pop_result_t pop_result;
+
+				do
+					{
+						auto & d = queue.front();
+
+						this->work_started();
+
+						d.call_handler( this->m_thread_id );
+
+						this->work_finished();
+
+						const auto finished_at = clock_type_t::now();
+						pop_result = queue.pop(
+								finished_at - started_at,
+								finished_at - last_finished_at );
+						last_finished_at = finished_at;
+					}
+				while( agent_queue_t::processing_continuation_t::enabled ==
+						pop_result.m_continuation );
+
+				return pop_result.m_emptyness;
+			}
 	};
 
 } /* namespace work_thread_details */
@@ -152,8 +152,11 @@ class actual_dispatcher_implementation_t final
 					env.get(),
 					params,
 					name_base,
-					params.thread_count(),
-					params.queue_params()
+					params.elastic() ?
+							params.elastic()->max_threads() :
+							params.thread_count(),
+					params.queue_params(),
+					params.elastic()
 				}
 			{
 				m_impl.start( env.get() );
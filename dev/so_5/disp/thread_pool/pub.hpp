@@ -21,6 +21,9 @@
 #include <so_5/disp/reuse/work_thread_factory_params.hpp>
 #include <so_5/disp/reuse/default_thread_pool_size.hpp>
 
+#include <so_5/optional.hpp>
+
+#include <chrono>
 #include <string_view>
 #include <thread>
 #include <utility>
@@ -41,6 +44,128 @@ namespace thread_pool
  */
 namespace queue_traits = so_5::disp::mpmc_queue_traits;
 
+//
+// elastic_params_t
+//
+/*!
+ * \brief Parameters for the elastic mode of %thread_pool dispatcher.
+ *
+ * In the elastic mode the dispatcher starts with min_threads() work
+ * threads. A special manager thread checks the state of the dispatcher
+ * every check_period(). If all work threads are busy and the count of
+ * non-empty event queues waiting for a thread is greater than
+ * backlog_threshold() then a new work thread is created (but the total
+ * count of work threads doesn't exceed max_threads()).
+ *
+ * If there are idle work threads during keep_alive() then one of
+ * them is stopped (but the total count of work threads doesn't become
+ * less than min_threads()).
+ *
+ * Usage example:
+ * \code
+ * using namespace so_5::disp::thread_pool;
+ * auto disp = make_dispatcher( env, "workers",
+ * 	disp_params_t{}
+ * 		.elastic( elastic_params_t{ 2, 16 }
+ * 			.keep_alive( std::chrono::seconds{ 30 } )
+ * 			.backlog_threshold( 4 ) ) );
+ * \endcode
+ *
+ * \note
+ * Work threads for the elastic mode are acquired from a work thread
+ * factory when they are necessary and are returned back when they are
+ * stopped.
+ *
+ * \since v.5.8.5
+ */
+class elastic_params_t
+	{
+	public :
+		//! Initializing constructor.
+		/*!
+		 * Value 0 for \a min_threads is treated as 1.
+		 * If \a max_threads is less than \a min_threads then
+		 * \a min_threads is used as \a max_threads.
+		 */
+		elastic_params_t(
+			std::size_t min_threads,
+			std::size_t max_threads )
+			:	m_min_threads{ min_threads ? min_threads : 1u }
+			,	m_max_threads{ max_threads < m_min_threads ?
+					m_min_threads : max_threads }
+			{}
+
+		//! Getter for the min count of work threads.
+		[[nodiscard]]
+		std::size_t
+		min_threads() const noexcept { return m_min_threads; }
+
+		//! Getter for the max count of work threads.
+		[[nodiscard]]
+		std::size_t
+		max_threads() const noexcept { return m_max_threads; }
+
+		//! Setter for the time an idle thread can live.
+		elastic_params_t &
+		keep_alive( std::chrono::steady_clock::duration v ) noexcept
+			{
+				m_keep_alive = v;
+				return *this;
+			}
+
+		//! Getter for the time an idle thread can live.
+		[[nodiscard]]
+		std::chrono::steady_clock::duration
+		keep_alive() const noexcept { return m_keep_alive; }
+
+		//! Setter for the count of waiting event queues that leads
+		//! to the creation of a new thread.
+		elastic_params_t &
+		backlog_threshold( std::size_t v ) noexcept
+			{
+				m_backlog_threshold = v;
+				return *this;
+			}
+
+		//! Getter for the count of waiting event queues that leads
+		//! to the creation of a new thread.
+		[[nodiscard]]
+		std::size_t
+		backlog_threshold() const noexcept { return m_backlog_threshold; }
+
+		//! Setter for the period of checking the state of the dispatcher.
+		elastic_params_t &
+		check_period( std::chrono::steady_clock::duration v ) noexcept
+			{
+				m_check_period = v;
+				return *this;
+			}
+
+		//! Getter for the period of checking the state of the dispatcher.
+		[[nodiscard]]
+		std::chrono::steady_clock::duration
+		check_period() const noexcept { return m_check_period; }
+
+	private :
+		//! Min count of work threads.
+		std::size_t m_min_threads;
+
+		//! Max count of work threads.
+		std::size_t m_max_threads;
+
+		//! Time an idle thread can live.
+		std::chrono::steady_clock::duration m_keep_alive{
+				std::chrono::seconds{ 60 } };
+
+		//! Count of waiting event queues that leads to the creation
+		//! of a new thread.
+		std::size_t m_backlog_threshold{ 0u };
+
+		//! Period of checking the state of the dispatcher.
+		std::chrono::steady_clock::duration m_check_period{
+				std::chrono::milliseconds{ 10 } };
+	};
+
 //
 // disp_params_t
 //
@@ -78,6 +203,7 @@ class disp_params_t
 
 				swap( a.m_thread_count, b.m_thread_count );
 				swap( a.m_queue_params, b.m_queue_params );
+				swap( a.m_elastic, b.m_elastic );
 			}
 
 		//! Setter for thread count.
@@ -134,6 +260,33 @@ class disp_params_t
 				return m_queue_params;
 			}
 
+		/*!
+		 * \brief Turn the elastic mode on.
+		 *
+		 * \note
+		 * The value of thread_count() is ignored in the elastic mode.
+		 *
+		 * \since v.5.8.5
+		 */
+		disp_params_t &
+		elastic( elastic_params_t p )
+			{
+				m_elastic = std::move(p);
+				return *this;
+			}
+
+		/*!
+		 * \brief Getter for parameters of the elastic mode.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		const so_5::optional< elastic_params_t > &
+		elastic() const noexcept
+			{
+				return m_elastic;
+			}
+
 	private :
 		//! Count of working threads.
 		/*!
@@ -142,6 +295,14 @@ class disp_params_t
 		std::size_t m_thread_count = { 0 };
 		//! Queue parameters.
 		queue_traits::queue_params_t m_queue_params;
+		/*!
+		 * \brief Parameters of the elastic mode.
+		 *
+		 * Empty value means that the elastic mode isn't used.
+		 *
+		 * \since v.5.8.5
+		 */
+		so_5::optional< elastic_params_t > m_elastic;
 	};
 
 //
@@ -217,12 +378,66 @@ class bind_params_t
 				return m_max_demands_at_once;
 			}
 
+		//! Set time slice for the processing of demands from one queue.
+		/*!
+		 * If time slice is set then the count of demands to be processed
+		 * at once is adaptive: a work thread processes demands from
+		 * a queue while the next demand is expected to finish within
+		 * the time slice. The expected duration of a demand is the
+		 * moving average of durations of previous demands from that queue.
+		 *
+		 * It means that many cheap demands are processed at once, but
+		 * a queue with expensive demands gives the work thread away
+		 * after every demand.
+		 *
+		 * The value of max_demands_at_once() is ignored in that mode.
+		 *
+		 * Usage example:
+		 * \code
+		 * auto disp = so_5::disp::thread_pool::make_dispatcher( env, 4 );
+		 * coop.make_agent_with_binder< my_agent >(
+		 * 	disp.binder( so_5::disp::thread_pool::bind_params_t{}
+		 * 		.time_slice( std::chrono::microseconds{ 200 } ) ) );
+		 * \endcode
+		 *
+		 * \note
+		 * Zero value turns the time-sliced mode off.
+		 *
+		 * \since v.5.8.5
+		 */
+		bind_params_t &
+		time_slice( std::chrono::steady_clock::duration v )
+			{
+				m_time_slice = v;
+				return *this;
+			}
+
+		//! Get time slice for the processing of demands from one queue.
+		/*!
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		std::chrono::steady_clock::duration
+		query_time_slice() const
+			{
+				return m_time_slice;
+			}
+
 	private :
 		//! FIFO type.
 		fifo_t m_fifo = { fifo_t::cooperation };
 
 		//! Maximum count of demands to be processed at once.
 		std::size_t m_max_demands_at_once = { 4 };
+
+		/*!
+		 * \brief Time slice for the processing of demands.
+		 *
+		 * Zero means that m_max_demands_at_once is used.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::chrono::steady_clock::duration m_time_slice{};
 	};
 
 //
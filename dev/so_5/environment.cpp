@@ -66,6 +66,7 @@ environment_params_t::environment_params_t(
 	,	m_event_queue_hook( std::move(other.m_event_queue_hook) )
 	,	m_work_thread_factory( std::move(other.m_work_thread_factory) )
 	,	m_default_subscription_storage_factory( std::move(other.m_default_subscription_storage_factory) )
+	,	m_final_dereg_thread_count( other.m_final_dereg_thread_count )
 {}
 
 environment_params_t::~environment_params_t()
@@ -111,6 +112,8 @@ swap( environment_params_t & a, environment_params_t & b ) noexcept
 	swap( a.m_work_thread_factory, b.m_work_thread_factory );
 
 	swap( a.m_default_subscription_storage_factory, b.m_default_subscription_storage_factory );
+
+	swap( a.m_final_dereg_thread_count, b.m_final_dereg_thread_count );
 }
 
 environment_params_t &
@@ -662,6 +662,59 @@ class SO_5_TYPE environment_params_t
 				return m_default_subscription_storage_factory;
 			}
 
+		/*!
+		 * \brief Set the count of threads to be used for the final
+		 * deregistration of coops.
+		 *
+		 * By default the final deregistration of all coops is performed
+		 * on a single dedicated thread. It can be a bottleneck if a lot
+		 * of coops are deregistered at once. In that case the final
+		 * deregistration can be spread across several threads.
+		 *
+		 * A parent coop is always finally deregistered after the completion
+		 * of the final deregistration of all its children.
+		 *
+		 * Usage example:
+		 * \code
+		 * so_5::launch( [](so_5::environment_t & env) {...},
+		 * 	[](so_5::environment_params_t & params) {
+		 * 		params.final_dereg_thread_count( 4u );
+		 * 	} );
+		 * \endcode
+		 *
+		 * \attention
+		 * If \a count is greater than 1 then coop dereg notificators and
+		 * coop_listener_t::on_deregistered() can be called from different
+		 * threads at the same time.
+		 *
+		 * \note
+		 * Value 0 is treated as 1.
+		 *
+		 * \note
+		 * This value is used only by the default multithreaded environment
+		 * infrastructure (see so_5::env_infrastructures::default_mt).
+		 *
+		 * \since v.5.8.5
+		 */
+		environment_params_t &
+		final_dereg_thread_count( std::size_t count ) noexcept
+			{
+				m_final_dereg_thread_count = count ? count : 1u;
+				return *this;
+			}
+
+		/*!
+		 * \brief Get the count of threads to be used for the final
+		 * deregistration of coops.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]] std::size_t
+		final_dereg_thread_count() const noexcept
+			{
+				return m_final_dereg_thread_count;
+			}
+
 		/*!
 		 * \name Methods for internal use only.
 		 * \{
@@ -883,6 +936,13 @@ class SO_5_TYPE environment_params_t
 		 * \since v.5.8.2
 		 */
 		subscription_storage_factory_t m_default_subscription_storage_factory;
+
+		/*!
+		 * \brief Count of threads for the final deregistration of coops.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::size_t m_final_dereg_thread_count{ 1u };
 };
 
 //
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <functional>
+#include <chrono>
 
 namespace so_5 {
 
@@ -120,6 +121,20 @@ class SO_5_TYPE environment_infrastructure_t
 				 * \since v.5.5.12
 				 */
 				std::size_t m_final_dereg_coop_count;
+
+				/*!
+				 * \brief How long the oldest coop waits for the final
+				 * deregistration.
+				 *
+				 * It's a time since the moment when the oldest coop that
+				 * isn't taken by a final deregistration thread yet became
+				 * ready for the final deregistration. This value is zero if
+				 * there is no such coops or if an infrastructure doesn't
+				 * collect this info.
+				 *
+				 * \since v.5.8.5
+				 */
+				std::chrono::steady_clock::duration m_final_dereg_wait_time{};
 			};
 
 		//! Do actual launch of SObjectizer's Environment.
@@ -19,6 +19,8 @@
 
 #include <so_5/message.hpp>
 
+#include <so_5/details/small_function.hpp>
+
 namespace so_5
 {
 
@@ -30,8 +32,15 @@ namespace so_5
  * v.5.3.0
  *
  * \brief Type of event handler method.
+ *
+ * \note
+ * Since v.5.8.5 it isn't std::function anymore. It's a lightweight
+ * wrapper that can hold event handlers created by SObjectizer without
+ * memory allocations.
  */
-using event_handler_method_t = std::function< void(message_ref_t &) >;
+using event_handler_method_t = details::small_function_t<
+		void(message_ref_t &),
+		4u * sizeof(void*) >;
 
 struct execution_demand_t;
 
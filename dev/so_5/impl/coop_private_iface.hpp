@@ -139,6 +139,50 @@ class coop_private_iface_t
 		{
 			return std::exchange( coop.m_next_in_final_dereg_chain, coop_shptr_t{} );
 		}
+
+		/*!
+		 * \brief Get a pointer to the next coop in the chain of coops
+		 * for the final deregistration without extracting it.
+		 *
+		 * It may return nullptr if \a coop is the last item in this chain.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		static coop_t *
+		next_in_final_dereg_chain(
+			const coop_t & coop ) noexcept
+		{
+			return coop.m_next_in_final_dereg_chain.get();
+		}
+
+		/*!
+		 * \brief Store the moment when the coop was added to the chain
+		 * of coops for the final deregistration.
+		 *
+		 * \since v.5.8.5
+		 */
+		static void
+		set_final_dereg_enqueued_at(
+			coop_t & coop,
+			std::chrono::steady_clock::time_point at ) noexcept
+		{
+			coop.m_final_dereg_enqueued_at = at;
+		}
+
+		/*!
+		 * \brief Get the moment when the coop was added to the chain
+		 * of coops for the final deregistration.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		static std::chrono::steady_clock::time_point
+		final_dereg_enqueued_at(
+			const coop_t & coop ) noexcept
+		{
+			return coop.m_final_dereg_enqueued_at;
+		}
 };
 
 } /* namespace impl */
@@ -136,6 +136,20 @@ class final_dereg_chain_holder_t
 				return !static_cast<bool>( m_final_dereg_chain_head );
 			}
 
+		/*!
+		 * \brief Get the first coop in the chain without extracting it.
+		 *
+		 * It returns nullptr if the chain is empty.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		const coop_t *
+		head() const noexcept
+			{
+				return m_final_dereg_chain_head.get();
+			}
+
 		[[nodiscard]]
 		coop_shptr_t
 		giveout_current_chain() noexcept
@@ -146,6 +160,43 @@ class final_dereg_chain_holder_t
 				m_final_dereg_chain_tail = coop_shptr_t{};
 				m_final_dereg_chain_size = 0u;
 
+				return head;
+			}
+
+		/*!
+		 * \brief Extract no more than \a max_items coops from the head
+		 * of the current chain.
+		 *
+		 * The remaining part of the chain is kept in the holder.
+		 *
+		 * \note
+		 * If \a max_items is 0 then it's treated as 1.
+		 *
+		 * \since v.5.8.5
+		 */
+		[[nodiscard]]
+		coop_shptr_t
+		giveout_part( std::size_t max_items ) noexcept
+			{
+				if( !max_items )
+					max_items = 1u;
+
+				if( max_items >= m_final_dereg_chain_size )
+					return giveout_current_chain();
+
+				coop_shptr_t head = std::move(m_final_dereg_chain_head);
+
+				// Find the last item of the part to be extracted.
+				coop_t * last = head.get();
+				for( std::size_t i = 1u; i < max_items; ++i )
+					last = coop_private_iface_t::next_in_final_dereg_chain( *last );
+
+				// The rest of the chain has to be detached from the extracted part.
+				m_final_dereg_chain_head =
+						coop_private_iface_t::giveout_next_in_final_dereg_chain(
+								*last );
+				m_final_dereg_chain_size -= max_items;
+
 				return head;
 			}
 	};
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include <so_5/types.hpp>
@@ -585,6 +586,213 @@ public :
 		}
 };
 
+//
+// keyed_subscribers_t
+//
+/*!
+ * \brief A special container for subscribers with keyed delivery filters.
+ *
+ * Subscribers are indexed by hashes of keys of their filters. Filters
+ * with different key extractors are held in different indexes.
+ *
+ * \since v.5.8.5
+ */
+class keyed_subscribers_t
+{
+	//! Information about one subscriber.
+	struct entry_t
+		{
+			//! Information about the subscription.
+			subscription_info_with_sink_t m_info;
+
+			//! Delivery filter of the subscriber.
+			const keyed_delivery_filter_t * m_filter;
+		};
+
+	/*!
+	 * \brief Predicate to be used for comparing keys in subscriber map.
+	 */
+	struct subscriber_ptr_compare_type
+		{
+			[[nodiscard]]
+			bool
+			operator()(
+				abstract_message_sink_t * a, abstract_message_sink_t * b ) const noexcept
+				{
+					return abstract_message_sink_t::special_sink_ptr_compare( a, b );
+				}
+		};
+
+	using entries_map_t = std::map<
+			abstract_message_sink_t *,
+			entry_t,
+			subscriber_ptr_compare_type
+		>;
+
+	//! Index from key hash to subscribers.
+	using index_t = std::unordered_multimap< std::size_t, entry_t * >;
+
+	//! Indexes for different key extractors.
+	using indexes_map_t = std::map< std::type_index, index_t >;
+
+	//! All subscribers with keyed filters.
+	entries_map_t m_entries;
+
+	//! Indexes for subscribers.
+	indexes_map_t m_indexes;
+
+	void
+	add_to_index( entry_t & entry )
+		{
+			m_indexes[ entry.m_filter->key_extractor_type() ].emplace(
+					entry.m_filter->filter_key_hash(),
+					std::addressof(entry) );
+		}
+
+	void
+	remove_from_index( entry_t & entry ) noexcept
+		{
+			auto it_index = m_indexes.find( entry.m_filter->key_extractor_type() );
+			auto & index = it_index->second;
+
+			auto range = index.equal_range( entry.m_filter->filter_key_hash() );
+			for( auto it = range.first; it != range.second; ++it )
+				if( it->second == std::addressof(entry) )
+					{
+						index.erase( it );
+						break;
+					}
+
+			if( index.empty() )
+				m_indexes.erase( it_index );
+		}
+
+public :
+	[[nodiscard]]
+	bool
+	empty() const noexcept
+		{
+			return m_entries.empty();
+		}
+
+	//! Find information about a subscriber.
+	/*!
+	 * \return nullptr if there is no such subscriber.
+	 */
+	[[nodiscard]]
+	subscription_info_with_sink_t *
+	find( abstract_message_sink_t & subscriber ) noexcept
+		{
+			auto it = m_entries.find( std::addressof(subscriber) );
+			return it != m_entries.end() ? std::addressof(it->second.m_info) : nullptr;
+		}
+
+	//! Add a new subscriber or replace information about the
+	//! existing one.
+	void
+	insert_or_replace(
+		abstract_message_sink_t & subscriber,
+		subscription_info_with_sink_t info,
+		const keyed_delivery_filter_t & filter )
+		{
+			auto it = m_entries.find( std::addressof(subscriber) );
+			if( it != m_entries.end() )
+				{
+					remove_from_index( it->second );
+					it->second = entry_t{ info, std::addressof(filter) };
+				}
+			else
+				it = m_entries.emplace(
+						std::addressof(subscriber),
+						entry_t{ info, std::addressof(filter) } ).first;
+
+			try
+				{
+					add_to_index( it->second );
+				}
+			catch( ... )
+				{
+					m_entries.erase( it );
+					throw;
+				}
+		}
+
+	//! Remove a subscriber.
+	void
+	erase( abstract_message_sink_t & subscriber ) noexcept
+		{
+			auto it = m_entries.find( std::addressof(subscriber) );
+			if( it != m_entries.end() )
+				{
+					remove_from_index( it->second );
+					m_entries.erase( it );
+				}
+		}
+
+	//! Call a functor for every subscriber whose filter can accept
+	//! a message.
+	/*!
+	 * If the message is hidden by an envelope then the functor is called
+	 * for every subscriber.
+	 */
+	template< typename Lambda >
+	void
+	for_each_candidate(
+		const message_ref_t & message,
+		Lambda && lambda ) const
+		{
+			// Envelopes mustn't be inspected if there are no subscribers.
+			if( m_entries.empty() )
+				return;
+
+			auto opt_msg = so_5::enveloped_msg::message_to_be_inspected( message );
+			if( !opt_msg )
+				{
+					for( const auto & kv : m_entries )
+						lambda( kv.second.m_info );
+					return;
+				}
+
+			for( const auto & kv : m_indexes )
+				{
+					const auto & index = kv.second;
+
+					// All filters in the index use the same rules for
+					// key extraction, so any of them can be used.
+					const auto hash = index.begin()->second->m_filter->
+							message_key_hash( **opt_msg );
+
+					auto range = index.equal_range( hash );
+					for( auto it = range.first; it != range.second; ++it )
+						lambda( it->second->m_info );
+				}
+		}
+};
+
+//
+// subscribers_t
+//
+/*!
+ * \brief Subscribers for one message type.
+ *
+ * \since v.5.8.5
+ */
+struct subscribers_t
+	{
+		//! Subscribers without keyed delivery filters.
+		subscriber_adaptive_container_t m_regular;
+
+		//! Subscribers with keyed delivery filters.
+		keyed_subscribers_t m_keyed;
+
+		[[nodiscard]]
+		bool
+		empty() const noexcept
+			{
+				return m_regular.empty() && m_keyed.empty();
+			}
+	};
+
 //
 // data_t
 //
@@ -619,7 +827,7 @@ struct data_t
 		 */
 		using messages_table_t = std::map<
 				std::type_index,
-				subscriber_adaptive_container_t >;
+				subscribers_t >;
 
 		//! Map of subscribers to messages.
 		messages_table_t m_subscribers;
@@ -742,16 +950,53 @@ class local_mbox_template
 			const delivery_filter_t & filter,
 			abstract_message_sink_t & subscriber ) override
 			{
-				insert_or_modify_subscriber(
+				// Keyed filters are held in a separate container.
+				// Information about the subscriber has to be moved
+				// between containers if the kind of filter changes.
+				const auto * keyed_filter =
+						dynamic_cast< const keyed_delivery_filter_t * >(
+								std::addressof(filter) );
+
+				modify_subscribers(
 						msg_type,
-						subscriber,
-						[&] {
-							return local_mbox_details::subscription_info_with_sink_t{
-									filter
-								};
-						},
-						[&]( local_mbox_details::subscription_info_with_sink_t & info ) {
-							info.set_filter( filter );
+						[&]( local_mbox_details::subscribers_t & subscribers ) {
+							auto * keyed_info = subscribers.m_keyed.find( subscriber );
+							if( keyed_filter )
+								{
+									local_mbox_details::subscription_info_with_sink_t info;
+
+									auto pos = subscribers.m_regular.find( subscriber );
+									if( keyed_info )
+										info = *keyed_info;
+									else if( pos != subscribers.m_regular.end() )
+										info = *pos;
+
+									info.set_filter( filter );
+									subscribers.m_keyed.insert_or_replace(
+											subscriber, info, *keyed_filter );
+
+									if( !keyed_info && pos != subscribers.m_regular.end() )
+										subscribers.m_regular.erase( pos );
+								}
+							else if( keyed_info )
+								{
+									auto info = *keyed_info;
+									info.set_filter( filter );
+									subscribers.m_regular.insert( subscriber, info );
+									subscribers.m_keyed.erase( subscriber );
+								}
+							else
+								{
+									auto pos = subscribers.m_regular.find( subscriber );
+									if( pos != subscribers.m_regular.end() )
+										pos->set_filter( filter );
+									else
+										subscribers.m_regular.insert(
+												subscriber,
+												local_mbox_details::subscription_info_with_sink_t{
+														filter
+													} );
+								}
 						} );
 			}
 
@@ -760,12 +1005,36 @@ class local_mbox_template
 			const std::type_index & msg_type,
 			abstract_message_sink_t & subscriber ) noexcept override
 			{
-				modify_and_remove_subscriber_if_needed(
-						msg_type,
-						subscriber,
-						[]( local_mbox_details::subscription_info_with_sink_t & info ) {
-							info.drop_filter();
-						} );
+				std::unique_lock< default_rw_spinlock_t > lock( m_lock );
+
+				auto it = m_subscribers.find( msg_type );
+				if( it != m_subscribers.end() )
+				{
+					auto & subscribers = it->second;
+
+					auto * keyed_info = subscribers.m_keyed.find( subscriber );
+					if( keyed_info )
+					{
+						// The subscriber has to be moved to the container
+						// for ordinary subscribers.
+						auto info = *keyed_info;
+						info.drop_filter();
+						if( !info.empty() )
+							subscribers.m_regular.insert( subscriber, info );
+
+						subscribers.m_keyed.erase( subscriber );
+					}
+					else
+						modify_and_remove_regular_subscriber_if_needed(
+								subscribers.m_regular,
+								subscriber,
+								[]( local_mbox_details::subscription_info_with_sink_t & info ) {
+									info.drop_filter();
+								} );
+
+					if( subscribers.empty() )
+						m_subscribers.erase( it );
+				}
 			}
 
 		environment_t &
@@ -775,43 +1044,76 @@ class local_mbox_template
 			}
 
 	private :
-		template< typename Info_Maker, typename Info_Changer >
+		/*!
+		 * \brief Find or create subscribers for a message type and
+		 * modify them.
+		 *
+		 * Empty subscribers are removed if \a modifier throws.
+		 *
+		 * \since v.5.8.5
+		 */
+		template< typename Modifier >
 		void
-		insert_or_modify_subscriber(
+		modify_subscribers(
 			const std::type_index & type_wrapper,
-			abstract_message_sink_t & subscriber,
-			Info_Maker maker,
-			Info_Changer changer )
+			Modifier && modifier )
 			{
 				std::unique_lock< default_rw_spinlock_t > lock( m_lock );
 
 				auto it = m_subscribers.find( type_wrapper );
 				if( it == m_subscribers.end() )
-				{
 					// There isn't such message type yet.
-					local_mbox_details::subscriber_adaptive_container_t container;
-					container.insert( subscriber, maker() );
+					it = m_subscribers.emplace(
+							type_wrapper,
+							local_mbox_details::subscribers_t{} ).first;
 
-					m_subscribers.emplace( type_wrapper, std::move( container ) );
+				try
+				{
+					modifier( it->second );
 				}
-				else
+				catch( ... )
 				{
-					auto & sinks = it->second;
-
-					auto pos = sinks.find( subscriber );
-					if( pos != sinks.end() )
-					{
-						// Agent is already in subscribers list.
-						// But its state must be updated.
-						changer( *pos );
-					}
-					else
-						// There is no subscriber in the container.
-						// It must be added.
-						sinks.insert( subscriber, maker() );
+					if( it->second.empty() )
+						m_subscribers.erase( it );
+					throw;
 				}
 			}
 
+		template< typename Info_Maker, typename Info_Changer >
+		void
+		insert_or_modify_subscriber(
+			const std::type_index & type_wrapper,
+			abstract_message_sink_t & subscriber,
+			Info_Maker maker,
+			Info_Changer changer )
+			{
+				modify_subscribers(
+						type_wrapper,
+						[&]( local_mbox_details::subscribers_t & subscribers ) {
+							if( auto * keyed_info = subscribers.m_keyed.find( subscriber ) )
+								{
+									// Subscriber has a keyed delivery filter.
+									// Only its state must be updated.
+									changer( *keyed_info );
+									return;
+								}
+
+							auto & sinks = subscribers.m_regular;
+
+							auto pos = sinks.find( subscriber );
+							if( pos != sinks.end() )
+							{
+								// Agent is already in subscribers list.
+								// But its state must be updated.
+								changer( *pos );
+							}
+							else
+								// There is no subscriber in the container.
+								// It must be added.
+								sinks.insert( subscriber, maker() );
+						} );
+			}
+
 		template< typename Info_Changer >
 		void
 		modify_and_remove_subscriber_if_needed(
@@ -824,25 +1126,45 @@ class local_mbox_template
 				auto it = m_subscribers.find( type_wrapper );
 				if( it != m_subscribers.end() )
 				{
-					auto & sinks = it->second;
+					auto & subscribers = it->second;
 
-					auto pos = sinks.find( subscriber );
-					if( pos != sinks.end() )
+					if( auto * keyed_info = subscribers.m_keyed.find( subscriber ) )
 					{
-						// Subscriber is found and must be modified.
-						changer( *pos );
-
-						// If info about subscriber becomes empty after modification
-						// then subscriber info must be removed.
-						if( pos->empty() )
-							sinks.erase( pos );
+						changer( *keyed_info );
+						if( keyed_info->empty() )
+							subscribers.m_keyed.erase( subscriber );
 					}
+					else
+						modify_and_remove_regular_subscriber_if_needed(
+								subscribers.m_regular,
+								subscriber,
+								changer );
 
-					if( sinks.empty() )
+					if( subscribers.empty() )
 						m_subscribers.erase( it );
 				}
 			}
 
+		template< typename Info_Changer >
+		static void
+		modify_and_remove_regular_subscriber_if_needed(
+			local_mbox_details::subscriber_adaptive_container_t & sinks,
+			abstract_message_sink_t & subscriber,
+			Info_Changer changer )
+			{
+				auto pos = sinks.find( subscriber );
+				if( pos != sinks.end() )
+				{
+					// Subscriber is found and must be modified.
+					changer( *pos );
+
+					// If info about subscriber becomes empty after modification
+					// then subscriber info must be removed.
+					if( pos->empty() )
+						sinks.erase( pos );
+				}
+			}
+
 		void
 		do_deliver_message_impl(
 			typename Tracing_Base::deliver_op_tracer const & tracer,
@@ -856,14 +1178,24 @@ class local_mbox_template
 				auto it = m_subscribers.find( msg_type );
 				if( it != m_subscribers.end() )
 					{
-						for( const auto & a : it->second )
-							do_deliver_message_to_subscriber(
-									a,
-									tracer,
-									delivery_mode,
-									msg_type,
-									message,
-									redirection_deep );
+						const auto deliver = [&](
+							const local_mbox_details::subscription_info_with_sink_t & a )
+							{
+								do_deliver_message_to_subscriber(
+										a,
+										tracer,
+										delivery_mode,
+										msg_type,
+										message,
+										redirection_deep );
+							};
+
+						for( const auto & a : it->second.m_regular )
+							deliver( a );
+
+						// Subscribers with keyed filters are checked only if
+						// keys of their filters can match the message's key.
+						it->second.m_keyed.for_each_candidate( message, deliver );
 					}
 				else
 					tracer.no_subscribers();
@@ -12,6 +12,11 @@
 
 #include <so_5/impl/message_sink_for_agent.hpp>
 
+#include <so_5/message_limit.hpp>
+
+#include <atomic>
+#include <memory>
+
 namespace so_5
 {
 
@@ -59,6 +64,139 @@ struct decrement_on_exception_t
 
 } /* namespace push_event_impl */
 
+//
+// sharded_message_counter_t
+//
+/*!
+ * \brief Sharded counter of messages for the sender's side of
+ * message limit.
+ *
+ * Every sender thread uses its own shard (threads are distributed
+ * between shards in round-robin manner, so a shard can be shared if
+ * there are more sender threads than shards). A sender increments the
+ * value in its shard (only if the limit isn't exceeded) and transfers the accumulated value into the main
+ * counter (control_block_t::m_count) only when the accumulated value
+ * reaches the flush threshold. So the main counter is modified by
+ * senders much more rarely.
+ *
+ * The receiver decrements the main counter as usual. It means that
+ * the main counter can temporarily hold a "negative" value (as a wrapped
+ * around unsigned value) because some of messages are still counted
+ * in shards. The real count of waiting messages is the sum of the main
+ * counter and all shards.
+ *
+ * A sender checks the limit by using the main counter and its own shard
+ * only, values in other shards aren't seen. Because every shard holds
+ * less than flush threshold value, the limit can be exceeded by no more
+ * than (shard_count-1)*(flush_threshold-1) messages. The flush threshold
+ * is selected that way to make this value not greater than
+ * sharded_counter_params_t::max_error().
+ *
+ * \since v.5.8.5
+ */
+class sharded_message_counter_t
+	{
+		//! Type of a single shard.
+		/*!
+		 * Every shard occupies its own cache line.
+		 */
+		struct alignas(64) shard_t
+			{
+				std::atomic_uint m_value{ 0u };
+			};
+
+		//! Count of shards.
+		const std::size_t m_shard_count;
+
+		//! Value of a shard for transferring to the main counter.
+		const unsigned int m_flush_threshold;
+
+		//! Shards.
+		std::unique_ptr< shard_t[] > m_shards;
+
+		[[nodiscard]]
+		static unsigned int
+		calculate_flush_threshold(
+			const so_5::message_limit::sharded_counter_params_t & params ) noexcept
+			{
+				if( 1u == params.shard_count() )
+					// The only shard is always visible to the sender,
+					// there is no need to flush it often.
+					return params.max_error() + 1u;
+
+				return static_cast< unsigned int >(
+						params.max_error() / ( params.shard_count() - 1u ) ) + 1u;
+			}
+
+		//! Get the index of the current thread to select a shard.
+		[[nodiscard]]
+		static std::size_t
+		current_thread_index() noexcept
+			{
+				static std::atomic< std::size_t > s_threads_counter{ 0u };
+				thread_local const std::size_t index =
+						s_threads_counter.fetch_add( 1u, std::memory_order_relaxed );
+
+				return index;
+			}
+
+	public:
+		//! Initializing constructor.
+		explicit sharded_message_counter_t(
+			const so_5::message_limit::sharded_counter_params_t & params )
+			:	m_shard_count{ params.shard_count() }
+			,	m_flush_threshold{ calculate_flush_threshold( params ) }
+			,	m_shards{ std::make_unique< shard_t[] >( m_shard_count ) }
+			{}
+
+		/*!
+		 * \brief An attempt to count a new message.
+		 *
+		 * \retval true the message is counted, it can be pushed to the queue.
+		 * \retval false the limit is reached, the message isn't counted.
+		 */
+		[[nodiscard]]
+		bool
+		try_increment(
+			const so_5::message_limit::control_block_t & control_block ) noexcept
+			{
+				auto & shard = m_shards[ current_thread_index() % m_shard_count ];
+
+				// The shard is incremented only if the limit isn't exceeded.
+				// NOTE: the shard can be shared between several threads and
+				// its value can be moved to the main counter by another thread
+				// at any moment. Because of that the shard must not be
+				// incremented and decremented back: the decrement could make
+				// the shard value negative. So the CAS loop is used.
+				unsigned int local = shard.m_value.load( std::memory_order_acquire );
+				do
+					{
+						// The main counter can hold a negative value (see the
+						// description of the class), so it has to be treated as
+						// a signed value.
+						const auto global = static_cast< int >(
+								control_block.m_count.load( std::memory_order_acquire ) );
+
+						if( static_cast< long long >( control_block.m_limit ) <
+								static_cast< long long >( global ) + local + 1 )
+							return false;
+					}
+				while( !shard.m_value.compare_exchange_weak(
+						local, local + 1u,
+						std::memory_order_acq_rel,
+						std::memory_order_acquire ) );
+
+				++local;
+
+				if( local >= m_flush_threshold )
+					control_block.m_count.fetch_add(
+							shard.m_value.exchange( 0u, std::memory_order_acq_rel ),
+							std::memory_order_acq_rel );
+
+				return true;
+			}
+	};
+
 //
 // message_sink_with_message_limit_t
 //
@@ -73,6 +211,42 @@ class message_sink_with_message_limit_t final
 		//! Run-time data for the message type.
 		so_5::message_limit::control_block_t m_control_block;
 
+		//! Sharded counter for the sender's side.
+		/*!
+		 * It's nullptr if the ordinary exact counter is used.
+		 *
+		 * \since v.5.8.5
+		 */
+		std::unique_ptr< sharded_message_counter_t > m_sharded_counter;
+
+		[[nodiscard]]
+		static std::unique_ptr< sharded_message_counter_t >
+		make_sharded_counter(
+			const optional< so_5::message_limit::sharded_counter_params_t > & params )
+			{
+				std::unique_ptr< sharded_message_counter_t > result;
+				if( params )
+					result = std::make_unique< sharded_message_counter_t >( *params );
+				return result;
+			}
+
+		//! An attempt to count a new message.
+		[[nodiscard]]
+		bool
+		try_increment_count() noexcept
+			{
+				if( m_sharded_counter )
+					return m_sharded_counter->try_increment( m_control_block );
+
+				if( m_control_block.m_limit < ++(m_control_block.m_count) )
+					{
+						--(m_control_block.m_count);
+						return false;
+					}
+
+				return true;
+			}
+
 	public:
 		//! Initializing constructor.
 		message_sink_with_message_limit_t(
@@ -86,6 +260,25 @@ class message_sink_with_message_limit_t final
 			,	m_control_block( limit, std::move( action ) )
 			{}
 
+		//! Initializing constructor for the case of sharded counter.
+		/*!
+		 * \since v.5.8.5
+		 */
+		message_sink_with_message_limit_t(
+			//! Owner of the sink.
+			partially_constructed_agent_ptr_t owner_ptr,
+			//! Limit for that message type.
+			unsigned int limit,
+			//! Reaction to the limit overflow.
+			so_5::message_limit::action_t action,
+			//! Parameters of sharded counter (if it's used).
+			const optional< so_5::message_limit::sharded_counter_params_t > &
+				sharded_counter )
+			:	message_sink_for_agent_t( owner_ptr )
+			,	m_control_block( limit, std::move( action ) )
+			,	m_sharded_counter( make_sharded_counter( sharded_counter ) )
+			{}
+
 		void
 		push_event(
 			mbox_id_t mbox_id,
@@ -95,10 +288,8 @@ class message_sink_with_message_limit_t final
 			unsigned int redirection_deep,
 			const message_limit::impl::action_msg_tracer_t * tracer ) override
 			{
-				if( m_control_block.m_limit < ++(m_control_block.m_count) )
+				if( !try_increment_count() )
 					{
-						--(m_control_block.m_count);
-
 						m_control_block.m_action(
 								so_5::message_limit::overlimit_context_t{
 										mbox_id,
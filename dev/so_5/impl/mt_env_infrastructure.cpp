@@ -19,6 +19,8 @@
 
 #include <so_5/disp/one_thread/pub.hpp>
 
+#include <so_5/details/rollback_on_exception.hpp>
+
 namespace so_5 {
 
 namespace env_infrastructures {
@@ -27,21 +29,71 @@ namespace default_mt {
 
 namespace impl {
 
+namespace {
+
+/*!
+ * \brief Info about the final deregistration thread that is
+ * running on the current thread.
+ *
+ * \since v.5.8.5
+ */
+struct final_dereg_thread_ctx_t
+	{
+		//! Repository that owns the current final deregistration thread.
+		/*!
+		 * It is nullptr if the current thread isn't a final
+		 * deregistration thread.
+		 */
+		const coop_repo_t * m_owner{ nullptr };
+
+		//! Chain for coops that became ready during the processing.
+		so_5::impl::final_dereg_chain_holder_t * m_local_chain{ nullptr };
+	};
+
+/*!
+ * \brief Context of the final deregistration for the current thread.
+ *
+ * \since v.5.8.5
+ */
+thread_local final_dereg_thread_ctx_t current_final_dereg_thread_ctx;
+
+} /* namespace anonymous */
+
 //
 // coop_repo_t
 //
 coop_repo_t::coop_repo_t(
 	outliving_reference_t< environment_t > env,
-	coop_listener_unique_ptr_t coop_listener )
+	coop_listener_unique_ptr_t coop_listener,
+	std::size_t final_dereg_thread_count )
 	:	coop_repository_basis_t( env, std::move(coop_listener) )
 	,	m_final_dereg_thread_shutdown_flag{ false }
+	,	m_final_dereg_thread_count{
+			final_dereg_thread_count ? final_dereg_thread_count : 1u }
 	{}
 
 void
 coop_repo_t::start()
 {
-	// A separate thread for doing the final dereg must be started.
-	m_final_dereg_thread = std::thread{ [this] { final_dereg_thread_body(); } };
+	// Separate threads for doing the final dereg must be started.
+	m_final_dereg_threads.reserve( m_final_dereg_thread_count );
+
+	so_5::details::do_with_rollback_on_exception(
+		[this] {
+			for( std::size_t i = 0u; i != m_final_dereg_thread_count; ++i )
+				m_final_dereg_threads.emplace_back(
+						[this] { final_dereg_thread_body(); } );
+		},
+		[this] {
+			// Already started threads have to be stopped.
+			{
+				std::lock_guard< std::mutex > lock{ m_final_dereg_chain_lock };
+				m_final_dereg_thread_shutdown_flag = true;
+				m_final_dereg_chain_cond.notify_all();
+			}
+			for( auto & t : m_final_dereg_threads )
+				t.join();
+		} );
 }
 
 void
@@ -53,19 +105,34 @@ coop_repo_t::finish()
 	// Deregistration of all cooperations should be finished.
 	wait_all_coop_to_deregister();
 
-	// Notify a dedicated thread and wait while it will be stopped.
+	// Notify dedicated threads and wait while they will be stopped.
 	{
 		std::lock_guard< std::mutex > lock{ m_final_dereg_chain_lock };
 		m_final_dereg_thread_shutdown_flag = true;
-		m_final_dereg_chain_cond.notify_one();
+		m_final_dereg_chain_cond.notify_all();
 	}
-	m_final_dereg_thread.join();
+	for( auto & t : m_final_dereg_threads )
+		t.join();
 }
 
 void
 coop_repo_t::ready_to_deregister_notify(
 	coop_shptr_t coop )
 {
+	// If we're on the final deregistration thread then the coop is
+	// a parent of a just deregistered child. This coop has to be
+	// processed on the same thread after the completion of the child.
+	auto & ctx = current_final_dereg_thread_ctx;
+	if( this == ctx.m_owner )
+	{
+		m_final_dereg_local_coop_count.fetch_add( 1u, std::memory_order_relaxed );
+		ctx.m_local_chain->append( std::move(coop) );
+		return;
+	}
+
+	so_5::impl::coop_private_iface_t::set_final_dereg_enqueued_at(
+			*coop, std::chrono::steady_clock::now() );
+
 	std::lock_guard< std::mutex > lck{ m_final_dereg_chain_lock };
 
 	// Update the final_dereg_chain.
@@ -124,23 +191,44 @@ coop_repo_t::wait_all_coop_to_deregister()
 environment_infrastructure_t::coop_repository_stats_t
 coop_repo_t::query_stats()
 {
-	const auto final_dereg_coops = [this]() {
-			std::lock_guard< std::mutex > lck{ m_final_dereg_chain_lock };
-			return m_final_dereg_chain.size();
-		}();
+	std::size_t final_dereg_coops;
+	std::chrono::steady_clock::duration final_dereg_wait_time{};
+	{
+		std::lock_guard< std::mutex > lck{ m_final_dereg_chain_lock };
+		final_dereg_coops = m_final_dereg_chain.size();
+
+		// The oldest coop is always at the head of the chain.
+		if( const auto * oldest = m_final_dereg_chain.head() )
+			final_dereg_wait_time = std::chrono::steady_clock::now() -
+					so_5::impl::coop_private_iface_t::final_dereg_enqueued_at(
+							*oldest );
+	}
+
+	// Coops in local chains of final deregistration threads are
+	// waiting too.
+	final_dereg_coops += m_final_dereg_local_coop_count.load(
+			std::memory_order_relaxed );
 
 	const auto basis_stats = coop_repository_basis_t::query_stats();
 
 	return {
 			basis_stats.m_total_coop_count,
 			basis_stats.m_total_agent_count,
-			final_dereg_coops
+			final_dereg_coops,
+			final_dereg_wait_time
 		};
 }
 
 void
 coop_repo_t::final_dereg_thread_body()
 {
+	// Coops those became ready for the final deregistration during
+	// processing on this thread will be collected here.
+	so_5::impl::final_dereg_chain_holder_t local_chain;
+	current_final_dereg_thread_ctx = final_dereg_thread_ctx_t{
+			this, &local_chain
+		};
+
 	std::unique_lock< std::mutex > lck{ m_final_dereg_chain_lock };
 
 	for( bool should_continue = true; should_continue; )
@@ -152,7 +240,7 @@ coop_repo_t::final_dereg_thread_body()
 		if( !m_final_dereg_chain.empty() )
 		{
 			// There are some coops to be deregistered.
-			process_current_final_dereg_chain( lck );
+			process_current_final_dereg_chain( lck, local_chain );
 
 			// Because the processing takes some time there is no need
 			// to sleep before new check for m_final_dereg_chain.
@@ -170,11 +258,14 @@ coop_repo_t::final_dereg_thread_body()
 			m_final_dereg_chain_cond.wait( lck );
 		}
 	}
+
+	current_final_dereg_thread_ctx = final_dereg_thread_ctx_t{};
 }
 
 void
 coop_repo_t::process_current_final_dereg_chain(
-	std::unique_lock< std::mutex > & lck ) noexcept
+	std::unique_lock< std::mutex > & lck,
+	so_5::impl::final_dereg_chain_holder_t & local_chain ) noexcept
 {
 	//
 	// NOTE: don't expect exceptions here.
@@ -182,8 +273,17 @@ coop_repo_t::process_current_final_dereg_chain(
 
 	// There are some coops to be deregistered.
 	// Have to extract the current value of final dereg chain from
-	// the coop_repo instance.
-	coop_shptr_t head = m_final_dereg_chain.giveout_current_chain();
+	// the coop_repo instance. If there are several final dereg threads
+	// only a part of the chain is taken, the rest is left for
+	// other threads.
+	const std::size_t portion =
+			( m_final_dereg_chain.size() + m_final_dereg_thread_count - 1u ) /
+			m_final_dereg_thread_count;
+	coop_shptr_t head = m_final_dereg_chain.giveout_part( portion );
+
+	if( !m_final_dereg_chain.empty() )
+		// Another thread can handle the rest of the chain.
+		m_final_dereg_chain_cond.notify_one();
 
 	// All following actions has to be performed on unlocked mutex.
 	lck.unlock();
@@ -192,6 +292,16 @@ coop_repo_t::process_current_final_dereg_chain(
 	// one by one.
 	so_5::impl::process_final_dereg_chain( std::move(head) );
 
+	// Coops that became ready during the previous step have to be
+	// processed too. This step can produce new coops for the local chain.
+	while( !local_chain.empty() )
+	{
+		m_final_dereg_local_coop_count.fetch_sub(
+				local_chain.size(), std::memory_order_relaxed );
+		so_5::impl::process_final_dereg_chain(
+				local_chain.giveout_current_chain() );
+	}
+
 	// Have to reacquire the lock back.
 	lck.lock();
 }
@@ -204,11 +314,15 @@ mt_env_infrastructure_t::mt_env_infrastructure_t(
 	environment_params_t::default_disp_params_t default_disp_params,
 	timer_thread_unique_ptr_t timer_thread,
 	coop_listener_unique_ptr_t coop_listener,
-	mbox_t stats_distribution_mbox )
+	mbox_t stats_distribution_mbox,
+	std::size_t final_dereg_thread_count )
 	:	m_env( env )
 	,	m_default_dispatcher_params{ std::move(default_disp_params) }
 	,	m_timer_thread( std::move(timer_thread) )
-	,	m_coop_repo( outliving_mutable(env), std::move(coop_listener) )
+	,	m_coop_repo(
+			outliving_mutable(env),
+			std::move(coop_listener),
+			final_dereg_thread_count )
 	,	m_stats_controller( std::move(stats_distribution_mbox) )
 	{
 	}
@@ -481,7 +595,8 @@ factory()
 					params.default_disp_params(),
 					std::move(timer),
 					params.so5_giveout_coop_listener(),
-					std::move(stats_distribution_mbox) );
+					std::move(stats_distribution_mbox),
+					params.final_dereg_thread_count() );
 
 			return environment_infrastructure_unique_ptr_t(
 					obj,
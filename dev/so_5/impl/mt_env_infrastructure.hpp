@@ -24,7 +24,10 @@
 
 #include <so_5/timers.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <variant>
+#include <vector>
 
 namespace so_5 {
 
@@ -51,7 +54,9 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 			//! SObjectizer Environment.
 			outliving_reference_t< environment_t > env,
 			//! Cooperation action listener.
-			coop_listener_unique_ptr_t coop_listener );
+			coop_listener_unique_ptr_t coop_listener,
+			//! Count of threads for the final deregistration.
+			std::size_t final_dereg_thread_count );
 
 		//! Do initialization.
 		void
@@ -61,7 +66,7 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 		/*!
 		 * Initiates deregistration of all agents. Waits for complete
 		 * deregistration for all of them. Waits for termination of
-		 * cooperation deregistration thread.
+		 * cooperation deregistration threads.
 		 */
 		void
 		finish();
@@ -143,9 +148,21 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 		so_5::impl::final_dereg_chain_holder_t m_final_dereg_chain;
 
 		/*!
-		 * \brief The flag for shutting down the final deregistration thread.
+		 * \brief Count of coops in local chains of the final
+		 * deregistration threads.
+		 *
+		 * Those coops became ready for the final deregistration during
+		 * the processing of other coops on a final deregistration thread.
+		 * This value is used for the run-time monitoring only.
 		 *
-		 * Value `true` means that the final deregistration thread has to
+		 * \since v.5.8.5
+		 */
+		std::atomic< std::size_t > m_final_dereg_local_coop_count{ 0u };
+
+		/*!
+		 * \brief The flag for shutting down the final deregistration threads.
+		 *
+		 * Value `true` means that the final deregistration threads have to
 		 * be finished.
 		 *
 		 * \attention
@@ -157,13 +174,26 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 		bool m_final_dereg_thread_shutdown_flag;
 
 		/*!
-		 * \brief A separate thread for doing the final deregistration.
+		 * \brief Count of threads for doing the final deregistration.
+		 *
+		 * \note
+		 * It's always greater than 0.
+		 *
+		 * \since v.5.8.5
+		 */
+		const std::size_t m_final_dereg_thread_count;
+
+		/*!
+		 * \brief Separate threads for doing the final deregistration.
 		 *
-		 * \note Actual thread is started inside start() method.
+		 * \note Actual threads are started inside start() method.
+		 *
+		 * \note
+		 * There was just one thread before v.5.8.5.
 		 *
 		 * \since v.5.5.13
 		 */
-		std::thread m_final_dereg_thread;
+		std::vector< std::thread > m_final_dereg_threads;
 		/*!
 		 * \}
 		 */
@@ -171,6 +201,9 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 		/*!
 		 * \brief Method that implements the body of final deregistration thread.
 		 *
+		 * \note
+		 * Since v.5.8.5 there can be several threads with this body.
+		 *
 		 * \since v.5.8.0
 		 */
 		void
@@ -183,12 +216,22 @@ class coop_repo_t final : protected ::so_5::impl::coop_repository_basis_t
 		 * \attention
 		 * It's expected that m_final_dereg_chain isn't empty.
 		 *
+		 * \note
+		 * Since v.5.8.5 only a part of m_final_dereg_chain is processed
+		 * if there are several final deregistration threads. Coops
+		 * that become ready for the final deregistration during this
+		 * processing are collected into \a local_chain and are processed
+		 * by the current thread too.
+		 *
 		 * \since v.5.8.0
 		 */
 		void
 		process_current_final_dereg_chain(
 			//! Lock object for acquired m_final_dereg_chain_lock.
-			std::unique_lock< std::mutex > & lck ) noexcept;
+			std::unique_lock< std::mutex > & lck,
+			//! Chain of coops that became ready for the final deregistration
+			//! during the processing on the current thread.
+			so_5::impl::final_dereg_chain_holder_t & local_chain ) noexcept;
 	};
 
 //
@@ -226,7 +269,9 @@ class mt_env_infrastructure_t
 			//! Cooperation action listener.
 			coop_listener_unique_ptr_t coop_listener,
 			//! Run-time stats distribution mbox.
-			mbox_t stats_distribution_mbox );
+			mbox_t stats_distribution_mbox,
+			//! Count of threads for the final deregistration.
+			std::size_t final_dereg_thread_count );
 
 		void
 		launch( env_init_t init_fn ) override;
@@ -115,7 +115,8 @@ class message_sinks_with_limits_holder_t
 							message_sink_with_message_limit_t{
 									owner_ptr,
 									d.m_limit,
-									std::move(d.m_action)
+									std::move(d.m_action),
+									d.m_sharded_counter
 							} );
 
 				return result;
@@ -164,7 +165,8 @@ class message_sinks_with_limits_holder_t
 								message_sink_with_message_limit_t{
 										owner_ptr,
 										limit_description.m_limit,
-										limit_description.m_action
+										limit_description.m_action,
+										limit_description.m_sharded_counter
 								} )
 								.first;
 					}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <string>
+#include <functional>
 #include <memory>
 #include <typeindex>
 #include <utility>
@@ -95,6 +96,46 @@ class SO_5_TYPE delivery_filter_t
 using delivery_filter_unique_ptr_t =
 	std::unique_ptr< delivery_filter_t >;
 
+//
+// keyed_delivery_filter_t
+//
+/*!
+ * \brief An interface of delivery filter that accepts a message only
+ * if a key extracted from the message is equal to the filter's key.
+ *
+ * Standard MPMC mboxes keep such filters in a hash index: a message is
+ * checked only by filters those key hashes are equal to the hash of
+ * the message's key. It makes the delivery cost proportional to the count
+ * of matching subscribers instead of the total count of subscribers
+ * with delivery filters.
+ *
+ * \attention
+ * All filters with the same key_extractor_type() must extract keys from
+ * messages by the same rules.
+ *
+ * \since v.5.8.5
+ */
+class SO_5_TYPE keyed_delivery_filter_t : public delivery_filter_t
+	{
+	public :
+		//! Type that identifies the rules of extraction of keys.
+		[[nodiscard]]
+		virtual std::type_index
+		key_extractor_type() const noexcept = 0;
+
+		//! Hash of the key expected by this filter.
+		[[nodiscard]]
+		virtual std::size_t
+		filter_key_hash() const noexcept = 0;
+
+		//! Hash of the key extracted from a message instance.
+		[[nodiscard]]
+		virtual std::size_t
+		message_key_hash(
+			//! Message itself.
+			message_t & msg ) const noexcept = 0;
+	};
+
 namespace low_level_api
 {
 
@@ -145,6 +186,71 @@ class lambda_as_filter_t : public delivery_filter_t
 			}
 	};
 
+/*!
+ * \brief An implementation of keyed delivery filter represented by
+ * a key extractor and the expected value of the key.
+ *
+ * \tparam Key_Extractor type of lambda-function or functional object that
+ * extracts a key from a message. It must be a stateless type because the
+ * type is used as identification of the rules of key extraction.
+ * \tparam Message type of message to be filtered.
+ * \tparam Key type of key. It must be comparable by operator== and
+ * must have a specialization of std::hash.
+ *
+ * \since v.5.8.5
+ */
+template< typename Key_Extractor, typename Message, typename Key >
+class keyed_lambda_as_filter_t final : public keyed_delivery_filter_t
+	{
+		static_assert( std::is_empty_v< Key_Extractor >,
+				"Key_Extractor must be a stateless type "
+				"(a lambda-function without captures, for example)" );
+
+		Key_Extractor m_extractor;
+		const Key m_key;
+		const std::size_t m_key_hash;
+
+		[[nodiscard]]
+		static const Message &
+		payload( message_t & msg ) noexcept
+			{
+				return message_payload_type< Message >::payload_reference( msg );
+			}
+
+	public :
+		keyed_lambda_as_filter_t( Key_Extractor && extractor, Key key )
+			:	m_extractor( std::forward< Key_Extractor >( extractor ) )
+			,	m_key( std::move(key) )
+			,	m_key_hash( std::hash< Key >{}( m_key ) )
+			{}
+
+		bool
+		check(
+			const abstract_message_sink_t & /*receiver*/,
+			message_t & msg ) const noexcept override
+			{
+				return m_key == m_extractor( payload( msg ) );
+			}
+
+		std::type_index
+		key_extractor_type() const noexcept override
+			{
+				return typeid(keyed_lambda_as_filter_t);
+			}
+
+		std::size_t
+		filter_key_hash() const noexcept override
+			{
+				return m_key_hash;
+			}
+
+		std::size_t
+		message_key_hash( message_t & msg ) const noexcept override
+			{
+				return std::hash< Key >{}( m_extractor( payload( msg ) ) );
+			}
+	};
+
 } /* namespace low_level_api */
 
 //
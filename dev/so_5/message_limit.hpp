@@ -34,6 +34,90 @@ namespace so_5
 namespace message_limit
 {
 
+//
+// sharded_counter_params_t
+//
+/*!
+ * \brief Parameters for a sharded counter of messages.
+ *
+ * By default the count of waiting messages is held in one atomic
+ * counter that is modified by every sender. It can become a hot spot
+ * if there are many senders working on different CPU cores.
+ *
+ * A sharded counter splits the sender's part of the counting into
+ * several shards. A sender thread increments its own shard and
+ * transfers accumulated value into the main counter only when
+ * the accumulated value reaches some threshold. Because of that the
+ * limit isn't exact anymore: the count of waiting messages can exceed
+ * the limit, but not more than by max_error() messages.
+ *
+ * Instances of that type should be created by sharded_counter() function.
+ *
+ * \since v.5.8.5
+ */
+class sharded_counter_params_t
+	{
+		//! Count of shards.
+		std::size_t m_shard_count;
+
+		//! Max allowed exceeding of the limit.
+		unsigned int m_max_error;
+
+	public:
+		//! Initializing constructor.
+		/*!
+		 * \note
+		 * If \a shard_count is 0 then it's treated as 1.
+		 */
+		sharded_counter_params_t(
+			std::size_t shard_count,
+			unsigned int max_error ) noexcept
+			:	m_shard_count{ shard_count ? shard_count : 1u }
+			,	m_max_error{ max_error }
+			{}
+
+		[[nodiscard]]
+		std::size_t
+		shard_count() const noexcept { return m_shard_count; }
+
+		[[nodiscard]]
+		unsigned int
+		max_error() const noexcept { return m_max_error; }
+	};
+
+/*!
+ * \brief A helper function for the creation of sharded_counter_params_t.
+ *
+ * Usage example:
+ * \code
+ * class collector final : public so_5::agent_t
+ * {
+ * public:
+ * 	collector(context_t ctx)
+ * 		:	so_5::agent_t{ ctx
+ * 				// The count of waiting messages can be exceeded by 64
+ * 				// messages at most.
+ * 				+ limit_then_drop< measurement >( 1000u,
+ * 						so_5::message_limit::sharded_counter( 64u ) )
+ * 			}
+ * 	{}
+ * 	...
+ * };
+ * \endcode
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+inline sharded_counter_params_t
+sharded_counter(
+	//! Max allowed exceeding of the limit.
+	unsigned int max_error,
+	//! Count of shards.
+	std::size_t shard_count = 16u ) noexcept
+	{
+		return { shard_count, max_error };
+	}
+
 //
 // description_t
 //
@@ -54,6 +138,14 @@ struct description_t
 		//! Reaction to overload.
 		action_t m_action;
 
+		//! Parameters of sharded counter (if it's used).
+		/*!
+		 * Empty value means that the ordinary exact counter is used.
+		 *
+		 * \since v.5.8.5
+		 */
+		optional< sharded_counter_params_t > m_sharded_counter;
+
 		//! Initializing constructor.
 		description_t(
 			std::type_index msg_type,
@@ -63,6 +155,21 @@ struct description_t
 			,	m_limit( limit )
 			,	m_action( std::move( action ) )
 			{}
+
+		//! Initializing constructor for the case of sharded counter.
+		/*!
+		 * \since v.5.8.5
+		 */
+		description_t(
+			std::type_index msg_type,
+			unsigned int limit,
+			action_t action,
+			optional< sharded_counter_params_t > sharded_counter )
+			:	m_msg_type( std::move( msg_type ) )
+			,	m_limit( limit )
+			,	m_action( std::move( action ) )
+			,	m_sharded_counter( std::move( sharded_counter ) )
+			{}
 	};
 
 //
@@ -106,10 +213,27 @@ struct drop_indicator_t
 		//! Max count of waiting messages.
 		const unsigned int m_limit;
 
+		//! Parameters of sharded counter (if it's used).
+		/*!
+		 * \since v.5.8.5
+		 */
+		const optional< sharded_counter_params_t > m_sharded_counter;
+
 		//! Initializing constructor.
 		drop_indicator_t( unsigned int limit )
 			:	m_limit( limit )
 			{}
+
+		//! Initializing constructor for the case of sharded counter.
+		/*!
+		 * \since v.5.8.5
+		 */
+		drop_indicator_t(
+			unsigned int limit,
+			sharded_counter_params_t sharded_counter )
+			:	m_limit( limit )
+			,	m_sharded_counter( sharded_counter )
+			{}
 	};
 
 //
@@ -132,7 +256,8 @@ accept_one_indicator(
 	{
 		to.emplace_back( message_payload_type< M >::subscription_type_index(),
 				indicator.m_limit,
-				&impl::drop_message_reaction );
+				&impl::drop_message_reaction,
+				indicator.m_sharded_counter );
 	}
 
 namespace impl
@@ -350,6 +475,12 @@ struct redirect_indicator_t
 		//! A lambda/functional object which returns mbox for redirection.
 		Lambda m_destination_getter;
 
+		//! Parameters of sharded counter (if it's used).
+		/*!
+		 * \since v.5.8.5
+		 */
+		optional< sharded_counter_params_t > m_sharded_counter;
+
 		//! Initializing constructor.
 		redirect_indicator_t(
 			unsigned int limit,
@@ -357,6 +488,19 @@ struct redirect_indicator_t
 			:	m_limit( limit )
 			,	m_destination_getter( std::move( destination_getter ) )
 			{}
+
+		//! Initializing constructor for the case of sharded counter.
+		/*!
+		 * \since v.5.8.5
+		 */
+		redirect_indicator_t(
+			unsigned int limit,
+			Lambda destination_getter,
+			sharded_counter_params_t sharded_counter )
+			:	m_limit( limit )
+			,	m_destination_getter( std::move( destination_getter ) )
+			,	m_sharded_counter( sharded_counter )
+			{}
 	};
 
 /*!
@@ -379,7 +523,8 @@ accept_one_indicator(
 				indicator.m_limit,
 				[dest_getter]( const overlimit_context_t & ctx ) {
 					impl::redirect_reaction( ctx, dest_getter() );
-				} );
+				},
+				indicator.m_sharded_counter );
 	}
 
 namespace impl
@@ -631,6 +776,39 @@ struct message_limit_methods_mixin_t
 				return drop_indicator_t< Msg >( limit );
 			}
 
+		/*!
+		 * \brief A helper function for creating drop_indicator that
+		 * uses a sharded counter of waiting messages.
+		 *
+		 * Usage example:
+		 * \code
+		 * class collector final : public so_5::agent_t
+		 * {
+		 * public:
+		 * 	collector(context_t ctx)
+		 * 		:	so_5::agent_t{ ctx
+		 * 				+ limit_then_drop< measurement >( 1000u,
+		 * 						so_5::message_limit::sharded_counter( 64u ) )
+		 * 			}
+		 * 	{}
+		 * 	...
+		 * };
+		 * \endcode
+		 *
+		 * \sa so_5::message_limit::sharded_counter_params_t.
+		 *
+		 * \since v.5.8.5
+		 */
+		template< typename Msg >
+		[[nodiscard]]
+		static drop_indicator_t< Msg >
+		limit_then_drop(
+			unsigned int limit,
+			sharded_counter_params_t sharded_counter )
+			{
+				return drop_indicator_t< Msg >( limit, sharded_counter );
+			}
+
 		/*!
 		 * \since
 		 * v.5.5.4
@@ -755,6 +933,59 @@ struct message_limit_methods_mixin_t
 						} );
 			}
 
+		/*!
+		 * \brief A helper function for creating redirect_indicator that
+		 * uses a sharded counter of waiting messages.
+		 *
+		 * The \a dest_getter should be a functor with the following prototype:
+		 * \code
+		 * so_5::mbox_t dest_getter();
+		 * \endcode
+		 *
+		 * \sa so_5::message_limit::sharded_counter_params_t.
+		 *
+		 * \since v.5.8.5
+		 */
+		template< typename Msg, typename Lambda >
+		[[nodiscard]]
+		static redirect_indicator_t< Msg, Lambda >
+		limit_then_redirect(
+			unsigned int limit,
+			Lambda dest_getter,
+			sharded_counter_params_t sharded_counter )
+			{
+				return redirect_indicator_t< Msg, Lambda >(
+						limit,
+						std::move( dest_getter ),
+						sharded_counter );
+			}
+
+		/*!
+		 * \brief A helper function for creating redirect_indicator that
+		 * uses a sharded counter of waiting messages.
+		 *
+		 * This helper can be used if the target mbox is already known.
+		 *
+		 * \sa so_5::message_limit::sharded_counter_params_t.
+		 *
+		 * \since v.5.8.5
+		 */
+		template< typename Msg >
+		[[nodiscard]]
+		static auto
+		limit_then_redirect(
+			unsigned int limit,
+			mbox_t destination,
+			sharded_counter_params_t sharded_counter )
+			{
+				return limit_then_redirect< Msg >(
+						limit,
+						[dest = std::move(destination)]() -> const so_5::mbox_t & {
+							return dest;
+						},
+						sharded_counter );
+			}
+
 		/*!
 		 * \brief A helper function for creating transform_indicator.
 		 *
@@ -53,6 +53,8 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 
 		cpp_source 'message_limit.cpp'
 
+		cpp_source 'shared_buffer.cpp'
+
 		cpp_source 'mbox.cpp'
 		cpp_source 'mchain.cpp'
 
@@ -108,6 +110,7 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 
 		sources_root( 'disp' ) {
 			cpp_source 'abstract_work_thread.cpp'
+			cpp_source 'affinity_work_thread.cpp'
 
 			sources_root( 'mpsc_queue_traits' ) {
 				cpp_source 'pub.cpp'
@@ -145,6 +148,22 @@ class Prj < MxxRu::Cpp::LibOrDllTarget
 				cpp_source 'pub.cpp'
 			}
 
+			sources_root( 'prio_thread_pool' ) {
+				cpp_source 'pub.cpp'
+			}
+
+			sources_root( 'edf_one_thread' ) {
+				cpp_source 'pub.cpp'
+			}
+
+			sources_root( 'epoll_one_thread' ) {
+				cpp_source 'pub.cpp'
+			}
+
+			sources_root( 'sharded_one_thread' ) {
+				cpp_source 'pub.cpp'
+			}
+
 			sources_root( 'prio_one_thread' ) {
 				sources_root( 'strictly_ordered' ) {
 					cpp_source 'pub.cpp'
@@ -525,6 +525,36 @@ const int rc_agent_name_too_long = 197;
  */
 const int rc_stored_msg_inspection_result_not_found = 198;
 
+/*!
+ * \brief An attempt to make a slice of shared_buffer that is out of
+ * bounds of the buffer.
+ *
+ * \since v.5.8.5
+ */
+const int rc_shared_buffer_out_of_range = 199;
+
+/*!
+ * \brief A file can't be mapped into memory as a shared_buffer.
+ *
+ * \since v.5.8.5
+ */
+const int rc_unable_to_map_file_to_shared_buffer = 200;
+
+/*!
+ * \brief Invalid list of CPUs for a work thread factory with CPU affinity.
+ *
+ * \since v.5.8.5
+ */
+const int rc_invalid_cpu_list = 201;
+
+/*!
+ * \brief An error during interaction with OS facilities for I/O
+ * readiness notification (like epoll).
+ *
+ * \since v.5.8.5
+ */
+const int rc_io_readiness_notification_failure = 202;
+
 //! \name Common error codes.
 //! \{
 
@@ -0,0 +1,141 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Shared immutable byte buffers and a message type for them.
+ *
+ * \since v.5.8.5
+ */
+
+#include <so_5/shared_buffer.hpp>
+
+#include <so_5/detect_os.hpp>
+
+#if defined(SO_5_OS_UNIX) || defined(SO_5_OS_APPLE)
+	#define SO_5_SHARED_BUFFER_HAS_MMAP
+#endif
+
+#if defined(SO_5_SHARED_BUFFER_HAS_MMAP)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+
+	#include <cerrno>
+	#include <cstring>
+#endif
+
+namespace so_5 {
+
+namespace shared_buffer_details {
+
+namespace {
+
+#if defined(SO_5_SHARED_BUFFER_HAS_MMAP)
+
+//
+// mmap_storage_t
+//
+/*!
+ * \brief A storage for a file mapped into memory.
+ *
+ * \since v.5.8.5
+ */
+class mmap_storage_t final : public storage_t
+	{
+	public:
+		mmap_storage_t( void * addr, std::size_t size ) noexcept
+			:	storage_t{ static_cast< const std::byte * >( addr ), size }
+			,	m_addr{ addr }
+			{}
+
+		~mmap_storage_t() noexcept override
+			{
+				if( m_addr )
+					::munmap( m_addr, size() );
+			}
+
+	private:
+		void * m_addr;
+	};
+
+//! Helper for closing file descriptor at the scope exit.
+class fd_closer_t
+	{
+		int m_fd;
+
+	public:
+		explicit fd_closer_t( int fd ) noexcept : m_fd{ fd } {}
+		~fd_closer_t() noexcept { ::close( m_fd ); }
+
+		fd_closer_t( const fd_closer_t & ) = delete;
+		fd_closer_t & operator=( const fd_closer_t & ) = delete;
+	};
+
+void
+throw_mapping_failure(
+	const char * what,
+	const std::string & file_name,
+	int error_code )
+	{
+		SO_5_THROW_EXCEPTION(
+				rc_unable_to_map_file_to_shared_buffer,
+				std::string{ what } + " failed for '" + file_name + "': " +
+				std::strerror( error_code ) );
+	}
+
+#endif
+
+} /* namespace anonymous */
+
+} /* namespace shared_buffer_details */
+
+SO_5_FUNC shared_buffer_t
+map_file_to_shared_buffer( const std::string & file_name )
+	{
+#if defined(SO_5_SHARED_BUFFER_HAS_MMAP)
+		using namespace shared_buffer_details;
+
+		const int fd = ::open( file_name.c_str(), O_RDONLY );
+		if( -1 == fd )
+			throw_mapping_failure( "open", file_name, errno );
+
+		// The file can be closed right after mapping.
+		fd_closer_t closer{ fd };
+
+		struct stat st;
+		if( -1 == ::fstat( fd, &st ) )
+			throw_mapping_failure( "fstat", file_name, errno );
+
+		const auto size = static_cast< std::size_t >( st.st_size );
+		if( !size )
+			// Empty file can't be mapped, but it's not an error.
+			return shared_buffer_t{};
+
+		void * addr = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( MAP_FAILED == addr )
+			throw_mapping_failure( "mmap", file_name, errno );
+
+		std::unique_ptr< storage_t > storage;
+		try
+			{
+				storage = std::make_unique< mmap_storage_t >( addr, size );
+			}
+		catch( ... )
+			{
+				::munmap( addr, size );
+				throw;
+			}
+
+		return shared_buffer_t{ storage_ref_t{ std::move(storage) } };
+#else
+		SO_5_THROW_EXCEPTION(
+				rc_not_implemented,
+				"map_file_to_shared_buffer isn't supported on this platform, "
+				"file: " + file_name );
+#endif
+	}
+
+} /* namespace so_5 */
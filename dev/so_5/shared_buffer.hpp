@@ -0,0 +1,468 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief Shared immutable byte buffers and a message type for them.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/message.hpp>
+#include <so_5/atomic_refcounted.hpp>
+#include <so_5/exception.hpp>
+#include <so_5/ret_code.hpp>
+#include <so_5/declspec.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace so_5 {
+
+namespace shared_buffer_details {
+
+//
+// storage_t
+//
+/*!
+ * \brief A base class for a backing store of shared buffers.
+ *
+ * A storage owns a continuous region of bytes. This region is never
+ * modified after the creation of a shared_buffer_t that refers to the
+ * storage.
+ *
+ * The storage is destroyed when the last shared_buffer_t that refers
+ * to it is destroyed.
+ *
+ * \since v.5.8.5
+ */
+class storage_t : public atomic_refcounted_t
+	{
+	public:
+		storage_t( const std::byte * data, std::size_t size ) noexcept
+			:	m_data{ data }
+			,	m_size{ size }
+			{}
+
+		virtual ~storage_t() noexcept = default;
+
+		//! Pointer to the first byte of the region.
+		[[nodiscard]]
+		const std::byte *
+		data() const noexcept { return m_data; }
+
+		//! Size of the region.
+		[[nodiscard]]
+		std::size_t
+		size() const noexcept { return m_size; }
+
+	protected:
+		//! Set the actual region after the creation of the storage.
+		void
+		set_region( const std::byte * data, std::size_t size ) noexcept
+			{
+				m_data = data;
+				m_size = size;
+			}
+
+	private:
+		const std::byte * m_data;
+		std::size_t m_size;
+	};
+
+//! Type of smart pointer to a storage.
+using storage_ref_t = intrusive_ptr_t< storage_t >;
+
+//
+// heap_storage_t
+//
+/*!
+ * \brief A storage that holds a region allocated in the dynamic memory.
+ *
+ * \since v.5.8.5
+ */
+class heap_storage_t final : public storage_t
+	{
+	public:
+		explicit heap_storage_t( std::size_t size )
+			:	storage_t{ nullptr, 0u }
+			,	m_bytes{ new std::byte[ size ] }
+			{
+				set_region( m_bytes.get(), size );
+			}
+
+		//! Access to the bytes before the storage becomes shared.
+		[[nodiscard]]
+		std::byte *
+		mutable_data() noexcept { return m_bytes.get(); }
+
+	private:
+		std::unique_ptr< std::byte[] > m_bytes;
+	};
+
+//
+// adopted_storage_t
+//
+/*!
+ * \brief A storage that holds a region provided by a user.
+ *
+ * The region is released by calling a user-provided deleter.
+ * It allows to use memory from pools or any other sources
+ * without copying the content.
+ *
+ * \since v.5.8.5
+ */
+template< typename Deleter >
+class adopted_storage_t final : public storage_t
+	{
+	public:
+		adopted_storage_t(
+			const std::byte * data,
+			std::size_t size,
+			Deleter deleter )
+			:	storage_t{ data, size }
+			,	m_deleter{ std::move(deleter) }
+			{}
+
+		~adopted_storage_t() noexcept override
+			{
+				m_deleter( const_cast< std::byte * >( data() ), size() );
+			}
+
+	private:
+		Deleter m_deleter;
+	};
+
+} /* namespace shared_buffer_details */
+
+//
+// shared_buffer_t
+//
+/*!
+ * \brief A view to an immutable byte region with shared ownership.
+ *
+ * A copy of shared_buffer_t doesn't copy the content, it only increments
+ * the reference counter of the backing store. A slice of a shared_buffer_t
+ * refers to the same backing store too.
+ *
+ * Usage example:
+ * \code
+ * so_5::shared_buffer_t snapshot = so_5::make_shared_buffer(
+ * 	total_size,
+ * 	[&](std::byte * data, std::size_t size) { fill_snapshot(data, size); } );
+ *
+ * // The whole snapshot for one subscriber, a part of it for another.
+ * so_5::send< so_5::shared_buffer_message >( full_mbox, snapshot );
+ * so_5::send< so_5::shared_buffer_message >( us_mbox,
+ * 	snapshot.slice( us_offset, us_size ) );
+ * \endcode
+ *
+ * \note
+ * An empty shared_buffer_t (created by the default constructor) has
+ * no backing store, data() returns nullptr for it.
+ *
+ * \since v.5.8.5
+ */
+class shared_buffer_t
+	{
+	public:
+		shared_buffer_t() noexcept = default;
+
+		//! Make a view to the whole content of \a storage.
+		explicit shared_buffer_t(
+			shared_buffer_details::storage_ref_t storage ) noexcept
+			:	m_data{ storage ? storage->data() : nullptr }
+			,	m_size{ storage ? storage->size() : 0u }
+			,	m_storage{ std::move(storage) }
+			{}
+
+		friend void
+		swap( shared_buffer_t & a, shared_buffer_t & b ) noexcept
+			{
+				using std::swap;
+				swap( a.m_data, b.m_data );
+				swap( a.m_size, b.m_size );
+				swap( a.m_storage, b.m_storage );
+			}
+
+		//! Pointer to the first byte of the view.
+		[[nodiscard]]
+		const std::byte *
+		data() const noexcept { return m_data; }
+
+		//! Size of the view.
+		[[nodiscard]]
+		std::size_t
+		size() const noexcept { return m_size; }
+
+		[[nodiscard]]
+		bool
+		empty() const noexcept { return 0u == m_size; }
+
+		[[nodiscard]]
+		const std::byte *
+		begin() const noexcept { return m_data; }
+
+		[[nodiscard]]
+		const std::byte *
+		end() const noexcept { return m_data + m_size; }
+
+		//! Access to the content as to a sequence of chars.
+		[[nodiscard]]
+		std::string_view
+		as_string_view() const noexcept
+			{
+				return {
+						reinterpret_cast< const char * >( m_data ),
+						m_size
+					};
+			}
+
+		/*!
+		 * \brief Make a view to a part of the content.
+		 *
+		 * The resulting view shares the backing store with this view.
+		 *
+		 * \throw so_5::exception_t if the requested part is out of
+		 * the bounds of this view.
+		 */
+		[[nodiscard]]
+		shared_buffer_t
+		slice( std::size_t offset, std::size_t length ) const
+			{
+				if( offset > m_size || length > m_size - offset )
+					SO_5_THROW_EXCEPTION(
+							rc_shared_buffer_out_of_range,
+							"slice is out of range of shared_buffer, offset: " +
+							std::to_string( offset ) + ", length: " +
+							std::to_string( length ) + ", size: " +
+							std::to_string( m_size ) );
+
+				shared_buffer_t result;
+				result.m_data = m_data + offset;
+				result.m_size = length;
+				result.m_storage = m_storage;
+
+				return result;
+			}
+
+		/*!
+		 * \brief Make a view to the rest of the content starting
+		 * from \a offset.
+		 *
+		 * \throw so_5::exception_t if \a offset is greater than size().
+		 */
+		[[nodiscard]]
+		shared_buffer_t
+		slice( std::size_t offset ) const
+			{
+				return slice( offset, offset <= m_size ? m_size - offset : 0u );
+			}
+
+		//! Do both views share the same backing store?
+		[[nodiscard]]
+		bool
+		shares_storage_with( const shared_buffer_t & other ) const noexcept
+			{
+				return m_storage && m_storage.get() == other.m_storage.get();
+			}
+
+	private:
+		const std::byte * m_data{ nullptr };
+		std::size_t m_size{ 0u };
+
+		shared_buffer_details::storage_ref_t m_storage;
+	};
+
+//
+// make_shared_buffer
+//
+/*!
+ * \brief Create a shared buffer of \a size bytes in the dynamic memory
+ * and fill it by \a filler.
+ *
+ * The \a filler is called as `filler(std::byte * data, std::size_t size)`.
+ * This is the only place where the content of the buffer can be modified.
+ *
+ * \since v.5.8.5
+ */
+template< typename Filler >
+[[nodiscard]]
+shared_buffer_t
+make_shared_buffer( std::size_t size, Filler && filler )
+	{
+		static_assert(
+				std::is_invocable_v< Filler, std::byte *, std::size_t >,
+				"filler should be invocable as filler(std::byte *, std::size_t)" );
+
+		auto storage = std::make_unique< shared_buffer_details::heap_storage_t >(
+				size );
+		filler( storage->mutable_data(), size );
+
+		return shared_buffer_t{
+				shared_buffer_details::storage_ref_t{ std::move(storage) }
+			};
+	}
+
+/*!
+ * \brief Create a shared buffer with a copy of the specified region.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+inline shared_buffer_t
+make_shared_buffer( const void * data, std::size_t size )
+	{
+		return make_shared_buffer( size,
+				[data]( std::byte * to, std::size_t n ) {
+					if( n )
+						std::memcpy( to, data, n );
+				} );
+	}
+
+//
+// adopt_shared_buffer
+//
+/*!
+ * \brief Create a shared buffer for a region owned by a user.
+ *
+ * The content isn't copied. The \a deleter will be called as
+ * `deleter(std::byte * data, std::size_t size)` when the last
+ * reference to the region disappears. It allows to use pool-allocated
+ * memory:
+ * \code
+ * std::byte * block = my_pool.allocate( block_size );
+ * read_snapshot( block, block_size );
+ * auto buf = so_5::adopt_shared_buffer( block, block_size,
+ * 	[&my_pool](std::byte * p, std::size_t) noexcept { my_pool.deallocate(p); } );
+ * \endcode
+ *
+ * \attention
+ * The \a deleter should be noexcept. The content of the region must not
+ * be modified while there are references to it.
+ *
+ * \note
+ * If the allocation of internal data fails then \a deleter is called
+ * before the exception is propagated.
+ *
+ * \since v.5.8.5
+ */
+template< typename Deleter >
+[[nodiscard]]
+shared_buffer_t
+adopt_shared_buffer( std::byte * data, std::size_t size, Deleter deleter )
+	{
+		using storage_type = shared_buffer_details::adopted_storage_t<
+				std::decay_t< Deleter > >;
+
+		std::unique_ptr< storage_type > storage;
+		try
+			{
+				storage = std::make_unique< storage_type >(
+						data, size, deleter );
+			}
+		catch( ... )
+			{
+				deleter( data, size );
+				throw;
+			}
+
+		return shared_buffer_t{
+				shared_buffer_details::storage_ref_t{ std::move(storage) }
+			};
+	}
+
+//
+// map_file_to_shared_buffer
+//
+/*!
+ * \brief Map the whole content of a file into memory and return it
+ * as a shared buffer.
+ *
+ * The file is mapped in read-only mode and is unmapped when the last
+ * reference to the content disappears. Pages are loaded by the OS
+ * on demand, so the content isn't copied into the dynamic memory.
+ *
+ * \note
+ * This function is supported only on Unix platforms (including macOS).
+ * An exception with rc_not_implemented is thrown on other platforms.
+ *
+ * \throw so_5::exception_t if the file can't be opened or mapped.
+ *
+ * \since v.5.8.5
+ */
+[[nodiscard]]
+SO_5_FUNC shared_buffer_t
+map_file_to_shared_buffer( const std::string & file_name );
+
+//
+// shared_buffer_message
+//
+/*!
+ * \brief A message that carries a shared immutable byte buffer.
+ *
+ * The content of the buffer is never copied during the delivery:
+ * the message is shared between all receivers as any other immutable
+ * message, and the buffer itself can be shared between several messages
+ * (for example, one message can carry the whole snapshot and another
+ * one only a slice of it).
+ *
+ * Usage example:
+ * \code
+ * class consumer final : public so_5::agent_t {
+ * 	void on_snapshot(mhood_t<so_5::shared_buffer_message> cmd) {
+ * 		parse(cmd->data(), cmd->size());
+ * 		// Forward a part of the snapshot without copying.
+ * 		so_5::send< so_5::shared_buffer_message >( m_next,
+ * 			cmd->buffer().slice( header_size ) );
+ * 	}
+ * 	...
+ * };
+ * \endcode
+ *
+ * It can also be stored in so_5::message_holder_t:
+ * \code
+ * so_5::message_holder_t< so_5::shared_buffer_message > last_snapshot;
+ * ...
+ * void on_snapshot(mhood_t<so_5::shared_buffer_message> cmd) {
+ * 	last_snapshot = cmd.make_holder();
+ * }
+ * \endcode
+ *
+ * \since v.5.8.5
+ */
+class shared_buffer_message final : public message_t
+	{
+	public:
+		explicit shared_buffer_message( shared_buffer_t buffer ) noexcept
+			:	m_buffer{ std::move(buffer) }
+			{}
+
+		//! Access to the buffer.
+		[[nodiscard]]
+		const shared_buffer_t &
+		buffer() const noexcept { return m_buffer; }
+
+		//! Pointer to the first byte of the buffer.
+		[[nodiscard]]
+		const std::byte *
+		data() const noexcept { return m_buffer.data(); }
+
+		//! Size of the buffer.
+		[[nodiscard]]
+		std::size_t
+		size() const noexcept { return m_buffer.size(); }
+
+	private:
+		const shared_buffer_t m_buffer;
+	};
+
+} /* namespace so_5 */
@@ -0,0 +1,151 @@
+/*
+ * SObjectizer-5
+ */
+
+/*!
+ * \file
+ * \brief A base class for agents with the fixed set of messages handled.
+ *
+ * \since v.5.8.5
+ */
+
+#pragma once
+
+#include <so_5/agent.hpp>
+#include <so_5/mhood.hpp>
+
+#include <utility>
+
+namespace so_5
+{
+
+//
+// static_agent_t
+//
+/*!
+ * \brief A base class for agents with the fixed set of messages
+ * received from the agent's direct mbox.
+ *
+ * Agents of that kind have event handlers for message types \a Messages
+ * from the direct mbox. The mapping of a message type to an event handler
+ * is generated at the compile time. It means that there is no search in
+ * the subscription storage and no calls via std::function for those
+ * messages: an event handler is called directly.
+ *
+ * The \a Derived class has to have the following method for every
+ * message type M from \a Messages:
+ * \code
+ * void on_message( mhood_t< M > cmd );
+ * \endcode
+ * These methods have to be accessible from static_agent_t (they can
+ * be public or static_agent_t can be a friend of \a Derived).
+ *
+ * Usage example:
+ * \code
+ * class counter final
+ * 	:	public so_5::static_agent_t< counter, increment, get_value >
+ * {
+ * 	int m_value{};
+ *
+ * public:
+ * 	using so_5::static_agent_t< counter, increment, get_value >::static_agent_t;
+ *
+ * 	void on_message( mhood_t< increment > ) { ++m_value; }
+ * 	void on_message( mhood_t< get_value > cmd ) {
+ * 		so_5::send< current_value >( cmd->m_reply_to, m_value );
+ * 	}
+ * };
+ * \endcode
+ *
+ * Event handlers for \a Messages are created as deadletter handlers
+ * (see agent_t::so_subscribe_deadletter_handler()). Because of that
+ * they are applicable in every state of the agent. And because of that
+ * all features of SObjectizer (message limits, delivery filters, message
+ * delivery tracing, enveloped messages, all dispatchers and so on)
+ * work with the static agent as usual. The direct call of an event handler
+ * is just a shortcut for the case when the usual search of the event
+ * handler would find the same deadletter handler.
+ *
+ * Agent can have other subscriptions (in different states and for
+ * different mboxes). But it must not subscribe to messages from
+ * \a Messages from the direct mbox: the static event handlers are
+ * used for them regardless of the current state.
+ *
+ * If a deadletter handler is dropped by so_drop_deadletter_handler() or
+ * the agent is deactivated by so_deactivate_agent() then static event
+ * handlers are switched off and the usual search in the subscription
+ * storage is used for all messages.
+ *
+ * \note
+ * Static event handlers are not thread-safe ones.
+ *
+ * \tparam Derived actual type of the agent.
+ * \tparam Messages types of messages to be handled. Types like
+ * so_5::mutable_msg<M> are supported too.
+ *
+ * \since v.5.8.5
+ */
+template< typename Derived, typename... Messages >
+class static_agent_t : public agent_t
+	{
+		static_assert( sizeof...(Messages) != 0u,
+				"static_agent_t requires at least one message type" );
+
+	public:
+		static_agent_t( context_t ctx )
+			:	agent_t{ std::move(ctx) }
+			,	m_direct_mbox_id{ so_direct_mbox()->id() }
+			{
+				( make_deadletter_subscription< Messages >(), ... );
+
+				so_set_static_handler_finder( &static_agent_t::find_static_handler );
+			}
+
+	private:
+		//! ID of the direct mbox.
+		/*!
+		 * It's stored to avoid virtual call to abstract_message_box_t::id().
+		 */
+		const mbox_id_t m_direct_mbox_id;
+
+		template< typename Message >
+		void
+		make_deadletter_subscription()
+			{
+				so_subscribe_deadletter_handler(
+						so_direct_mbox(),
+						[this]( mhood_t< Message > cmd ) {
+							static_cast< Derived * >( this )->on_message( std::move(cmd) );
+						} );
+			}
+
+		template< typename Message >
+		static void
+		call_event_handler( agent_t & receiver, message_ref_t & msg )
+			{
+				static_cast< Derived & >( receiver ).on_message(
+						mhood_t< Message >{ msg } );
+			}
+
+		[[nodiscard]]
+		static static_event_handler_pfn_t
+		find_static_handler( const execution_demand_t & demand ) noexcept
+			{
+				static_event_handler_pfn_t result = nullptr;
+
+				const auto & self =
+						static_cast< const static_agent_t & >( *demand.m_receiver );
+				if( demand.m_mbox_id == self.m_direct_mbox_id )
+					{
+						// The first matching type stops the search.
+						(void)( ( demand.m_msg_type ==
+								message_payload_type< Messages >::subscription_type_index()
+								&& ( result = &static_agent_t::call_event_handler< Messages >,
+										true ) ) || ... );
+					}
+
+				return result;
+			}
+	};
+
+} /* namespace so_5 */
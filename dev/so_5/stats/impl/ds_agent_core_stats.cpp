@@ -51,6 +51,13 @@ ds_agent_core_stats_t::distribute(
 				prefixes::coop_repository(),
 				suffixes::coop_final_dereg_count(),
 				stats.m_final_dereg_coop_count );
+
+		send< messages::quantity< std::size_t > >( distribution_mbox,
+				prefixes::coop_repository(),
+				suffixes::coop_final_dereg_wait_time(),
+				static_cast< std::size_t >(
+						std::chrono::duration_cast< std::chrono::microseconds >(
+								stats.m_final_dereg_wait_time ).count() ) );
 	}
 
 } /* namespace impl */
@@ -56,6 +56,12 @@ coop_final_dereg_count()
 		IMPL_SUFFIX( "/coop.final.dereg.count" )
 	}
 
+SO_5_FUNC suffix_t
+coop_final_dereg_wait_time()
+	{
+		IMPL_SUFFIX( "/coop.final.dereg.wait_us" )
+	}
+
 SO_5_FUNC suffix_t
 named_mbox_count()
 	{
@@ -110,6 +116,24 @@ demand_quote()
 		IMPL_SUFFIX( "/demands.quote" )
 	}
 
+SO_5_FUNC suffix_t
+expired_demands_count()
+	{
+		IMPL_SUFFIX( "/demands.expired" )
+	}
+
+SO_5_FUNC suffix_t
+dropped_demands_count()
+	{
+		IMPL_SUFFIX( "/demands.dropped" )
+	}
+
+SO_5_FUNC suffix_t
+migrated_agents_count()
+	{
+		IMPL_SUFFIX( "/agents.migrated" )
+	}
+
 #undef IMPL_SUFFIX
 
 } /* namespace suffixes */
@@ -73,6 +73,20 @@ coop_count();
 SO_5_FUNC suffix_t
 coop_final_dereg_count();
 
+/*!
+ * \since
+ * v.5.8.5
+ *
+ * \brief Suffix for data source with the time (in microseconds) the
+ * oldest cooperation waits for the final deregistration step.
+ *
+ * The time is measured from the moment the cooperation became ready
+ * for the final deregistration. A cooperation stops waiting when it's
+ * taken by a final deregistration thread.
+ */
+SO_5_FUNC suffix_t
+coop_final_dereg_wait_time();
+
 /*!
  * \since
  * v.5.5.4
@@ -157,6 +171,49 @@ timer_periodic_count();
 SO_5_FUNC suffix_t
 demand_quote();
 
+/*!
+ * \since
+ * v.5.8.5
+ *
+ * \brief Suffix for data source with count of expired demands.
+ *
+ * It's a total count of demands that weren't handled because of
+ * expiration of their deadlines. Expired demands are either dropped
+ * or redirected to another mbox.
+ *
+ * This suffix is used in edf_one_thread dispatcher.
+ */
+SO_5_FUNC suffix_t
+expired_demands_count();
+
+/*!
+ * \since
+ * v.5.8.5
+ *
+ * \brief Suffix for data source with count of dropped demands.
+ *
+ * It's a total count of demands that were thrown out by a dispatcher
+ * without any handling.
+ *
+ * This suffix is used in edf_one_thread dispatcher.
+ */
+SO_5_FUNC suffix_t
+dropped_demands_count();
+
+/*!
+ * \since
+ * v.5.8.5
+ *
+ * \brief Suffix for data source with count of migrations of agents.
+ *
+ * It's a total count of moves of agent queues from one working
+ * thread to another.
+ *
+ * This suffix is used in sharded_one_thread dispatcher.
+ */
+SO_5_FUNC suffix_t
+migrated_agents_count();
+
 } /* namespace suffixes */
 
 } /* namespace stats */
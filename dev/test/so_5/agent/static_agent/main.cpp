@@ -0,0 +1,224 @@
+/*
+ * A simple test for static_agent_t.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/ensure.hpp>
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+
+#include <atomic>
+
+struct msg_add final : public so_5::message_t
+{
+	int m_value;
+
+	explicit msg_add( int value ) : m_value{ value } {}
+};
+
+struct msg_mutable_add final
+{
+	int m_value;
+};
+
+struct msg_switch final : public so_5::signal_t {};
+
+struct msg_check final : public so_5::signal_t {};
+
+struct msg_other final : public so_5::signal_t {};
+
+class a_test_t final
+	:	public so_5::static_agent_t< a_test_t,
+			msg_add,
+			so_5::mutable_msg< msg_mutable_add >,
+			msg_switch,
+			msg_check >
+{
+	using base_type_t = so_5::static_agent_t< a_test_t,
+			msg_add,
+			so_5::mutable_msg< msg_mutable_add >,
+			msg_switch,
+			msg_check >;
+
+	state_t st_another{ this, "another" };
+
+	const so_5::mbox_t m_other_mbox;
+
+	int m_sum{};
+	int m_others{};
+
+public:
+	a_test_t( context_t ctx, std::string & trace )
+		:	base_type_t{ std::move(ctx) }
+		,	m_other_mbox{ so_environment().create_mbox() }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		// Ordinary subscription can be used with static ones.
+		st_another.event( m_other_mbox, [this]( mhood_t< msg_other > ) {
+				++m_others;
+				m_trace += "other;";
+			} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_add >( *this, 1 );
+		so_5::send< so_5::mutable_msg< msg_mutable_add > >( *this, 2 );
+		so_5::send< msg_switch >( *this );
+		so_5::send< msg_add >( *this, 3 );
+		so_5::send< msg_other >( m_other_mbox );
+		so_5::send< msg_check >( *this );
+	}
+
+	void
+	on_message( mhood_t< msg_add > cmd )
+	{
+		m_sum += cmd->m_value;
+		m_trace += "add(" + std::to_string( cmd->m_value ) + ");";
+	}
+
+	void
+	on_message( mutable_mhood_t< msg_mutable_add > cmd )
+	{
+		m_sum += cmd->m_value;
+		m_trace += "mutable_add(" + std::to_string( cmd->m_value ) + ");";
+	}
+
+	void
+	on_message( mhood_t< msg_switch > )
+	{
+		this >>= st_another;
+		m_trace += "switch;";
+	}
+
+	void
+	on_message( mhood_t< msg_check > )
+	{
+		ensure_or_die( 6 == m_sum, "unexpected sum: " + std::to_string( m_sum ) );
+		ensure_or_die( 1 == m_others,
+				"unexpected others: " + std::to_string( m_others ) );
+
+		so_deregister_agent_coop_normally();
+	}
+
+private:
+	std::string & m_trace;
+};
+
+// Static handlers mustn't be used after the removal of deadletter
+// handlers and after the deactivation of the agent.
+class a_dropped_handlers_t final
+	:	public so_5::static_agent_t< a_dropped_handlers_t, msg_add, msg_check >
+{
+	using base_type_t = so_5::static_agent_t<
+			a_dropped_handlers_t, msg_add, msg_check >;
+
+public:
+	a_dropped_handlers_t( context_t ctx, std::string & trace )
+		:	base_type_t{ std::move(ctx) }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_add >( *this, 1 );
+		so_5::send< msg_check >( *this );
+		so_5::send< msg_add >( *this, 2 );
+		so_5::send< msg_add >( *this, 3 );
+	}
+
+	void
+	on_message( mhood_t< msg_add > cmd )
+	{
+		m_trace += "add(" + std::to_string( cmd->m_value ) + ");";
+
+		if( 1 == cmd->m_value )
+			so_drop_deadletter_handler< msg_check >( so_direct_mbox() );
+		else
+		{
+			so_deactivate_agent();
+			so_deregister_agent_coop_normally();
+		}
+	}
+
+	void
+	on_message( mhood_t< msg_check > )
+	{
+		m_trace += "check;";
+	}
+
+private:
+	std::string & m_trace;
+};
+
+class null_tracer_t final : public so_5::msg_tracing::tracer_t
+{
+public:
+	void
+	trace( const std::string & ) noexcept override {}
+};
+
+void
+run_test( bool msg_tracing )
+{
+	std::string trace;
+
+	so_5::launch(
+		[&trace]( so_5::environment_t & env ) {
+			env.introduce_coop( [&trace]( so_5::coop_t & coop ) {
+					coop.make_agent< a_test_t >( trace );
+				} );
+		},
+		[msg_tracing]( so_5::environment_params_t & params ) {
+			if( msg_tracing )
+				params.message_delivery_tracer(
+						std::make_unique< null_tracer_t >() );
+		} );
+
+	const std::string expected =
+			"add(1);mutable_add(2);switch;add(3);other;";
+	ensure_or_die( expected == trace,
+			"unexpected trace: '" + trace + "', expected: '" + expected + "'" );
+}
+
+void
+run_dropped_handlers_test( bool msg_tracing )
+{
+	std::string trace;
+
+	so_5::launch(
+		[&trace]( so_5::environment_t & env ) {
+			env.introduce_coop( [&trace]( so_5::coop_t & coop ) {
+					coop.make_agent< a_dropped_handlers_t >( trace );
+				} );
+		},
+		[msg_tracing]( so_5::environment_params_t & params ) {
+			if( msg_tracing )
+				params.message_delivery_tracer(
+						std::make_unique< null_tracer_t >() );
+		} );
+
+	const std::string expected = "add(1);add(2);";
+	ensure_or_die( expected == trace,
+			"unexpected trace: '" + trace + "', expected: '" + expected + "'" );
+}
+
+int
+main()
+{
+	run_with_time_limit( [] {
+			run_test( false );
+			run_test( true );
+			run_dropped_handlers_test( false );
+			run_dropped_handlers_test( true );
+		},
+		5 );
+
+	return 0;
+}
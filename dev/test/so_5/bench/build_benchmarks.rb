@@ -20,4 +20,7 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/prepared_select/prj.rb"
 	required_prj "#{path}/named_mboxes/prj.rb"
 	required_prj "#{path}/subscribe_unsubscribe/prj.rb"
+	required_prj "#{path}/limited_parallel_send/prj.rb"
+	required_prj "#{path}/event_handler_method/prj.rb"
+	required_prj "#{path}/ping_pong_latency/prj.rb"
 }
@@ -29,6 +29,8 @@ struct	cfg_t
 	unsigned int m_coop_size = 10;
 
 	dispatcher_type_t m_dispatcher_type = dispatcher_type_t::one_thread;
+
+	std::size_t m_final_dereg_threads = 1u;
 };
 
 cfg_t
@@ -51,6 +53,9 @@ try_parse_cmdline(
 							"-a, --coop-size      size of every coop\n"
 							"-D, --dispatcher     type of dispatcher to be used:\n"
 							"                     one_thread, thread_pool\n"
+							"-F, --final-dereg-threads\n"
+							"                     count of threads for the final\n"
+							"                     deregistration of coops\n"
 							"-h, --help           show this help"
 							<< std::endl;
 					std::exit( 1 );
@@ -76,6 +81,10 @@ try_parse_cmdline(
 					else
 						throw std::runtime_error( "unsupported dispatcher type: " + name );
 				}
+			else if( is_arg( *current, "-F", "--final-dereg-threads" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_final_dereg_threads, ++current, last_arg,
+						"-F", "count of threads for the final deregistration" );
 			else
 				throw std::runtime_error(
 						std::string( "unknown argument: " ) + *current );
@@ -278,6 +287,7 @@ show_cfg(
 			<< "coops: " << cfg.m_coop_count
 			<< ", agents_per_coop: " << cfg.m_coop_size
 			<< ", disp: " << dispatcher_type_name( cfg.m_dispatcher_type )
+			<< ", final_dereg_threads: " << cfg.m_final_dereg_threads
 			<< std::endl;
 	}
 
@@ -292,6 +302,9 @@ run_sobjectizer( const cfg_t & cfg )
 										coop.environment(),
 										cfg.m_dispatcher_type ) );
 					} );
+			},
+			[&cfg]( so_5::environment_params_t & params ) {
+				params.final_dereg_thread_count( cfg.m_final_dereg_threads );
 			} );
 	}
 
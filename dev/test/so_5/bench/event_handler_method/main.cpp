@@ -0,0 +1,271 @@
+/*
+ * A benchmark for memory consumption and call overhead of
+ * so_5::event_handler_method_t.
+ *
+ * The same event handler (a lambda with a pointer to an agent and
+ * a pointer to agent's method, like SObjectizer creates for
+ * subscriptions) is stored into std::function and into
+ * so_5::event_handler_method_t. Then:
+ *
+ * - count of memory allocations per stored handler is shown;
+ * - price of copy and call of the handler is measured (a handler
+ *   is copied for every event to be processed by an agent);
+ * - count of memory allocations per subscription of a real agent
+ *   is shown.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/cmd_line_args_helpers.hpp>
+#include <test/3rd_party/various_helpers/benchmark_helpers.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace alloc_stats
+{
+
+std::atomic< unsigned long long > g_allocations{ 0u };
+std::atomic< unsigned long long > g_bytes{ 0u };
+
+struct snapshot_t
+{
+	unsigned long long m_allocations;
+	unsigned long long m_bytes;
+
+	static snapshot_t
+	make() noexcept
+	{
+		return { g_allocations.load(), g_bytes.load() };
+	}
+};
+
+void
+show(
+	const char * title,
+	const snapshot_t & before,
+	std::size_t items )
+{
+	const auto after = snapshot_t::make();
+	std::cout << title << ": allocations per item: "
+			<< double(after.m_allocations - before.m_allocations) / double(items)
+			<< ", bytes per item: "
+			<< double(after.m_bytes - before.m_bytes) / double(items)
+			<< std::endl;
+}
+
+} /* namespace alloc_stats */
+
+void *
+operator new( std::size_t size )
+{
+	++alloc_stats::g_allocations;
+	alloc_stats::g_bytes += size;
+
+	if( void * p = std::malloc( size ? size : 1u ) )
+		return p;
+
+	throw std::bad_alloc{};
+}
+
+void
+operator delete( void * p ) noexcept
+{
+	std::free( p );
+}
+
+void
+operator delete( void * p, std::size_t ) noexcept
+{
+	std::free( p );
+}
+
+struct cfg_t
+{
+	std::size_t m_handlers = 10000u;
+
+	unsigned long long m_calls = 10000000u;
+};
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last_arg = argv + argc;
+			current != last_arg;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.event_handler_method <options>\n"
+							"\noptions:\n"
+							"-s, --subscriptions  count of handlers/subscriptions\n"
+							"-c, --calls          count of calls of a handler\n"
+							"-h, --help           show this help"
+							<< std::endl;
+					std::exit( 1 );
+				}
+			else if( is_arg( *current, "-s", "--subscriptions" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_handlers, ++current, last_arg,
+						"-s", "count of handlers/subscriptions" );
+			else if( is_arg( *current, "-c", "--calls" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_calls, ++current, last_arg,
+						"-c", "count of calls of a handler" );
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	if( !tmp_cfg.m_handlers || !tmp_cfg.m_calls )
+		throw std::runtime_error( "counts can't be 0" );
+
+	return tmp_cfg;
+}
+
+struct msg_hello final : public so_5::signal_t {};
+
+class a_receiver_t final : public so_5::agent_t
+{
+public:
+	using so_5::agent_t::agent_t;
+
+	void
+	on_hello( mhood_t< msg_hello > )
+	{
+		++m_received;
+	}
+
+	void
+	subscribe_to( const std::vector< so_5::mbox_t > & mboxes )
+	{
+		for( const auto & mbox : mboxes )
+			so_subscribe( mbox ).event( &a_receiver_t::on_hello );
+	}
+
+	[[nodiscard]]
+	unsigned long long
+	received() const noexcept { return m_received; }
+
+private:
+	unsigned long long m_received{};
+};
+
+// The same form of lambda as SObjectizer creates for a pointer to method.
+[[nodiscard]]
+auto
+make_handler( a_receiver_t * agent )
+{
+	auto pfn = &a_receiver_t::on_hello;
+	return [agent, pfn]( so_5::message_ref_t & msg ) {
+			(agent->*pfn)( so_5::mhood_t< msg_hello >{ msg } );
+		};
+}
+
+template< typename Function >
+void
+measure_storage(
+	const char * title,
+	const cfg_t & cfg,
+	a_receiver_t * agent )
+{
+	std::vector< Function > handlers;
+	handlers.reserve( cfg.m_handlers );
+
+	const auto before = alloc_stats::snapshot_t::make();
+	for( std::size_t i = 0u; i != cfg.m_handlers; ++i )
+		handlers.emplace_back( make_handler( agent ) );
+
+	std::cout << title << ": sizeof: " << sizeof(Function) << ", ";
+	alloc_stats::show( "storage", before, cfg.m_handlers );
+}
+
+template< typename Function >
+void
+measure_calls(
+	const char * title,
+	const cfg_t & cfg,
+	a_receiver_t * agent )
+{
+	const Function handler{ make_handler( agent ) };
+	so_5::message_ref_t msg;
+
+	std::cout << title << ": ";
+
+	benchmarker_t benchmark;
+	benchmark.start();
+
+	for( unsigned long long i = 0u; i != cfg.m_calls; ++i )
+		{
+			// A copy is made for every event in agent_t::process_message.
+			Function copy{ handler };
+			copy( msg );
+		}
+
+	benchmark.finish_and_show_stats( cfg.m_calls, "calls" );
+}
+
+void
+measure_subscriptions( const cfg_t & cfg )
+{
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			std::vector< so_5::mbox_t > mboxes;
+			mboxes.reserve( cfg.m_handlers );
+			for( std::size_t i = 0u; i != cfg.m_handlers; ++i )
+				mboxes.push_back( env.create_mbox() );
+
+			auto coop = env.make_coop();
+			auto * agent = coop->make_agent< a_receiver_t >();
+
+			const auto before = alloc_stats::snapshot_t::make();
+			agent->subscribe_to( mboxes );
+			alloc_stats::show( "agent subscriptions", before, cfg.m_handlers );
+
+			env.register_coop( std::move(coop) );
+			env.stop();
+		} );
+}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		const cfg_t cfg = try_parse_cmdline( argc, argv );
+
+		so_5::wrapped_env_t sobj;
+		a_receiver_t * agent = nullptr;
+		sobj.environment().introduce_coop( [&]( so_5::coop_t & coop ) {
+				agent = coop.make_agent< a_receiver_t >();
+			} );
+
+		using std_function_t = std::function< void(so_5::message_ref_t &) >;
+
+		measure_storage< std_function_t >( "std::function", cfg, agent );
+		measure_storage< so_5::event_handler_method_t >(
+				"event_handler_method_t", cfg, agent );
+
+		measure_calls< std_function_t >( "std::function", cfg, agent );
+		measure_calls< so_5::event_handler_method_t >(
+				"event_handler_method_t", cfg, agent );
+
+		measure_subscriptions( cfg );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
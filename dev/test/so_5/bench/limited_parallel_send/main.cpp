@@ -0,0 +1,257 @@
+/*
+ * A benchmark of parallel send of messages from many senders
+ * to one agent with message limit.
+ *
+ * Every sender works on its own thread. The receiver uses
+ * limit_then_drop with an exact or a sharded counter of messages.
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/cmd_line_args_helpers.hpp>
+#include <test/3rd_party/various_helpers/benchmark_helpers.hpp>
+
+enum class counter_type_t
+{
+	exact,
+	sharded
+};
+
+struct cfg_t
+{
+	unsigned int m_sender_count = 32u;
+
+	unsigned int m_send_count = 100000u;
+
+	unsigned int m_limit = 1000u;
+
+	counter_type_t m_counter_type = counter_type_t::sharded;
+
+	unsigned int m_max_error = 256u;
+
+	std::size_t m_shard_count = 16u;
+};
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last_arg = argv + argc;
+			current != last_arg;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.limited_parallel_send <options>\n"
+							"\noptions:\n"
+							"-s, --senders        count of senders\n"
+							"-n, --send-count     count of messages from every sender\n"
+							"-l, --limit          message limit for the receiver\n"
+							"-c, --counter        type of message counter:\n"
+							"                     exact, sharded\n"
+							"-e, --max-error      max error for the sharded counter\n"
+							"-S, --shards         count of shards for the sharded counter\n"
+							"-h, --help           show this help"
+							<< std::endl;
+					std::exit( 1 );
+				}
+			else if( is_arg( *current, "-s", "--senders" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_sender_count, ++current, last_arg,
+						"-s", "count of senders" );
+			else if( is_arg( *current, "-n", "--send-count" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_send_count, ++current, last_arg,
+						"-n", "count of messages from every sender" );
+			else if( is_arg( *current, "-l", "--limit" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_limit, ++current, last_arg,
+						"-l", "message limit for the receiver" );
+			else if( is_arg( *current, "-c", "--counter" ) )
+				{
+					std::string name;
+					mandatory_arg_to_value(
+							name, ++current, last_arg,
+							"-c", "type of message counter" );
+					if( "exact" == name )
+						tmp_cfg.m_counter_type = counter_type_t::exact;
+					else if( "sharded" == name )
+						tmp_cfg.m_counter_type = counter_type_t::sharded;
+					else
+						throw std::runtime_error( "unsupported counter type: " + name );
+				}
+			else if( is_arg( *current, "-e", "--max-error" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_max_error, ++current, last_arg,
+						"-e", "max error for the sharded counter" );
+			else if( is_arg( *current, "-S", "--shards" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_shard_count, ++current, last_arg,
+						"-S", "count of shards for the sharded counter" );
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	if( !tmp_cfg.m_sender_count )
+		throw std::runtime_error( "count of senders can't be 0" );
+
+	return tmp_cfg;
+}
+
+void
+show_cfg( const cfg_t & cfg )
+{
+	std::cout << "senders: " << cfg.m_sender_count
+			<< ", send_count: " << cfg.m_send_count
+			<< ", limit: " << cfg.m_limit
+			<< ", counter: ";
+	if( counter_type_t::exact == cfg.m_counter_type )
+		std::cout << "exact";
+	else
+		std::cout << "sharded (max_error: " << cfg.m_max_error
+				<< ", shards: " << cfg.m_shard_count << ")";
+	std::cout << std::endl;
+}
+
+struct msg_data final : public so_5::signal_t {};
+
+struct msg_complete final : public so_5::signal_t {};
+
+class a_receiver_t final : public so_5::agent_t
+{
+	static so_5::message_limit::drop_indicator_t< msg_data >
+	make_limit( const cfg_t & cfg )
+	{
+		if( counter_type_t::exact == cfg.m_counter_type )
+			return limit_then_drop< msg_data >( cfg.m_limit );
+		else
+			return limit_then_drop< msg_data >( cfg.m_limit,
+					so_5::message_limit::sharded_counter(
+							cfg.m_max_error, cfg.m_shard_count ) );
+	}
+
+public :
+	a_receiver_t( context_t ctx, const cfg_t & cfg )
+		:	so_5::agent_t( ctx
+				+ make_limit( cfg )
+				+ limit_then_abort< msg_complete >( cfg.m_sender_count ) )
+		,	m_senders_left( cfg.m_sender_count )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( [this](mhood_t< msg_data >) { ++m_received; } )
+			.event( [this](mhood_t< msg_complete >) {
+					if( !(--m_senders_left) )
+						so_environment().stop();
+				} );
+	}
+
+	[[nodiscard]]
+	unsigned long long
+	received() const noexcept { return m_received; }
+
+private :
+	unsigned int m_senders_left;
+
+	unsigned long long m_received{};
+};
+
+class a_sender_t final : public so_5::agent_t
+{
+public :
+	a_sender_t(
+		context_t ctx,
+		so_5::mbox_t receiver,
+		unsigned int send_count )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_receiver( std::move(receiver) )
+		,	m_send_count( send_count )
+	{}
+
+	void
+	so_evt_start() override
+	{
+		for( unsigned int i = 0; i != m_send_count; ++i )
+			so_5::send< msg_data >( m_receiver );
+
+		so_5::send< msg_complete >( m_receiver );
+	}
+
+private :
+	const so_5::mbox_t m_receiver;
+
+	const unsigned int m_send_count;
+};
+
+void
+run_sobjectizer( const cfg_t & cfg )
+{
+	unsigned long long received{};
+
+	benchmarker_t benchmark;
+	benchmark.start();
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.introduce_coop( [&]( so_5::coop_t & coop ) {
+					auto * receiver = coop.make_agent_with_binder< a_receiver_t >(
+							so_5::disp::one_thread::make_dispatcher( env ).binder(),
+							cfg );
+					coop.add_dereg_notificator(
+							[receiver, &received](
+								so_5::environment_t &,
+								const so_5::coop_handle_t &,
+								const so_5::coop_dereg_reason_t & ) noexcept
+							{
+								received = receiver->received();
+							} );
+
+					auto senders_binder = so_5::disp::active_obj::make_dispatcher(
+							env ).binder();
+					for( unsigned int i = 0; i != cfg.m_sender_count; ++i )
+						coop.make_agent_with_binder< a_sender_t >(
+								senders_binder,
+								receiver->so_direct_mbox(),
+								cfg.m_send_count );
+				} );
+		} );
+
+	const auto total = static_cast< unsigned long long >(
+			cfg.m_sender_count ) * cfg.m_send_count;
+
+	benchmark.finish_and_show_stats( total, "sends" );
+
+	std::cout << "received: " << received
+			<< ", dropped: " << (total - received) << std::endl;
+}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		cfg_t cfg = try_parse_cmdline( argc, argv );
+		show_cfg( cfg );
+
+		run_sobjectizer( cfg );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
@@ -0,0 +1,324 @@
+/*
+ * A benchmark for measuring latency of event dispatching.
+ *
+ * Pinger and ponger agents work on different one_thread dispatchers.
+ * Round-trip time of every ping-pong is measured and percentiles are shown.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <cstdlib>
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/cmd_line_args_helpers.hpp>
+#include <test/3rd_party/various_helpers/benchmark_helpers.hpp>
+
+using namespace std::chrono;
+
+enum class lock_type_t
+{
+	combined,
+	simple,
+	busy_poll
+};
+
+struct	cfg_t
+{
+	unsigned int	m_request_count = 100000;
+
+	unsigned int	m_warmup_count = 10000;
+
+	lock_type_t	m_lock_type = lock_type_t::combined;
+
+	std::string	m_pinger_cpus;
+	std::string	m_ponger_cpus;
+};
+
+cfg_t
+try_parse_cmdline(
+	int argc,
+	char ** argv )
+{
+	cfg_t tmp_cfg;
+
+	for( char ** current = &argv[ 1 ], **last_arg = argv + argc;
+			current != last_arg;
+			++current )
+		{
+			if( is_arg( *current, "-h", "--help" ) )
+				{
+					std::cout << "usage:\n"
+							"_test.bench.so_5.ping_pong_latency <options>\n"
+							"\noptions:\n"
+							"-r, --requests       count of requests to measure\n"
+							"-w, --warmup         count of requests before measurement\n"
+							"-l, --lock           type of queue lock:\n"
+							"                       combined (default),\n"
+							"                       simple,\n"
+							"                       busy_poll\n"
+							"-p, --pinger-cpus    CPUs for pinger thread "
+									"(like \"2\" or \"2-3\")\n"
+							"-P, --ponger-cpus    CPUs for ponger thread\n"
+							"-h, --help           show this help"
+							<< std::endl;
+					std::exit( 1 );
+				}
+			else if( is_arg( *current, "-r", "--requests" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_request_count, ++current, last_arg,
+						"-r", "count of requests to measure" );
+			else if( is_arg( *current, "-w", "--warmup" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_warmup_count, ++current, last_arg,
+						"-w", "count of requests before measurement" );
+			else if( is_arg( *current, "-l", "--lock" ) )
+				{
+					std::string lock_type_literal;
+					mandatory_arg_to_value(
+							lock_type_literal,
+							++current, last_arg,
+							"-l", "type of queue lock" );
+					if( "combined" == lock_type_literal )
+						tmp_cfg.m_lock_type = lock_type_t::combined;
+					else if( "simple" == lock_type_literal )
+						tmp_cfg.m_lock_type = lock_type_t::simple;
+					else if( "busy_poll" == lock_type_literal )
+						tmp_cfg.m_lock_type = lock_type_t::busy_poll;
+					else
+						throw std::runtime_error( "unknown type of "
+								"queue lock: " + lock_type_literal );
+				}
+			else if( is_arg( *current, "-p", "--pinger-cpus" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_pinger_cpus, ++current, last_arg,
+						"-p", "CPUs for pinger thread" );
+			else if( is_arg( *current, "-P", "--ponger-cpus" ) )
+				mandatory_arg_to_value(
+						tmp_cfg.m_ponger_cpus, ++current, last_arg,
+						"-P", "CPUs for ponger thread" );
+			else
+				throw std::runtime_error(
+						std::string( "unknown argument: " ) + *current );
+		}
+
+	if( !tmp_cfg.m_request_count )
+		throw std::runtime_error( "count of requests can't be 0" );
+
+	return tmp_cfg;
+}
+
+struct ping final : public so_5::signal_t {};
+struct pong final : public so_5::signal_t {};
+
+class a_pinger_t final : public so_5::agent_t
+	{
+	public :
+		a_pinger_t(
+			context_t ctx,
+			const cfg_t & cfg,
+			std::vector< steady_clock::duration > & results )
+			:	so_5::agent_t{ std::move(ctx) }
+			,	m_total_count{ cfg.m_warmup_count + cfg.m_request_count }
+			,	m_warmup_count{ cfg.m_warmup_count }
+			,	m_results{ results }
+			{
+				m_results.reserve( cfg.m_request_count );
+			}
+
+		void
+		set_ponger_mbox( const so_5::mbox_t & mbox )
+			{
+				m_ponger_mbox = mbox;
+			}
+
+		void
+		so_define_agent() override
+			{
+				so_subscribe_self().event( &a_pinger_t::evt_pong );
+			}
+
+		void
+		so_evt_start() override
+			{
+				send_ping();
+			}
+
+	private :
+		const unsigned int m_total_count;
+		const unsigned int m_warmup_count;
+
+		std::vector< steady_clock::duration > & m_results;
+
+		so_5::mbox_t m_ponger_mbox;
+
+		unsigned int m_requests_sent{};
+
+		steady_clock::time_point m_sent_at;
+
+		void
+		evt_pong( mhood_t< pong > )
+			{
+				const auto rtt = steady_clock::now() - m_sent_at;
+				if( m_requests_sent > m_warmup_count )
+					m_results.push_back( rtt );
+
+				if( m_requests_sent < m_total_count )
+					send_ping();
+				else
+					so_environment().stop();
+			}
+
+		void
+		send_ping()
+			{
+				++m_requests_sent;
+				m_sent_at = steady_clock::now();
+				so_5::send< ping >( m_ponger_mbox );
+			}
+	};
+
+class a_ponger_t final : public so_5::agent_t
+	{
+	public :
+		a_ponger_t( context_t ctx, so_5::mbox_t pinger_mbox )
+			:	so_5::agent_t{ std::move(ctx) }
+			,	m_pinger_mbox{ std::move(pinger_mbox) }
+			{}
+
+		void
+		so_define_agent() override
+			{
+				so_subscribe_self().event( [this]( mhood_t< ping > ) {
+						so_5::send< pong >( m_pinger_mbox );
+					} );
+			}
+
+	private :
+		const so_5::mbox_t m_pinger_mbox;
+	};
+
+const char *
+lock_type_name( lock_type_t lock_type )
+	{
+		switch( lock_type )
+			{
+			case lock_type_t::combined: return "combined";
+			case lock_type_t::simple: return "simple";
+			case lock_type_t::busy_poll: return "busy_poll";
+			}
+		return "unknown";
+	}
+
+void
+show_cfg(
+	const cfg_t & cfg )
+	{
+		std::cout << "Configuration: "
+			<< "lock: " << lock_type_name( cfg.m_lock_type )
+			<< ", requests: " << cfg.m_request_count
+			<< ", warmup: " << cfg.m_warmup_count
+			<< ", pinger CPUs: "
+			<< ( cfg.m_pinger_cpus.empty() ? "any" : cfg.m_pinger_cpus )
+			<< ", ponger CPUs: "
+			<< ( cfg.m_ponger_cpus.empty() ? "any" : cfg.m_ponger_cpus )
+			<< std::endl;
+	}
+
+void
+show_result(
+	std::vector< steady_clock::duration > & results )
+	{
+		std::sort( results.begin(), results.end() );
+
+		const auto percentile = [&results]( double p ) {
+				const auto index = static_cast< std::size_t >(
+						p * double(results.size() - 1u) );
+				return double( duration_cast< nanoseconds >(
+						results[ index ] ).count() ) / 1000.0;
+			};
+
+		benchmarks_details::precision_settings_t precision{ std::cout, 6 };
+		std::cout << "round-trip time (us): "
+			<< "p50: " << percentile( 0.5 )
+			<< ", p99: " << percentile( 0.99 )
+			<< ", p99.9: " << percentile( 0.999 )
+			<< ", max: " << percentile( 1.0 )
+			<< std::endl;
+	}
+
+so_5::disp::one_thread::disp_params_t
+make_disp_params(
+	const cfg_t & cfg,
+	const std::string & cpus )
+	{
+		using namespace so_5::disp::one_thread;
+
+		disp_params_t params;
+		params.tune_queue_params( [&cfg]( queue_traits::queue_params_t & p ) {
+				switch( cfg.m_lock_type )
+					{
+					case lock_type_t::combined:
+						p.lock_factory( queue_traits::combined_lock_factory() );
+					break;
+
+					case lock_type_t::simple:
+						p.lock_factory( queue_traits::simple_lock_factory() );
+					break;
+
+					case lock_type_t::busy_poll:
+						p.lock_factory( queue_traits::busy_poll_lock_factory() );
+					break;
+					}
+			} );
+
+		if( !cpus.empty() )
+			params.work_thread_factory(
+					so_5::disp::affinity::make_work_thread_factory(
+							so_5::disp::affinity::params_t{}.cpus( cpus ) ) );
+
+		return params;
+	}
+
+int
+main( int argc, char ** argv )
+{
+	try
+	{
+		const cfg_t cfg = try_parse_cmdline( argc, argv );
+		show_cfg( cfg );
+
+		std::vector< steady_clock::duration > results;
+
+		so_5::launch( [&]( so_5::environment_t & env ) {
+				env.introduce_coop( [&]( so_5::coop_t & coop ) {
+						using namespace so_5::disp::one_thread;
+
+						auto pinger = coop.make_agent_with_binder< a_pinger_t >(
+								make_dispatcher( env, "pinger",
+										make_disp_params( cfg, cfg.m_pinger_cpus ) ).binder(),
+								cfg,
+								results );
+						auto ponger = coop.make_agent_with_binder< a_ponger_t >(
+								make_dispatcher( env, "ponger",
+										make_disp_params( cfg, cfg.m_ponger_cpus ) ).binder(),
+								pinger->so_direct_mbox() );
+
+						pinger->set_ponger_mbox( ponger->so_direct_mbox() );
+					} );
+			} );
+
+		show_result( results );
+
+		return 0;
+	}
+	catch( const std::exception & x )
+	{
+		std::cerr << "*** Exception caught: " << x.what() << std::endl;
+	}
+
+	return 2;
+}
@@ -0,0 +1,11 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	required_prj "so_5/prj.rb"
+
+	target "_test.bench.so_5.ping_pong_latency"
+
+	cpp_source "main.cpp"
+}
+
@@ -34,5 +34,6 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/destruction_order_1/prj.ut.rb" )
 	required_prj( "#{path}/this_agent_disp_binder/prj.ut.rb" )
 	required_prj( "#{path}/coop_disp_binder/prj.ut.rb" )
+	required_prj( "#{path}/parallel_final_dereg/prj.ut.rb" )
 }
 
@@ -0,0 +1,121 @@
+/*
+ * A test for the final deregistration of coops on several threads.
+ *
+ * A parent coop must be finally deregistered only after all its children.
+ */
+
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/ensure.hpp>
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+
+class a_empty_t final : public so_5::agent_t
+{
+	public :
+		using so_5::agent_t::agent_t;
+};
+
+class dereg_order_t
+{
+	public :
+		auto
+		make_notificator()
+		{
+			return [this](
+				so_5::environment_t &,
+				const so_5::coop_handle_t & handle,
+				const so_5::coop_dereg_reason_t & ) noexcept
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+				m_order[ handle.id() ] = m_counter++;
+			};
+		}
+
+		[[nodiscard]]
+		std::size_t
+		size() const
+		{
+			return m_order.size();
+		}
+
+		[[nodiscard]]
+		std::size_t
+		index_of( const so_5::coop_handle_t & handle ) const
+		{
+			const auto it = m_order.find( handle.id() );
+			ensure_or_die( it != m_order.end(),
+					"coop isn't deregistered: " + std::to_string( handle.id() ) );
+			return it->second;
+		}
+
+	private :
+		std::mutex m_lock;
+		std::size_t m_counter{};
+		std::map< so_5::coop_id_t, std::size_t > m_order;
+};
+
+constexpr std::size_t children_count = 50u;
+constexpr std::size_t grandchildren_count = 20u;
+
+int
+main()
+{
+	run_with_time_limit( [] {
+			dereg_order_t dereg_order;
+
+			so_5::coop_handle_t root;
+			std::vector< std::pair< so_5::coop_handle_t, so_5::coop_handle_t > >
+					relations;
+
+			so_5::launch(
+				[&]( so_5::environment_t & env )
+				{
+					auto disp = so_5::disp::thread_pool::make_dispatcher( env, 4u );
+
+					const auto make_coop = [&]( so_5::coop_handle_t parent ) {
+							auto coop = env.make_coop( parent, disp.binder() );
+							coop->add_dereg_notificator(
+									dereg_order.make_notificator() );
+							coop->make_agent< a_empty_t >();
+							return env.register_coop( std::move(coop) );
+						};
+
+					root = make_coop( so_5::coop_handle_t{} );
+					for( std::size_t i = 0u; i != children_count; ++i )
+					{
+						auto child = make_coop( root );
+						relations.emplace_back( root, child );
+
+						for( std::size_t j = 0u; j != grandchildren_count; ++j )
+							relations.emplace_back( child, make_coop( child ) );
+					}
+
+					env.deregister_coop( root, so_5::dereg_reason::normal );
+				},
+				[]( so_5::environment_params_t & params )
+				{
+					params.final_dereg_thread_count( 4u );
+				} );
+
+			ensure_or_die(
+					1u + children_count * (1u + grandchildren_count) ==
+							dereg_order.size(),
+					"unexpected count of deregistered coops: " +
+							std::to_string( dereg_order.size() ) );
+
+			for( const auto & [parent, child] : relations )
+				ensure_or_die(
+						dereg_order.index_of( child ) < dereg_order.index_of( parent ),
+						"child " + std::to_string( child.id() ) +
+						" is deregistered after its parent " +
+						std::to_string( parent.id() ) );
+		},
+		20 );
+
+	return 0;
+}
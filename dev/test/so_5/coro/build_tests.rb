@@ -0,0 +1,9 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	path = 'test/so_5/coro'
+
+	required_prj( "#{path}/receive_next/prj.ut.rb" )
+}
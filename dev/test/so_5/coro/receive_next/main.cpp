@@ -0,0 +1,216 @@
+/*
+ * A test for coroutines inside agents.
+ *
+ * A coroutine waits for a reply from another agent, for a signal
+ * that never arrives (the timeout must be detected) and for a message
+ * from a notifying mchain. Then a coroutine suspended at the moment
+ * of the deregistration of the agent has to be destroyed.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <iostream>
+
+#if defined( SO_5_HAVE_COROUTINES )
+
+using namespace std::chrono_literals;
+
+struct msg_request final : public so_5::message_t
+{
+	so_5::mbox_t m_reply_to;
+	int m_value;
+
+	msg_request( so_5::mbox_t reply_to, int value )
+		:	m_reply_to{ std::move(reply_to) }
+		,	m_value{ value }
+	{}
+};
+
+struct msg_reply final : public so_5::message_t
+{
+	int m_value;
+
+	explicit msg_reply( int value ) : m_value{ value } {}
+};
+
+struct msg_never final : public so_5::signal_t {};
+
+struct msg_from_chain final : public so_5::message_t
+{
+	std::string m_text;
+
+	explicit msg_from_chain( std::string text ) : m_text{ std::move(text) } {}
+};
+
+class a_server_t final : public so_5::agent_t
+{
+public:
+	a_server_t( context_t ctx )
+		:	so_5::agent_t{ std::move(ctx) }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( []( mhood_t< msg_request > cmd ) {
+				so_5::send< msg_reply >( cmd->m_reply_to, cmd->m_value * 2 );
+			} );
+	}
+};
+
+class a_client_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_server;
+	const so_5::coro::notifying_mchain_t m_chain;
+	std::string & m_trace;
+
+public:
+	a_client_t(
+		context_t ctx,
+		so_5::mbox_t server,
+		std::string & trace )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_server{ std::move(server) }
+		,	m_chain{ so_5::coro::make_notifying_mchain(
+				so_environment(),
+				so_5::make_unlimited_mchain_params() ) }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		so_5::coro::spawn( dialog() );
+	}
+
+private:
+	so_5::task< int >
+	ask( int value )
+	{
+		so_5::send< msg_request >( m_server, so_direct_mbox(), value );
+		auto reply = co_await so_5::coro::receive_next< msg_reply >(
+				*this, so_direct_mbox(), 5s );
+		ensure_or_die( reply.has_value(), "reply expected" );
+
+		co_return (*reply)->m_value;
+	}
+
+	so_5::task<>
+	dialog()
+	{
+		const auto first = co_await ask( 2 );
+		const auto second = co_await ask( first );
+		m_trace += "r" + std::to_string( second ) + ";";
+
+		const bool received = co_await so_5::coro::receive_next< msg_never >(
+				*this, so_direct_mbox(), 50ms );
+		m_trace += received ? "never;" : "timeout;";
+
+		so_5::send_delayed< msg_from_chain >( m_chain.chain(), 20ms, "hello" );
+		auto text = co_await so_5::coro::receive_next< msg_from_chain >(
+				*this, m_chain, 5s );
+		ensure_or_die( text.has_value(), "message from mchain expected" );
+		m_trace += "c" + (*text)->m_text + ";";
+
+		so_deregister_agent_coop_normally();
+	}
+};
+
+struct frame_guard_t
+{
+	bool & m_destroyed;
+
+	~frame_guard_t() { m_destroyed = true; }
+};
+
+class a_waiter_t final : public so_5::agent_t
+{
+	bool & m_destroyed;
+
+public:
+	a_waiter_t( context_t ctx, bool & destroyed )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_destroyed{ destroyed }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		so_5::coro::spawn( wait_forever() );
+		so_deregister_agent_coop_normally();
+	}
+
+private:
+	so_5::task<>
+	wait_forever()
+	{
+		frame_guard_t guard{ m_destroyed };
+		co_await so_5::coro::receive_next< msg_never >( *this, so_direct_mbox() );
+		ensure_or_die( false, "msg_never can't be received" );
+	}
+};
+
+void
+check_dialog()
+{
+	std::string trace;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.introduce_coop( [&]( so_5::coop_t & coop ) {
+					auto server = coop.make_agent< a_server_t >();
+					coop.make_agent< a_client_t >( server->so_direct_mbox(), trace );
+				} );
+		} );
+
+	ensure_or_die( "r8;timeout;chello;" == trace,
+			"unexpected trace: " + trace );
+}
+
+void
+check_destruction()
+{
+	bool destroyed = false;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.register_agent_as_coop( env.make_agent< a_waiter_t >( destroyed ) );
+		} );
+
+	ensure_or_die( destroyed, "suspended coroutine isn't destroyed" );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				check_dialog();
+				check_destruction();
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+#else
+
+int
+main()
+{
+	std::cout << "C++20 coroutines aren't supported, test skipped" << std::endl;
+
+	return 0;
+}
+
+#endif
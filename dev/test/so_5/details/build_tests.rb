@@ -9,4 +9,5 @@ MxxRu::Cpp::composite_target {
 	required_prj( "#{path}/remaining_time_counter/prj.ut.rb" )
 	required_prj( "#{path}/lock_holder_detector/prj.ut.rb" )
 	required_prj( "#{path}/null_mutex_lock_shared/prj.ut.rb" )
+	required_prj( "#{path}/small_function/prj.ut.rb" )
 }
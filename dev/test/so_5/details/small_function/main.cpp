@@ -0,0 +1,137 @@
+/*
+ * A test for so_5::details::small_function_t.
+ */
+
+#include <so_5/details/small_function.hpp>
+
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+using function_t = so_5::details::small_function_t<
+		void(int &), 4u * sizeof(void*) >;
+
+void
+check_empty()
+{
+	function_t f;
+	ensure_or_die( !f, "default constructed object must be empty" );
+
+	bool thrown = false;
+	try
+	{
+		int v = 0;
+		f( v );
+	}
+	catch( const std::bad_function_call & )
+	{
+		thrown = true;
+	}
+	ensure_or_die( thrown, "std::bad_function_call is expected" );
+
+	function_t copy{ f };
+	ensure_or_die( !copy, "copy of empty object must be empty" );
+}
+
+void
+check_small_trivial()
+{
+	int step = 2;
+	function_t f{ [step]( int & v ) { v += step; } };
+	ensure_or_die( static_cast< bool >( f ), "object must not be empty" );
+
+	function_t copy{ f };
+	function_t moved{ std::move(f) };
+	ensure_or_die( !f, "moved-from object must be empty" );
+
+	int v = 0;
+	copy( v );
+	moved( v );
+	ensure_or_die( 4 == v, "unexpected value: " + std::to_string( v ) );
+}
+
+void
+check_small_non_trivial()
+{
+	auto counter = std::make_shared< int >( 0 );
+	{
+		function_t f{ [counter]( int & v ) { v += ++(*counter); } };
+		ensure_or_die( 2 == counter.use_count(), "one copy must be captured" );
+
+		function_t copy;
+		copy = f;
+		ensure_or_die( 3 == counter.use_count(), "two copies must be captured" );
+
+		function_t moved;
+		moved = std::move(copy);
+		ensure_or_die( 3 == counter.use_count(),
+				"move must not create a new copy" );
+
+		int v = 0;
+		moved( v );
+		f( v );
+		ensure_or_die( 3 == v, "unexpected value: " + std::to_string( v ) );
+
+		swap( f, moved );
+		f = nullptr;
+		ensure_or_die( 2 == counter.use_count(), "one copy must be left" );
+	}
+	ensure_or_die( 1 == counter.use_count(), "all copies must be destroyed" );
+}
+
+void
+check_big()
+{
+	std::array< int, 32 > values{};
+	values[ 31 ] = 5;
+
+	auto counter = std::make_shared< int >( 0 );
+	{
+		function_t f{ [values, counter]( int & v ) mutable {
+				v += values[ 31 ];
+				++values[ 31 ];
+			} };
+
+		function_t copy{ f };
+		ensure_or_die( 3 == counter.use_count(), "two copies must be captured" );
+
+		int v = 0;
+		f( v );
+		f( v );
+		copy( v );
+		ensure_or_die( 16 == v, "unexpected value: " + std::to_string( v ) );
+
+		function_t moved{ std::move(f) };
+		moved( v );
+		ensure_or_die( 23 == v, "unexpected value: " + std::to_string( v ) );
+		ensure_or_die( 3 == counter.use_count(),
+				"move must not create a new copy" );
+	}
+	ensure_or_die( 1 == counter.use_count(), "all copies must be destroyed" );
+}
+
+void
+check_std_function()
+{
+	std::function< void(int &) > source = []( int & v ) { v = 42; };
+
+	function_t f{ source };
+	int v = 0;
+	f( v );
+	ensure_or_die( 42 == v, "unexpected value: " + std::to_string( v ) );
+}
+
+int
+main()
+{
+	check_empty();
+	check_small_trivial();
+	check_small_non_trivial();
+	check_big();
+	check_std_function();
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * A test for adv_thread_pool dispatcher: thread safe demands are taken
+ * by work threads in batches, but all of them must be finished before
+ * any thread unsafe handler and no thread safe handler can be started
+ * until a thread unsafe handler is finished.
+ */
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <atomic>
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+
+#include "../for_each_lock_factory.hpp"
+
+namespace atp_disp = so_5::disp::adv_thread_pool;
+
+const unsigned int thread_count = 4;
+const unsigned int safe_per_unsafe = 50;
+const unsigned int iterations = 100;
+
+struct msg_shutdown : public so_5::signal_t {};
+
+struct msg_safe_signal : public so_5::signal_t {};
+
+struct msg_unsafe_signal : public so_5::signal_t {};
+
+class a_test_t : public so_5::agent_t
+{
+	public:
+		a_test_t( context_t ctx )
+			:	so_5::agent_t( std::move(ctx) )
+		{}
+
+		void
+		so_define_agent() override
+		{
+			so_subscribe_self()
+				.event( &a_test_t::evt_shutdown )
+				.event( &a_test_t::evt_safe_signal, so_5::thread_safe )
+				.event( &a_test_t::evt_unsafe_signal );
+		}
+
+		void
+		so_evt_start() override
+		{
+			for( unsigned int i = 0; i != iterations; ++i )
+			{
+				for( unsigned int j = 0; j != safe_per_unsafe; ++j )
+					so_5::send< msg_safe_signal >( *this );
+
+				so_5::send< msg_unsafe_signal >( *this );
+			}
+
+			so_5::send< msg_shutdown >( *this );
+		}
+
+		void
+		evt_shutdown(mhood_t< msg_shutdown >)
+		{
+			if( iterations * safe_per_unsafe != m_safe_processed )
+				throw std::runtime_error( "not all safe signals are processed: " +
+						std::to_string( m_safe_processed.load() ) );
+
+			so_environment().stop();
+		}
+
+		void
+		evt_safe_signal(mhood_t< msg_safe_signal >)
+		{
+			++m_safe_in_progress;
+
+			if( m_unsafe_in_progress )
+				throw std::runtime_error( "safe handler is started during "
+						"unsafe one" );
+
+			++m_safe_processed;
+
+			--m_safe_in_progress;
+		}
+
+		void
+		evt_unsafe_signal(mhood_t< msg_unsafe_signal >)
+		{
+			m_unsafe_in_progress = true;
+
+			if( 0 != m_safe_in_progress )
+				throw std::runtime_error( "unsafe handler is started during "
+						"safe one" );
+
+			++m_unsafe_processed;
+			if( m_unsafe_processed * safe_per_unsafe != m_safe_processed )
+				throw std::runtime_error( "unexpected count of processed "
+						"safe signals: " + std::to_string( m_safe_processed.load() ) );
+
+			m_unsafe_in_progress = false;
+		}
+
+	private :
+		std::atomic_uint m_safe_in_progress{ 0 };
+		std::atomic_uint m_safe_processed{ 0 };
+		std::atomic_bool m_unsafe_in_progress{ false };
+		unsigned int m_unsafe_processed{ 0 };
+};
+
+void
+run_sobjectizer(
+	atp_disp::queue_traits::lock_factory_t factory,
+	std::size_t max_demands_at_once )
+{
+	so_5::launch(
+		[&]( so_5::environment_t & env )
+		{
+			using namespace atp_disp;
+
+			env.register_agent_as_coop(
+					env.make_agent< a_test_t >(),
+					make_dispatcher(
+							env,
+							"thread_pool",
+							disp_params_t{}
+									.thread_count( thread_count )
+									.set_queue_params(
+											queue_traits::queue_params_t{}
+													.lock_factory( factory ) ) )
+					.binder( bind_params_t{}
+							.max_demands_at_once( max_demands_at_once ) ) );
+		} );
+}
+
+int
+main()
+{
+	try
+	{
+		for_each_lock_factory( []( atp_disp::queue_traits::lock_factory_t factory ) {
+			for( std::size_t max_demands : { 0u, 1u, 7u, 64u } )
+				run_with_time_limit(
+					[&]()
+					{
+						run_sobjectizer( factory, max_demands );
+					},
+					20,
+					"batch test, max_demands_at_once: " +
+							std::to_string( max_demands ) );
+		} );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
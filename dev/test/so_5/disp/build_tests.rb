@@ -14,6 +14,10 @@ MxxRu::Cpp::composite_target {
 	add_test[ 'thread_pool/build_tests.rb' ]
 	add_test[ 'adv_thread_pool/build_tests.rb' ]
 	add_test[ 'nef_thread_pool/build_tests.rb' ]
+	add_test[ 'prio_thread_pool/build_tests.rb' ]
+	add_test[ 'edf_one_thread/build_tests.rb' ]
+	add_test[ 'epoll_one_thread/build_tests.rb' ]
+	add_test[ 'sharded_one_thread/build_tests.rb' ]
 
 	add_test[ 'private_dispatchers/build_tests.rb' ]
 
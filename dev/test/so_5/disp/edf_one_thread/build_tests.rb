@@ -0,0 +1,10 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	path = 'test/so_5/disp/edf_one_thread'
+
+	required_prj( "#{path}/order/prj.ut.rb" )
+	required_prj( "#{path}/expired/prj.ut.rb" )
+}
@@ -0,0 +1,204 @@
+/*
+ * A test for handling of expired messages in edf_one_thread dispatcher.
+ *
+ * The work thread of the dispatcher is blocked until the deadline of
+ * the first message is passed. That message has to be dropped or
+ * redirected to a separate mbox. Counters of expired and dropped
+ * demands are checked via run-time monitoring.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <cstring>
+#include <future>
+
+using namespace std::chrono_literals;
+
+namespace edf = so_5::disp::edf_one_thread;
+
+struct msg_blocked final : public so_5::signal_t {};
+struct msg_done final : public so_5::signal_t {};
+
+struct msg_request final
+	:	public so_5::message_t
+	,	public edf::with_deadline_t
+{
+	std::string m_id;
+
+	msg_request( std::string id, std::chrono::steady_clock::duration timeout )
+		:	edf::with_deadline_t{ timeout }
+		,	m_id{ std::move(id) }
+	{}
+};
+
+class a_worker_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	std::shared_future< void > m_released;
+
+public:
+	a_worker_t(
+		context_t ctx,
+		so_5::mbox_t test_mbox,
+		std::shared_future< void > released )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_released{ std::move(released) }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< msg_request > cmd ) {
+				ensure_or_die( "live" == cmd->m_id,
+						"unexpected request: " + cmd->m_id );
+				so_5::send< msg_done >( m_test_mbox );
+			} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_blocked >( m_test_mbox );
+		m_released.wait();
+	}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	const bool m_redirect;
+
+	so_5::mbox_t m_worker_mbox;
+	std::promise< void > m_release;
+
+	bool m_done_received{ false };
+	bool m_expired_received{ false };
+
+	std::size_t m_expected_dropped;
+	so_5::optional< std::size_t > m_expired_count;
+	so_5::optional< std::size_t > m_dropped_count;
+
+public:
+	a_test_t( context_t ctx, bool redirect )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_redirect{ redirect }
+		,	m_expected_dropped{ redirect ? 0u : 1u }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::evt_blocked )
+			.event( &a_test_t::evt_done )
+			.event( &a_test_t::evt_expired );
+
+		so_subscribe( so_environment().stats_controller().mbox() )
+			.event( &a_test_t::evt_monitor_quantity );
+	}
+
+	void
+	so_evt_start() override
+	{
+		edf::disp_params_t params;
+		if( m_redirect )
+			params.expired_demands_mbox( so_direct_mbox() );
+
+		so_environment().introduce_coop(
+			edf::make_dispatcher( so_environment(), "edf", params ).binder(),
+			[this]( so_5::coop_t & coop ) {
+				m_worker_mbox = coop.make_agent< a_worker_t >(
+						so_direct_mbox(),
+						m_release.get_future().share() )->so_direct_mbox();
+			} );
+	}
+
+private:
+	void
+	evt_blocked( mhood_t< msg_blocked > )
+	{
+		so_5::send< msg_request >( m_worker_mbox, "expired", 10ms );
+		so_5::send< msg_request >( m_worker_mbox, "live", 20s );
+
+		std::this_thread::sleep_for( 50ms );
+
+		m_release.set_value();
+	}
+
+	void
+	evt_done( mhood_t< msg_done > )
+	{
+		m_done_received = true;
+
+		so_environment().stats_controller().set_distribution_period( 50ms );
+		so_environment().stats_controller().turn_on();
+	}
+
+	void
+	evt_expired( mhood_t< msg_request > cmd )
+	{
+		ensure_or_die( m_redirect, "redirection isn't expected" );
+		ensure_or_die( "expired" == cmd->m_id,
+				"unexpected redirected request: " + cmd->m_id );
+
+		m_expired_received = true;
+	}
+
+	void
+	evt_monitor_quantity(
+		const so_5::stats::messages::quantity< std::size_t > & evt )
+	{
+		namespace stats = so_5::stats;
+
+		if( !std::strstr( evt.m_prefix.c_str(), "edf-ot" ) )
+			return;
+
+		if( stats::suffixes::expired_demands_count() == evt.m_suffix )
+			m_expired_count = evt.m_value;
+		else if( stats::suffixes::dropped_demands_count() == evt.m_suffix )
+			m_dropped_count = evt.m_value;
+
+		if( m_expired_count && m_dropped_count )
+		{
+			ensure_or_die( 1u == *m_expired_count,
+					"unexpected expired count: " +
+					std::to_string( *m_expired_count ) );
+			ensure_or_die( m_expected_dropped == *m_dropped_count,
+					"unexpected dropped count: " +
+					std::to_string( *m_dropped_count ) );
+			ensure_or_die( m_done_received, "msg_done isn't received" );
+			ensure_or_die( m_redirect == m_expired_received,
+					"unexpected state of redirection" );
+
+			so_environment().stop();
+		}
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				for( const bool redirect : { false, true } )
+					so_5::launch( [&]( so_5::environment_t & env ) {
+							env.register_agent_as_coop(
+									env.make_agent< a_test_t >( redirect ) );
+						} );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
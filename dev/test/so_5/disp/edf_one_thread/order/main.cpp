@@ -0,0 +1,151 @@
+/*
+ * A test for the order of demands in edf_one_thread dispatcher.
+ *
+ * The work thread of the dispatcher is blocked until all messages are
+ * sent. Then messages have to be handled in the order of their deadlines.
+ * A signal has no deadline (the time of sending is used instead)
+ * and it has to be handled first.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <future>
+
+using namespace std::chrono_literals;
+
+namespace edf = so_5::disp::edf_one_thread;
+
+struct msg_blocked final : public so_5::signal_t {};
+struct msg_signal final : public so_5::signal_t {};
+
+struct msg_request final
+	:	public so_5::message_t
+	,	public edf::with_deadline_t
+{
+	std::string m_id;
+
+	msg_request( std::string id, std::chrono::steady_clock::duration timeout )
+		:	edf::with_deadline_t{ timeout }
+		,	m_id{ std::move(id) }
+	{}
+};
+
+class a_worker_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	std::shared_future< void > m_released;
+	std::string & m_trace;
+
+public:
+	a_worker_t(
+		context_t ctx,
+		so_5::mbox_t test_mbox,
+		std::shared_future< void > released,
+		std::string & trace )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_released{ std::move(released) }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( [this]( mhood_t< msg_signal > ) {
+					m_trace += "s";
+				} )
+			.event( [this]( mhood_t< msg_request > cmd ) {
+					m_trace += cmd->m_id;
+					if( "d" == cmd->m_id )
+						so_environment().stop();
+				} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_blocked >( m_test_mbox );
+		m_released.wait();
+	}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	std::string & m_trace;
+
+	so_5::mbox_t m_worker_mbox;
+	std::promise< void > m_release;
+
+public:
+	a_test_t( context_t ctx, std::string & trace )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_test_t::evt_blocked );
+	}
+
+	void
+	so_evt_start() override
+	{
+		so_environment().introduce_coop(
+			edf::make_dispatcher( so_environment() ).binder(),
+			[this]( so_5::coop_t & coop ) {
+				m_worker_mbox = coop.make_agent< a_worker_t >(
+						so_direct_mbox(),
+						m_release.get_future().share(),
+						m_trace )->so_direct_mbox();
+			} );
+	}
+
+private:
+	void
+	evt_blocked( mhood_t< msg_blocked > )
+	{
+		so_5::send< msg_request >( m_worker_mbox, "5", 50s );
+		so_5::send< msg_request >( m_worker_mbox, "1", 10s );
+		so_5::send< msg_signal >( m_worker_mbox );
+		so_5::send< msg_request >( m_worker_mbox, "3", 30s );
+		so_5::send< msg_request >( m_worker_mbox, "d", 60s );
+		so_5::send< msg_request >( m_worker_mbox, "2", 20s );
+		so_5::send< msg_request >( m_worker_mbox, "4", 40s );
+
+		m_release.set_value();
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				std::string trace;
+
+				so_5::launch( [&]( so_5::environment_t & env ) {
+						env.register_agent_as_coop(
+								env.make_agent< a_test_t >( trace ) );
+					} );
+
+				ensure_or_die( "s12345d" == trace,
+						"unexpected trace: " + trace );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,10 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	path = 'test/so_5/disp/epoll_one_thread'
+
+	required_prj( "#{path}/pipe/prj.ut.rb" )
+	required_prj( "#{path}/busy_socketpair/prj.ut.rb" )
+}
@@ -0,0 +1,135 @@
+/*
+ * A test for epoll_one_thread dispatcher under a load.
+ *
+ * An agent sends signals to itself all the time, so the demand queue
+ * is never empty. Data is written to a socketpair from another thread.
+ * The notification about the readiness has to be delivered anyway.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <thread>
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace epoll_disp = so_5::disp::epoll_one_thread;
+
+class a_test_t final : public so_5::agent_t
+{
+	struct msg_spin final : public so_5::signal_t {};
+
+	const epoll_disp::fd_registry_shptr_t m_registry;
+	const int m_fd;
+
+	std::thread m_writer;
+
+public:
+	a_test_t(
+		context_t ctx,
+		epoll_disp::fd_registry_shptr_t registry,
+		int fd )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_registry{ std::move(registry) }
+		,	m_fd{ fd }
+	{}
+
+	~a_test_t() override
+	{
+		if( m_writer.joinable() )
+			m_writer.join();
+	}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( [this]( mhood_t< msg_spin > ) {
+					so_5::send< msg_spin >( *this );
+				} )
+			.event( &a_test_t::evt_ready );
+	}
+
+	void
+	so_evt_start() override
+	{
+		m_registry->add_fd( m_fd, EPOLLIN | EPOLLONESHOT, so_direct_mbox() );
+
+		// Two signals in the queue: it will never be empty.
+		so_5::send< msg_spin >( *this );
+		so_5::send< msg_spin >( *this );
+	}
+
+	void
+	so_evt_finish() override
+	{
+		m_registry->remove_fd( m_fd );
+	}
+
+	std::thread &
+	writer() noexcept { return m_writer; }
+
+private:
+	void
+	evt_ready( mhood_t< epoll_disp::msg_fd_ready > cmd )
+	{
+		ensure_or_die( m_fd == cmd->m_fd, "unexpected fd" );
+
+		char buf[ 16 ];
+		const auto rc = ::read( m_fd, buf, sizeof(buf) );
+		ensure_or_die( 0 < rc, "read() failed" );
+
+		so_deregister_agent_coop_normally();
+	}
+};
+
+#endif
+
+int
+main()
+{
+#if defined(__linux__)
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				int fds[ 2 ];
+				ensure_or_die(
+						0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ),
+						"socketpair() failed" );
+
+				so_5::launch( [&]( so_5::environment_t & env ) {
+						auto disp = epoll_disp::make_dispatcher( env, "busy" );
+						env.introduce_coop( disp.binder(),
+							[&]( so_5::coop_t & coop ) {
+								auto * agent = coop.make_agent< a_test_t >(
+										disp.fd_registry(), fds[ 0 ] );
+								agent->writer() = std::thread{ [fd = fds[ 1 ]] {
+										std::this_thread::sleep_for(
+												std::chrono::milliseconds( 100 ) );
+										const char data[] = "hello";
+										(void)::write( fd, data, sizeof(data) );
+									} };
+							} );
+					} );
+
+				::close( fds[ 0 ] );
+				::close( fds[ 1 ] );
+			},
+			20 );
+	}
+	catch(const std::exception & ex)
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+#endif
+
+	return 0;
+}
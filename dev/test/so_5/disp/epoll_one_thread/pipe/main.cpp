@@ -0,0 +1,145 @@
+/*
+ * A simple test for epoll_one_thread dispatcher.
+ *
+ * An agent registers the read end of a pipe and writes to the pipe
+ * several times. Every notification has to be handled on the work thread
+ * of the dispatcher. The descriptor is registered with EPOLLONESHOT and
+ * it's reactivated after every notification.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace epoll_disp = so_5::disp::epoll_one_thread;
+
+class a_test_t final : public so_5::agent_t
+{
+	struct msg_write final : public so_5::signal_t {};
+
+	const epoll_disp::fd_registry_shptr_t m_registry;
+
+	int m_pipe[ 2 ]{ -1, -1 };
+
+	so_5::current_thread_id_t m_thread_id;
+
+	std::string m_received;
+
+public:
+	a_test_t( context_t ctx, epoll_disp::fd_registry_shptr_t registry )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_registry{ std::move(registry) }
+	{}
+
+	~a_test_t() override
+	{
+		for( const int fd : m_pipe )
+			if( -1 != fd )
+				::close( fd );
+	}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::evt_write )
+			.event( &a_test_t::evt_ready );
+	}
+
+	void
+	so_evt_start() override
+	{
+		m_thread_id = so_5::query_current_thread_id();
+
+		ensure_or_die( 0 == ::pipe( m_pipe ), "pipe() failed" );
+
+		m_registry->add_fd(
+				m_pipe[ 0 ], EPOLLIN | EPOLLONESHOT, so_direct_mbox() );
+
+		// The second registration has to fail.
+		bool thrown = false;
+		try
+		{
+			m_registry->add_fd( m_pipe[ 0 ], EPOLLIN, so_direct_mbox() );
+		}
+		catch( const so_5::exception_t & x )
+		{
+			thrown = ( so_5::rc_io_readiness_notification_failure ==
+					x.error_code() );
+		}
+		ensure_or_die( thrown, "exception expected for duplicate fd" );
+
+		so_5::send< msg_write >( *this );
+	}
+
+	void
+	so_evt_finish() override
+	{
+		m_registry->remove_fd( m_pipe[ 0 ] );
+	}
+
+private:
+	void
+	evt_write( mhood_t< msg_write > )
+	{
+		const char ch = static_cast< char >( 'a' + m_received.size() );
+		ensure_or_die( 1 == ::write( m_pipe[ 1 ], &ch, 1 ), "write() failed" );
+	}
+
+	void
+	evt_ready( mhood_t< epoll_disp::msg_fd_ready > cmd )
+	{
+		ensure_or_die( so_5::query_current_thread_id() == m_thread_id,
+				"msg_fd_ready has to be handled on the dispatcher's thread" );
+		ensure_or_die( m_pipe[ 0 ] == cmd->m_fd, "unexpected fd" );
+		ensure_or_die( 0 != ( EPOLLIN & cmd->m_events ), "EPOLLIN expected" );
+
+		char ch;
+		ensure_or_die( 1 == ::read( m_pipe[ 0 ], &ch, 1 ), "read() failed" );
+		m_received += ch;
+
+		if( "abc" == m_received )
+			so_deregister_agent_coop_normally();
+		else
+		{
+			m_registry->modify_fd( m_pipe[ 0 ], EPOLLIN | EPOLLONESHOT );
+			so_5::send< msg_write >( *this );
+		}
+	}
+};
+
+#endif
+
+int
+main()
+{
+#if defined(__linux__)
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				so_5::launch( []( so_5::environment_t & env ) {
+						auto disp = epoll_disp::make_dispatcher( env, "pipe" );
+						env.introduce_coop( disp.binder(),
+							[&]( so_5::coop_t & coop ) {
+								coop.make_agent< a_test_t >( disp.fd_registry() );
+							} );
+					} );
+			},
+			20 );
+	}
+	catch(const std::exception & ex)
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+#endif
+
+	return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Check for the work thread factory with CPU affinity.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#if defined(__linux__)
+
+#include <sched.h>
+#include <unistd.h>
+
+namespace affinity = so_5::disp::affinity;
+
+using cpus_t = std::vector< unsigned int >;
+
+void
+check_parse_cpu_list()
+{
+	ensure_or_die( cpus_t{} == affinity::parse_cpu_list( "" ),
+			"empty list expected" );
+	ensure_or_die( cpus_t{ 3 } == affinity::parse_cpu_list( "3\n" ),
+			"{3} expected" );
+	ensure_or_die( cpus_t{ 0, 1, 2, 3, 8, 10, 11 } ==
+			affinity::parse_cpu_list( "0-3, 8,10-11" ),
+			"{0, 1, 2, 3, 8, 10, 11} expected" );
+
+	for( const auto invalid : { "1,", "a", "3-1", "1-", "-1", "1;2",
+			"0-4294967295", "8192", "4000000000" } )
+	{
+		bool thrown = false;
+		try
+		{
+			(void)affinity::parse_cpu_list( invalid );
+		}
+		catch( const so_5::exception_t & x )
+		{
+			thrown = so_5::rc_invalid_cpu_list == x.error_code();
+		}
+		ensure_or_die( thrown,
+				std::string{ "exception expected for: " } + invalid );
+	}
+}
+
+class fake_sysfs_t
+{
+	const std::filesystem::path m_root;
+
+	void
+	write( const std::filesystem::path & file, const std::string & content )
+	{
+		std::filesystem::create_directories( file.parent_path() );
+		std::ofstream{ file } << content << "\n";
+	}
+
+public:
+	// Two NUMA nodes with one package per node, two cores per package
+	// and two hardware threads per core.
+	fake_sysfs_t()
+		:	m_root{ std::filesystem::temp_directory_path() /
+				( "so5_affinity_test_" + std::to_string( ::getpid() ) ) }
+	{
+		const auto cpu_dir = m_root / "devices" / "system" / "cpu";
+		write( cpu_dir / "online", "0-7" );
+		for( unsigned int cpu = 0; cpu != 8; ++cpu )
+		{
+			const auto dir = cpu_dir / ( "cpu" + std::to_string( cpu ) ) / "topology";
+			write( dir / "core_id", std::to_string( cpu % 2 ) );
+			write( dir / "physical_package_id", std::to_string( cpu / 4 ) );
+		}
+
+		const auto node_dir = m_root / "devices" / "system" / "node";
+		write( node_dir / "node0" / "cpulist", "0-3" );
+		write( node_dir / "node1" / "cpulist", "4-7" );
+	}
+
+	~fake_sysfs_t()
+	{
+		std::error_code ec;
+		std::filesystem::remove_all( m_root, ec );
+	}
+
+	std::string
+	root() const { return m_root.string(); }
+};
+
+void
+check_topology()
+{
+	fake_sysfs_t sysfs;
+
+	const auto topology = affinity::query_cpu_topology( sysfs.root() );
+	ensure_or_die( 8u == topology.size(), "8 CPUs expected" );
+	ensure_or_die( 1u == topology[ 5 ].m_core &&
+			1u == topology[ 5 ].m_package &&
+			1u == topology[ 5 ].m_numa_node,
+			"unexpected description of CPU 5" );
+
+	const auto compact = affinity::make_cpu_sequence(
+			affinity::params_t{}.compact(), topology );
+	ensure_or_die( cpus_t{ 0, 2, 1, 3, 4, 6, 5, 7 } == compact,
+			"unexpected compact sequence" );
+
+	const auto scatter = affinity::make_cpu_sequence(
+			affinity::params_t{}.scatter(), topology );
+	ensure_or_die( cpus_t{ 0, 4, 1, 5, 2, 6, 3, 7 } == scatter,
+			"unexpected scatter sequence" );
+
+	const auto explicit_list = affinity::make_cpu_sequence(
+			affinity::params_t{}.cpus( "6,1" ), topology );
+	ensure_or_die( cpus_t{ 6, 1 } == explicit_list,
+			"unexpected explicit sequence" );
+
+	bool thrown = false;
+	try
+	{
+		(void)affinity::make_cpu_sequence(
+				affinity::params_t{}.cpus( "8" ), topology );
+	}
+	catch( const so_5::exception_t & x )
+	{
+		thrown = so_5::rc_invalid_cpu_list == x.error_code();
+	}
+	ensure_or_die( thrown, "exception expected for offline CPU" );
+}
+
+struct msg_cpu final : public so_5::message_t
+{
+	int m_cpu;
+
+	explicit msg_cpu( int cpu ) : m_cpu{ cpu } {}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_dest;
+
+public:
+	a_test_t( context_t ctx, so_5::mbox_t dest )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_dest{ std::move(dest) }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_cpu >( m_dest, ::sched_getcpu() );
+	}
+};
+
+void
+check_pinning()
+{
+	// The last CPU available for the process is used.
+	cpu_set_t allowed;
+	CPU_ZERO( &allowed );
+	ensure_or_die( 0 == ::sched_getaffinity( 0, sizeof(allowed), &allowed ),
+			"sched_getaffinity failed" );
+
+	int expected_cpu = -1;
+	for( int cpu = 0; cpu != CPU_SETSIZE; ++cpu )
+		if( CPU_ISSET( cpu, &allowed ) )
+			expected_cpu = cpu;
+	ensure_or_die( -1 != expected_cpu, "there are no allowed CPUs" );
+
+	auto factory = affinity::make_work_thread_factory(
+			affinity::params_t{}.cpus(
+					cpus_t{ static_cast< unsigned int >( expected_cpu ) } ) );
+
+	int actual_cpu = -1;
+	so_5::wrapped_env_t sobj;
+	auto ch = so_5::create_mchain( sobj );
+
+	sobj.environment().introduce_coop( [&]( so_5::coop_t & coop ) {
+			auto disp = so_5::disp::one_thread::make_dispatcher(
+					coop.environment(),
+					"pinned",
+					so_5::disp::one_thread::disp_params_t{}
+							.work_thread_factory( factory ) );
+
+			coop.make_agent_with_binder< a_test_t >(
+					disp.binder(), ch->as_mbox() );
+		} );
+
+	so_5::receive( so_5::from( ch ).handle_n( 1 ),
+			[&actual_cpu]( so_5::mhood_t< msg_cpu > cmd ) {
+				actual_cpu = cmd->m_cpu;
+			} );
+
+	ensure_or_die( expected_cpu == actual_cpu,
+			"unexpected CPU: " + std::to_string( actual_cpu ) +
+			", expected: " + std::to_string( expected_cpu ) );
+}
+
+#endif
+
+int
+main()
+{
+#if defined(__linux__)
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				check_parse_cpu_list();
+				check_topology();
+				check_pinning();
+			},
+			5 );
+	}
+	catch(const std::exception & ex)
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+#endif
+
+	return 0;
+}
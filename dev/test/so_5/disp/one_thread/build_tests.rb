@@ -7,4 +7,5 @@ MxxRu::Cpp::composite_target {
 
 	required_prj( "#{path}/custom_work_thread/prj.ut.rb" )
 	required_prj( "#{path}/custom_work_thread_2/prj.ut.rb" )
+	required_prj( "#{path}/affinity_work_thread/prj.ut.rb" )
 }
@@ -0,0 +1,188 @@
+/*
+ * A test for the order of agent selection in prio_thread_pool dispatcher.
+ *
+ * The only work thread of the dispatcher is blocked until agents with
+ * different priorities are registered. Then agents have to be started
+ * in the order defined by their priorities (and quotes if they are used).
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <future>
+
+namespace prio_tp = so_5::disp::prio_thread_pool;
+
+struct msg_blocked final : public so_5::signal_t {};
+struct msg_started final : public so_5::signal_t {};
+
+class a_blocker_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	std::shared_future< void > m_released;
+
+public:
+	a_blocker_t(
+		context_t ctx,
+		so_5::mbox_t test_mbox,
+		std::shared_future< void > released )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_released{ std::move(released) }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_blocked >( m_test_mbox );
+		m_released.wait();
+	}
+};
+
+class a_worker_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	std::string & m_trace;
+
+public:
+	a_worker_t(
+		context_t ctx,
+		so_5::priority_t priority,
+		so_5::mbox_t test_mbox,
+		std::string & trace )
+		:	so_5::agent_t{ ctx + priority }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		m_trace += std::to_string( so_5::to_size_t( so_priority() ) );
+		so_5::send< msg_started >( m_test_mbox );
+	}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	const prio_tp::disp_params_t m_disp_params;
+	const std::vector< so_5::priority_t > m_priorities;
+	std::string & m_trace;
+
+	prio_tp::dispatcher_handle_t m_disp;
+	std::promise< void > m_release;
+	std::size_t m_started{};
+
+public:
+	a_test_t(
+		context_t ctx,
+		prio_tp::disp_params_t disp_params,
+		std::vector< so_5::priority_t > priorities,
+		std::string & trace )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_disp_params{ std::move(disp_params) }
+		,	m_priorities{ std::move(priorities) }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::evt_blocked )
+			.event( &a_test_t::evt_started );
+	}
+
+	void
+	so_evt_start() override
+	{
+		m_disp = prio_tp::make_dispatcher(
+				so_environment(), "prio_pool", m_disp_params );
+
+		so_environment().introduce_coop( m_disp.binder(),
+			[this]( so_5::coop_t & coop ) {
+				coop.make_agent< a_blocker_t >(
+						so_direct_mbox(),
+						m_release.get_future().share() );
+			} );
+	}
+
+private:
+	void
+	evt_blocked( mhood_t< msg_blocked > )
+	{
+		// The work thread is blocked, all workers will wait in the
+		// dispatcher queue.
+		so_environment().introduce_coop( m_disp.binder(),
+			[this]( so_5::coop_t & coop ) {
+				for( const auto priority : m_priorities )
+					coop.make_agent< a_worker_t >(
+							priority, so_direct_mbox(), m_trace );
+			} );
+
+		m_release.set_value();
+	}
+
+	void
+	evt_started( mhood_t< msg_started > )
+	{
+		if( m_priorities.size() == ++m_started )
+			so_environment().stop();
+	}
+};
+
+void
+run_case(
+	const std::string & case_name,
+	prio_tp::disp_params_t disp_params,
+	std::vector< so_5::priority_t > priorities,
+	const std::string & expected )
+{
+	std::string trace;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.register_agent_as_coop( env.make_agent< a_test_t >(
+					std::move(disp_params),
+					std::move(priorities),
+					trace ) );
+		} );
+
+	ensure_or_die( expected == trace,
+			case_name + ": unexpected trace: " + trace +
+			", expected: " + expected );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				using namespace so_5::prio;
+
+				run_case( "strictly ordered",
+						prio_tp::disp_params_t{}.thread_count( 1 ),
+						{ p0, p3, p7, p1, p5, p2, p6, p4 },
+						"76543210" );
+
+				run_case( "quoted",
+						prio_tp::disp_params_t{}
+							.thread_count( 1 )
+							.quotes( prio_tp::quotes_t{ 1 }.set( p7, 2 ) ),
+						{ p0, p7, p0, p7, p0, p7, p7, p0 },
+						"77077000" );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
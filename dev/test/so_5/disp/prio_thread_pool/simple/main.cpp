@@ -0,0 +1,70 @@
+/*
+ * A simple test for prio_thread_pool dispatcher.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+
+struct msg_hello : public so_5::signal_t {};
+
+class a_test_t : public so_5::agent_t
+{
+	public:
+		a_test_t( context_t ctx, so_5::priority_t priority )
+			:	so_5::agent_t( ctx + priority )
+		{}
+
+		void
+		so_define_agent() override
+		{
+			so_subscribe_self().event( &a_test_t::evt_hello );
+		}
+
+		void
+		so_evt_start() override
+		{
+			so_5::send< msg_hello >( *this );
+		}
+
+		void
+		evt_hello(mhood_t< msg_hello >)
+		{
+			if( so_5::prio::p0 == so_priority() )
+				so_environment().stop();
+		}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				using namespace so_5::disp::prio_thread_pool;
+
+				so_5::launch(
+					[]( so_5::environment_t & env )
+					{
+						auto disp = make_dispatcher( env, "prio_pool", 4 );
+						env.introduce_coop( disp.binder(),
+							[]( so_5::coop_t & coop ) {
+								so_5::prio::for_each_priority(
+									[&coop]( so_5::priority_t priority ) {
+										coop.make_agent< a_test_t >( priority );
+									} );
+							} );
+					} );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,10 @@
+#!/usr/local/bin/ruby
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::composite_target {
+
+	path = 'test/so_5/disp/sharded_one_thread'
+
+	required_prj( "#{path}/order/prj.ut.rb" )
+	required_prj( "#{path}/migration/prj.ut.rb" )
+}
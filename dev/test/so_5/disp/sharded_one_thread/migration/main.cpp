@@ -0,0 +1,166 @@
+/*
+ * A test for migration of agents in sharded_one_thread dispatcher.
+ *
+ * There are two shards and four agents. Two busy agents are assigned
+ * to the same shard during the binding. One of them has to be moved
+ * to the idle shard if migration is enabled.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <mutex>
+#include <set>
+
+using namespace std::chrono_literals;
+
+namespace sot = so_5::disp::sharded_one_thread;
+
+constexpr unsigned int messages_per_agent = 20u;
+
+struct msg_work final : public so_5::signal_t {};
+struct msg_completed final : public so_5::signal_t {};
+
+struct thread_ids_t
+{
+	std::mutex m_lock;
+	std::set< std::thread::id > m_ids;
+
+	void
+	add()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		m_ids.insert( std::this_thread::get_id() );
+	}
+};
+
+class a_busy_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	thread_ids_t & m_thread_ids;
+	unsigned int m_processed{};
+
+public:
+	a_busy_t(
+		context_t ctx,
+		so_5::mbox_t test_mbox,
+		thread_ids_t & thread_ids )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_thread_ids{ thread_ids }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< msg_work > ) {
+				m_thread_ids.add();
+				std::this_thread::sleep_for( 5ms );
+
+				if( messages_per_agent == ++m_processed )
+					so_5::send< msg_completed >( m_test_mbox );
+			} );
+	}
+};
+
+class a_idle_t final : public so_5::agent_t
+{
+public:
+	using so_5::agent_t::agent_t;
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	const std::size_t m_migration_threshold;
+	thread_ids_t & m_thread_ids;
+	unsigned int m_completed{};
+
+public:
+	a_test_t(
+		context_t ctx,
+		std::size_t migration_threshold,
+		thread_ids_t & thread_ids )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_migration_threshold{ migration_threshold }
+		,	m_thread_ids{ thread_ids }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< msg_completed > ) {
+				if( 2u == ++m_completed )
+					so_environment().stop();
+			} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		auto disp = sot::make_dispatcher( so_environment(), "sot",
+				sot::disp_params_t{}
+					.thread_count( 2 )
+					.migration_threshold( m_migration_threshold ) );
+
+		std::vector< so_5::mbox_t > busy;
+		so_environment().introduce_coop( disp.binder(),
+			[&]( so_5::coop_t & coop ) {
+				// Agents are assigned to shards in the round-robin manner,
+				// so both busy agents belong to the first shard.
+				busy.push_back( coop.make_agent< a_busy_t >(
+						so_direct_mbox(), m_thread_ids )->so_direct_mbox() );
+				coop.make_agent< a_idle_t >();
+				busy.push_back( coop.make_agent< a_busy_t >(
+						so_direct_mbox(), m_thread_ids )->so_direct_mbox() );
+				coop.make_agent< a_idle_t >();
+			} );
+
+		for( const auto & mbox : busy )
+			for( unsigned int i = 0; i != messages_per_agent; ++i )
+				so_5::send< msg_work >( mbox );
+	}
+};
+
+std::size_t
+run_case( std::size_t migration_threshold )
+{
+	thread_ids_t thread_ids;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.register_agent_as_coop( env.make_agent< a_test_t >(
+					migration_threshold, thread_ids ) );
+		} );
+
+	return thread_ids.m_ids.size();
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				const auto without_migration = run_case( 0u );
+				ensure_or_die( 1u == without_migration,
+						"busy agents have to work on the same thread, threads: " +
+						std::to_string( without_migration ) );
+
+				const auto with_migration = run_case( sot::default_migration_threshold );
+				ensure_or_die( 2u == with_migration,
+						"busy agents have to work on different threads, threads: " +
+						std::to_string( with_migration ) );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
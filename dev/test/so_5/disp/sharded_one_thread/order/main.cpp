@@ -0,0 +1,129 @@
+/*
+ * A test for the order of demands in sharded_one_thread dispatcher.
+ *
+ * Agents are migrated between shards very often (the migration
+ * threshold is 1), but every agent has to receive its messages in
+ * the order of sending and its event handlers mustn't be called
+ * in parallel.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <atomic>
+
+namespace sot = so_5::disp::sharded_one_thread;
+
+constexpr unsigned int agent_count = 20u;
+constexpr unsigned int messages_per_agent = 1000u;
+
+struct msg_value final : public so_5::message_t
+{
+	unsigned int m_value;
+
+	explicit msg_value( unsigned int value ) : m_value{ value } {}
+};
+
+struct msg_completed final : public so_5::signal_t {};
+
+class a_receiver_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+
+	unsigned int m_expected{};
+	std::atomic< bool > m_in_handler{ false };
+
+public:
+	a_receiver_t( context_t ctx, so_5::mbox_t test_mbox )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( &a_receiver_t::evt_value );
+	}
+
+private:
+	void
+	evt_value( mhood_t< msg_value > cmd )
+	{
+		ensure_or_die( !m_in_handler.exchange( true ),
+				"parallel call of event handler" );
+
+		ensure_or_die( m_expected == cmd->m_value,
+				"unexpected value: " + std::to_string( cmd->m_value ) +
+				", expected: " + std::to_string( m_expected ) );
+
+		if( messages_per_agent == ++m_expected )
+			so_5::send< msg_completed >( m_test_mbox );
+
+		m_in_handler = false;
+	}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	std::vector< so_5::mbox_t > m_receivers;
+	unsigned int m_completed{};
+
+public:
+	a_test_t( context_t ctx )
+		:	so_5::agent_t{ std::move(ctx) }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< msg_completed > ) {
+				if( agent_count == ++m_completed )
+					so_environment().stop();
+			} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		auto disp = sot::make_dispatcher( so_environment(), "sot",
+				sot::disp_params_t{}
+					.thread_count( 3 )
+					.migration_threshold( 1 ) );
+
+		so_environment().introduce_coop( disp.binder(),
+			[this]( so_5::coop_t & coop ) {
+				for( unsigned int i = 0; i != agent_count; ++i )
+					m_receivers.push_back( coop.make_agent< a_receiver_t >(
+							so_direct_mbox() )->so_direct_mbox() );
+			} );
+
+		for( unsigned int v = 0; v != messages_per_agent; ++v )
+			for( const auto & mbox : m_receivers )
+				so_5::send< msg_value >( mbox, v );
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.register_agent_as_coop( env.make_agent< a_test_t >() );
+					} );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Check for the elastic mode of thread_pool dispatcher.
+ *
+ * The dispatcher starts with one thread. Several agents with individual
+ * FIFO are blocked until all of them are working at the same time.
+ * It's possible only if the dispatcher creates new threads.
+ * Then new threads have to be stopped after the keep_alive period.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include "../../custom_work_thread.hpp"
+
+using namespace std::chrono_literals;
+
+constexpr unsigned int max_threads = 4u;
+
+class a_worker_t final : public so_5::agent_t
+{
+	std::atomic< unsigned int > & m_active;
+
+public:
+	a_worker_t( context_t ctx, std::atomic< unsigned int > & active )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_active{ active }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		++m_active;
+		while( max_threads != m_active.load() )
+			std::this_thread::sleep_for( 1ms );
+	}
+};
+
+class a_controller_t final : public so_5::agent_t
+{
+	struct check_t final : public so_5::signal_t {};
+
+	const disp_tests::custom_work_thread_factory_t & m_factory;
+
+public:
+	a_controller_t(
+		context_t ctx,
+		const disp_tests::custom_work_thread_factory_t & factory )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_factory{ factory }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< check_t > ) {
+				ensure_or_die( m_factory.started() <= max_threads,
+						"too many threads started: " +
+						std::to_string( m_factory.started() ) );
+
+				// All additional threads have to be stopped.
+				if( max_threads - 1u == m_factory.finished() )
+					so_deregister_agent_coop_normally();
+				else
+					so_5::send_delayed< check_t >( *this, 10ms );
+			} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< check_t >( *this );
+	}
+};
+
+void
+run_test()
+{
+	auto factory = std::make_shared< disp_tests::custom_work_thread_factory_t >();
+	std::atomic< unsigned int > active{ 0u };
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.introduce_coop( [&]( so_5::coop_t & coop ) {
+					using namespace so_5::disp::thread_pool;
+
+					auto disp = make_dispatcher(
+							env,
+							"elastic",
+							disp_params_t{}
+								.elastic( elastic_params_t{ 1u, max_threads }
+										.keep_alive( 100ms )
+										.check_period( 5ms ) )
+								.work_thread_factory( factory ) );
+
+					for( unsigned int i = 0; i != max_threads; ++i )
+						coop.make_agent_with_binder< a_worker_t >(
+								disp.binder( bind_params_t{}.fifo( fifo_t::individual ) ),
+								active );
+
+					coop.make_agent< a_controller_t >( *factory );
+				} );
+		} );
+
+	// Additional threads can be started again during the deregistration
+	// because evt_finish demands form a backlog.
+	const auto started = factory->started();
+	ensure_or_die( max_threads <= started,
+			"unexpected number of started threads" );
+	ensure_or_die( started == factory->finished(),
+			"unexpected number of finished threads" );
+	ensure_or_die( started == factory->created(),
+			"unexpected number of created threads" );
+	ensure_or_die( started == factory->destroyed(),
+			"unexpected number of destroyed threads" );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]() {
+				run_test();
+			},
+			20 );
+	}
+	catch(const std::exception & ex)
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,209 @@
+/*
+ * A test for the time-sliced mode of thread_pool dispatcher.
+ *
+ * The only work thread of the dispatcher is blocked until messages
+ * for an agent with expensive handler and for an agent with cheap
+ * handler are sent. In the time-sliced mode the expensive agent has
+ * to give the work thread away after every message while the cheap
+ * agent has to process all its messages at once.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <future>
+
+using namespace std::chrono_literals;
+
+namespace tp = so_5::disp::thread_pool;
+
+constexpr std::size_t messages_per_agent = 5u;
+
+struct msg_blocked final : public so_5::signal_t {};
+struct msg_work final : public so_5::signal_t {};
+struct msg_processed final : public so_5::signal_t {};
+
+class a_blocker_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	std::shared_future< void > m_released;
+
+public:
+	a_blocker_t(
+		context_t ctx,
+		so_5::mbox_t test_mbox,
+		std::shared_future< void > released )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_released{ std::move(released) }
+	{}
+
+	void
+	so_evt_start() override
+	{
+		so_5::send< msg_blocked >( m_test_mbox );
+		m_released.wait();
+	}
+};
+
+class a_worker_t final : public so_5::agent_t
+{
+	const so_5::mbox_t m_test_mbox;
+	const char m_name;
+	const std::chrono::steady_clock::duration m_pause;
+	std::string & m_trace;
+
+public:
+	a_worker_t(
+		context_t ctx,
+		so_5::mbox_t test_mbox,
+		char name,
+		std::chrono::steady_clock::duration pause,
+		std::string & trace )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_test_mbox{ std::move(test_mbox) }
+		,	m_name{ name }
+		,	m_pause{ pause }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< msg_work > ) {
+				std::this_thread::sleep_for( m_pause );
+				m_trace += m_name;
+				so_5::send< msg_processed >( m_test_mbox );
+			} );
+	}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+	const tp::bind_params_t m_bind_params;
+	std::string & m_trace;
+
+	tp::dispatcher_handle_t m_disp;
+	std::promise< void > m_release;
+	std::size_t m_processed{};
+
+public:
+	a_test_t(
+		context_t ctx,
+		tp::bind_params_t bind_params,
+		std::string & trace )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_bind_params{ bind_params }
+		,	m_trace{ trace }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self()
+			.event( &a_test_t::evt_blocked )
+			.event( &a_test_t::evt_processed );
+	}
+
+	void
+	so_evt_start() override
+	{
+		m_disp = tp::make_dispatcher(
+				so_environment(), "pool", tp::disp_params_t{}.thread_count( 1 ) );
+
+		so_environment().introduce_coop(
+			m_disp.binder( tp::bind_params_t{}.fifo( tp::fifo_t::individual ) ),
+			[this]( so_5::coop_t & coop ) {
+				coop.make_agent< a_blocker_t >(
+						so_direct_mbox(),
+						m_release.get_future().share() );
+			} );
+	}
+
+private:
+	void
+	evt_blocked( mhood_t< msg_blocked > )
+	{
+		// Agents are registered in separate coops to have the order
+		// of scheduling of their queues fixed.
+		const auto expensive = make_worker( 'E', 30ms );
+		const auto cheap = make_worker( 'c', 0ms );
+
+		for( std::size_t i = 0; i != messages_per_agent; ++i )
+			so_5::send< msg_work >( expensive );
+		for( std::size_t i = 0; i != messages_per_agent; ++i )
+			so_5::send< msg_work >( cheap );
+
+		m_release.set_value();
+	}
+
+	void
+	evt_processed( mhood_t< msg_processed > )
+	{
+		if( 2u * messages_per_agent == ++m_processed )
+			so_environment().stop();
+	}
+
+	so_5::mbox_t
+	make_worker( char name, std::chrono::steady_clock::duration pause )
+	{
+		so_5::mbox_t result;
+		so_environment().introduce_coop(
+			m_disp.binder( tp::bind_params_t{ m_bind_params }
+					.fifo( tp::fifo_t::individual ) ),
+			[&]( so_5::coop_t & coop ) {
+				result = coop.make_agent< a_worker_t >(
+						so_direct_mbox(), name, pause, m_trace )->so_direct_mbox();
+			} );
+
+		return result;
+	}
+};
+
+void
+run_case(
+	const std::string & case_name,
+	tp::bind_params_t bind_params,
+	const std::string & expected )
+{
+	std::string trace;
+
+	so_5::launch( [&]( so_5::environment_t & env ) {
+			env.register_agent_as_coop( env.make_agent< a_test_t >(
+					bind_params, trace ) );
+		} );
+
+	ensure_or_die( expected == trace,
+			case_name + ": unexpected trace: " + trace +
+			", expected: " + expected );
+}
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				// evt_start and 3 messages at once.
+				run_case( "max_demands_at_once",
+						tp::bind_params_t{},
+						"EEEcccEEcc" );
+
+				run_case( "time_slice",
+						tp::bind_params_t{}.time_slice( 20ms ),
+						"EcccccEEEE" );
+			},
+			20 );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
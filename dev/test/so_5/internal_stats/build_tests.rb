@@ -12,6 +12,7 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/simple_work_thread_activity/prj.ut.rb"
 	required_prj "#{path}/simple_work_thread_activity_wrapped_env/prj.ut.rb"
 	required_prj "#{path}/quantity_int/prj.ut.rb"
+	required_prj "#{path}/final_dereg_wait_time/prj.ut.rb"
 
 	required_prj "#{path}/all_dispatchers/prj.rb"
 }
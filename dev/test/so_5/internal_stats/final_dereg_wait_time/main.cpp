@@ -0,0 +1,146 @@
+/*
+ * A test for coop.final.dereg.wait_us data source.
+ *
+ * The final deregistration thread is blocked by a dereg notificator
+ * of the first coop. The second coop has to wait in the final dereg chain
+ * and the wait time has to grow. When the final deregistration thread is
+ * released the wait time has to become zero.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+
+#include <future>
+
+using namespace std::chrono_literals;
+
+struct blocker_started final : public so_5::signal_t {};
+
+class a_test_t final : public so_5::agent_t
+	{
+		enum class stage_t
+			{
+				waiting_blocked_coop,
+				waiting_empty_chain
+			};
+
+		class empty_actor_t final : public so_5::agent_t
+			{
+			public :
+				using so_5::agent_t::agent_t;
+			};
+
+	public :
+		a_test_t( context_t ctx )
+			:	so_5::agent_t{ std::move(ctx) }
+			{}
+
+		void
+		so_define_agent() override
+			{
+				so_subscribe_self().event( &a_test_t::evt_blocker_started );
+
+				so_subscribe( so_environment().stats_controller().mbox() )
+					.event( &a_test_t::evt_monitor_quantity );
+			}
+
+		void
+		so_evt_start() override
+			{
+				auto blocker = so_5::create_child_coop( *this );
+				blocker->make_agent< empty_actor_t >();
+				blocker->add_dereg_notificator(
+						[this, released = m_release.get_future().share()](
+							so_5::environment_t &,
+							const so_5::coop_handle_t &,
+							const so_5::coop_dereg_reason_t & ) noexcept
+						{
+							so_5::send< blocker_started >( *this );
+							released.wait();
+						} );
+
+				auto handle = so_environment().register_coop( std::move(blocker) );
+				so_environment().deregister_coop(
+						handle, so_5::dereg_reason::normal );
+			}
+
+	private :
+		std::promise< void > m_release;
+
+		stage_t m_stage{ stage_t::waiting_blocked_coop };
+
+		std::size_t m_last_count{ 0u };
+		std::size_t m_last_wait_us{ 0u };
+
+		void
+		evt_blocker_started( mhood_t< blocker_started > )
+			{
+				// The final deregistration thread is blocked now.
+				// This coop has to wait in the final dereg chain.
+				auto victim = so_5::create_child_coop( *this );
+				victim->make_agent< empty_actor_t >();
+
+				auto handle = so_environment().register_coop( std::move(victim) );
+				so_environment().deregister_coop(
+						handle, so_5::dereg_reason::normal );
+
+				so_environment().stats_controller().set_distribution_period( 50ms );
+				so_environment().stats_controller().turn_on();
+			}
+
+		void
+		evt_monitor_quantity(
+			const so_5::stats::messages::quantity< std::size_t > & evt )
+			{
+				namespace stats = so_5::stats;
+
+				if( stats::prefixes::coop_repository() != evt.m_prefix )
+					return;
+
+				if( stats::suffixes::coop_final_dereg_count() == evt.m_suffix )
+					m_last_count = evt.m_value;
+				else if( stats::suffixes::coop_final_dereg_wait_time() == evt.m_suffix )
+					m_last_wait_us = evt.m_value;
+				else
+					return;
+
+				if( stage_t::waiting_blocked_coop == m_stage )
+					{
+						if( 0u != m_last_count && m_last_wait_us >= 200'000u )
+							{
+								m_stage = stage_t::waiting_empty_chain;
+								m_release.set_value();
+							}
+					}
+				else if( 0u == m_last_count && 0u == m_last_wait_us )
+					so_deregister_agent_coop_normally();
+			}
+	};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				so_5::launch( []( so_5::environment_t & env ) {
+						env.register_agent_as_coop( env.make_agent< a_test_t >() );
+					},
+					[]( so_5::environment_params_t & params ) {
+						params.final_dereg_thread_count( 1u );
+					} );
+			},
+			20,
+			"final dereg wait time monitoring test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
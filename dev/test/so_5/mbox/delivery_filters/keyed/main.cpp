@@ -0,0 +1,237 @@
+/*
+ * A test for keyed delivery filters.
+ */
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+const int keys_count = 10;
+const int keyed_listeners_count = 50;
+const int phases_count = 3;
+
+struct data
+{
+	int m_key;
+	std::string m_symbol;
+};
+
+struct next_phase : public so_5::signal_t {};
+
+struct counters_t
+{
+	int m_keyed{ 0 };
+	int m_symbol{ 0 };
+	int m_switcher{ 0 };
+};
+
+class a_keyed_listener_t final : public so_5::agent_t
+{
+public :
+	a_keyed_listener_t(
+		context_t ctx,
+		so_5::mbox_t data_mbox,
+		int key,
+		counters_t & counters )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_data_mbox( std::move(data_mbox) )
+		,	m_key( key )
+		,	m_counters( counters )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_set_keyed_delivery_filter( m_data_mbox,
+			[]( const data & msg ) { return msg.m_key; },
+			m_key );
+
+		so_subscribe( m_data_mbox ).event( [this]( const data & msg ) {
+				ensure_or_die( m_key == msg.m_key,
+						"unexpected key: " + std::to_string( msg.m_key ) +
+						", expected: " + std::to_string( m_key ) );
+				++m_counters.m_keyed;
+			} );
+	}
+
+private :
+	const so_5::mbox_t m_data_mbox;
+	const int m_key;
+	counters_t & m_counters;
+};
+
+class a_symbol_listener_t final : public so_5::agent_t
+{
+public :
+	a_symbol_listener_t(
+		context_t ctx,
+		so_5::mbox_t data_mbox,
+		counters_t & counters )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_data_mbox( std::move(data_mbox) )
+		,	m_counters( counters )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		// Subscription is made before setting the filter.
+		so_subscribe( m_data_mbox ).event( [this]( const data & msg ) {
+				ensure_or_die( "S7" == msg.m_symbol,
+						"unexpected symbol: " + msg.m_symbol );
+				++m_counters.m_symbol;
+			} );
+
+		so_set_keyed_delivery_filter( m_data_mbox,
+			[]( const data & msg ) -> const std::string & {
+				return msg.m_symbol;
+			},
+			"S7" );
+	}
+
+private :
+	const so_5::mbox_t m_data_mbox;
+	counters_t & m_counters;
+};
+
+// Replaces keyed filter by ordinary one and then drops it.
+class a_switcher_t final : public so_5::agent_t
+{
+public :
+	a_switcher_t(
+		context_t ctx,
+		so_5::mbox_t data_mbox,
+		counters_t & counters )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_data_mbox( std::move(data_mbox) )
+		,	m_counters( counters )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_set_keyed_delivery_filter( m_data_mbox,
+			[]( const data & msg ) { return msg.m_key; },
+			3 );
+
+		so_subscribe( m_data_mbox ).event( &a_switcher_t::evt_data );
+	}
+
+private :
+	const so_5::mbox_t m_data_mbox;
+	counters_t & m_counters;
+
+	void
+	evt_data( mhood_t< data > cmd )
+	{
+		++m_counters.m_switcher;
+
+		if( 1 == m_counters.m_switcher )
+		{
+			ensure_or_die( 3 == cmd->m_key,
+					"unexpected key for keyed filter: " +
+					std::to_string( cmd->m_key ) );
+			so_set_delivery_filter( m_data_mbox,
+				[]( const data & msg ) { return 4 == msg.m_key; } );
+		}
+		else if( 2 == m_counters.m_switcher )
+		{
+			ensure_or_die( 4 == cmd->m_key,
+					"unexpected key for ordinary filter: " +
+					std::to_string( cmd->m_key ) );
+			so_drop_delivery_filter< data >( m_data_mbox );
+		}
+	}
+};
+
+class a_test_t final : public so_5::agent_t
+{
+public :
+	a_test_t( context_t ctx, so_5::mbox_t data_mbox )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_data_mbox( std::move(data_mbox) )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this]( mhood_t< next_phase > ) {
+				if( phases_count == ++m_phase )
+					so_deregister_agent_coop_normally();
+				else
+					send_phase();
+			} );
+	}
+
+	void
+	so_evt_start() override
+	{
+		send_phase();
+	}
+
+private :
+	const so_5::mbox_t m_data_mbox;
+	int m_phase{ 0 };
+
+	void
+	send_phase()
+	{
+		for( int i = 0; i != keys_count; ++i )
+			so_5::send< data >( m_data_mbox, i, "S" + std::to_string( i ) );
+
+		so_5::send< next_phase >( *this );
+	}
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				counters_t counters;
+
+				so_5::launch( [&]( so_5::environment_t & env ) {
+						env.introduce_coop( [&]( so_5::coop_t & coop ) {
+								const auto mbox = env.create_mbox();
+
+								for( int i = 0; i != keyed_listeners_count; ++i )
+									coop.make_agent< a_keyed_listener_t >(
+											mbox, i % keys_count, counters );
+
+								coop.make_agent< a_symbol_listener_t >( mbox, counters );
+								coop.make_agent< a_switcher_t >( mbox, counters );
+								coop.make_agent< a_test_t >( mbox );
+							} );
+					} );
+
+				ensure_or_die(
+						phases_count * keyed_listeners_count == counters.m_keyed,
+						"unexpected count for keyed listeners: " +
+						std::to_string( counters.m_keyed ) );
+				ensure_or_die( phases_count == counters.m_symbol,
+						"unexpected count for symbol listener: " +
+						std::to_string( counters.m_symbol ) );
+				ensure_or_die( 2 + keys_count == counters.m_switcher,
+						"unexpected count for switcher: " +
+						std::to_string( counters.m_switcher ) );
+			},
+			20,
+			"keyed delivery filter test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -46,5 +46,7 @@ MxxRu::Cpp::composite_target {
 	required_prj "#{path}/subscription_unsubscription_1/prj.ut.rb"
 
 	required_prj "#{path}/state_time_limit/prj.ut.rb"
+
+	required_prj "#{path}/sharded_counter/prj.ut.rb"
 }
 
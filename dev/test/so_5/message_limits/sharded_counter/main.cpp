@@ -0,0 +1,145 @@
+/*
+ * A test for message limits with sharded counter of messages.
+ */
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/ensure.hpp>
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+
+struct msg_data final : public so_5::signal_t {};
+
+constexpr unsigned int limit = 20u;
+constexpr unsigned int max_error = 12u;
+constexpr std::size_t shard_count = 4u;
+
+constexpr std::size_t sender_count = 8u;
+constexpr unsigned int messages_per_sender = 1000u;
+
+struct shared_data_t
+{
+	std::atomic< bool > m_senders_finished{ false };
+
+	std::atomic< unsigned int > m_received{ 0u };
+	std::atomic< unsigned int > m_redirected{ 0u };
+};
+
+class a_receiver_t final : public so_5::agent_t
+{
+public :
+	a_receiver_t(
+		context_t ctx,
+		shared_data_t & data,
+		so_5::mbox_t overflow )
+		:	so_5::agent_t( ctx
+				+ limit_then_redirect< msg_data >( limit,
+						std::move(overflow),
+						so_5::message_limit::sharded_counter(
+								max_error, shard_count ) ) )
+		,	m_data( data )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this](mhood_t< msg_data >) {
+				// The first message blocks the receiver until all
+				// messages are sent.
+				while( !m_data.m_senders_finished.load() )
+					std::this_thread::sleep_for( std::chrono::milliseconds(5) );
+
+				++m_data.m_received;
+			} );
+	}
+
+private :
+	shared_data_t & m_data;
+};
+
+class a_overflow_handler_t final : public so_5::agent_t
+{
+public :
+	a_overflow_handler_t( context_t ctx, shared_data_t & data )
+		:	so_5::agent_t( std::move(ctx) )
+		,	m_data( data )
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event( [this](mhood_t< msg_data >) {
+				++m_data.m_redirected;
+			} );
+	}
+
+private :
+	shared_data_t & m_data;
+};
+
+int
+main()
+{
+	try
+	{
+		run_with_time_limit(
+			[]()
+			{
+				shared_data_t data;
+
+				so_5::wrapped_env_t sobj;
+
+				so_5::mbox_t receiver;
+				sobj.environment().introduce_coop(
+					so_5::disp::active_obj::make_dispatcher(
+							sobj.environment() ).binder(),
+					[&]( so_5::coop_t & coop ) {
+						auto * overflow = coop.make_agent< a_overflow_handler_t >(
+								data );
+						receiver = coop.make_agent< a_receiver_t >(
+								data,
+								overflow->so_direct_mbox() )->so_direct_mbox();
+					} );
+
+				std::vector< std::thread > senders;
+				for( std::size_t i = 0u; i != sender_count; ++i )
+					senders.emplace_back( [receiver] {
+							for( unsigned int m = 0u; m != messages_per_sender; ++m )
+								so_5::send< msg_data >( receiver );
+						} );
+				for( auto & t : senders )
+					t.join();
+
+				data.m_senders_finished = true;
+
+				const unsigned int total = sender_count * messages_per_sender;
+				while( data.m_received.load() + data.m_redirected.load() != total )
+					std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+
+				const auto received = data.m_received.load();
+
+				ensure_or_die( received >= limit,
+						"too few messages received: " +
+						std::to_string( received ) );
+				ensure_or_die( received <= limit + max_error,
+						"too many messages received: " +
+						std::to_string( received ) );
+			},
+			20,
+			"message limit with sharded counter test" );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
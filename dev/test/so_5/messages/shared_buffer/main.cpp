@@ -0,0 +1,177 @@
+/*
+ * Test for shared_buffer_t and shared_buffer_message.
+ */
+
+#include <so_5/all.hpp>
+
+#include <test/3rd_party/various_helpers/time_limited_execution.hpp>
+#include <test/3rd_party/various_helpers/ensure.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace std::string_view_literals;
+
+void
+check_slices()
+{
+	const auto content = "Hello, World!"sv;
+	const auto buf = so_5::make_shared_buffer( content.data(), content.size() );
+
+	ensure_or_die( content == buf.as_string_view(), "unexpected content" );
+
+	const auto hello = buf.slice( 0u, 5u );
+	ensure_or_die( "Hello"sv == hello.as_string_view(), "unexpected slice" );
+	ensure_or_die( hello.data() == buf.data(), "slice must not copy the content" );
+	ensure_or_die( hello.shares_storage_with( buf ), "slice must share storage" );
+
+	const auto world = buf.slice( 7u );
+	ensure_or_die( "World!"sv == world.as_string_view(), "unexpected tail slice" );
+
+	const auto empty_tail = buf.slice( buf.size() );
+	ensure_or_die( empty_tail.empty(), "tail slice should be empty" );
+
+	bool thrown = false;
+	try
+	{
+		(void)buf.slice( 7u, 100u );
+	}
+	catch( const so_5::exception_t & x )
+	{
+		thrown = so_5::rc_shared_buffer_out_of_range == x.error_code();
+	}
+	ensure_or_die( thrown, "out of range slice should throw" );
+
+	const so_5::shared_buffer_t nothing;
+	ensure_or_die( nothing.empty() && nullptr == nothing.data(),
+			"default constructed buffer should be empty" );
+}
+
+void
+check_adopted_buffer()
+{
+	int deleted = 0;
+	{
+		auto * block = new std::byte[ 16 ];
+		auto buf = so_5::adopt_shared_buffer( block, 16u,
+				[&deleted]( std::byte * p, std::size_t ) noexcept {
+					++deleted;
+					delete[] p;
+				} );
+		ensure_or_die( buf.data() == block, "adopted block must not be copied" );
+
+		auto part = buf.slice( 8u );
+		buf = so_5::shared_buffer_t{};
+		ensure_or_die( 0 == deleted, "block is deleted while it's still used" );
+	}
+	ensure_or_die( 1 == deleted, "block must be deleted exactly once" );
+}
+
+void
+check_mapped_file()
+{
+#if defined(SO_5_OS_UNIX) || defined(SO_5_OS_APPLE)
+	const std::string file_name{ "_unit.test.messages.shared_buffer.tmp" };
+	{
+		std::ofstream f{ file_name, std::ios::binary };
+		f << "mapped content";
+	}
+
+	{
+		const auto buf = so_5::map_file_to_shared_buffer( file_name );
+		ensure_or_die( "mapped content"sv == buf.as_string_view(),
+				"unexpected content of mapped file" );
+		ensure_or_die( "content"sv == buf.slice( 7u ).as_string_view(),
+				"unexpected slice of mapped file" );
+	}
+
+	std::remove( file_name.c_str() );
+#endif
+}
+
+class a_receiver_t final : public so_5::agent_t
+{
+public:
+	a_receiver_t(
+		context_t ctx,
+		const std::byte * expected_data,
+		so_5::mbox_t ack )
+		:	so_5::agent_t{ std::move(ctx) }
+		,	m_expected_data{ expected_data }
+		,	m_ack{ std::move(ack) }
+	{}
+
+	void
+	so_define_agent() override
+	{
+		so_subscribe_self().event(
+			[this]( mhood_t< so_5::shared_buffer_message > cmd ) {
+				ensure_or_die( cmd->data() == m_expected_data,
+						"content must not be copied during delivery" );
+
+				// Forward only a part without copying.
+				m_holder = cmd.make_holder();
+				so_5::send< so_5::shared_buffer_message >( m_ack,
+						m_holder->buffer().slice( 0u, 4u ) );
+			} );
+	}
+
+private:
+	const std::byte * m_expected_data;
+	const so_5::mbox_t m_ack;
+
+	so_5::message_holder_t< so_5::shared_buffer_message > m_holder;
+};
+
+void
+check_delivery()
+{
+	run_with_time_limit( [] {
+			so_5::wrapped_env_t sobj;
+
+			const auto buf = so_5::make_shared_buffer( 1024u,
+					[]( std::byte * data, std::size_t size ) {
+						for( std::size_t i = 0u; i != size; ++i )
+							data[ i ] = static_cast< std::byte >( i );
+					} );
+
+			auto ch = so_5::create_mchain( sobj );
+
+			std::vector< so_5::mbox_t > receivers;
+			sobj.environment().introduce_coop(
+				so_5::disp::active_obj::make_dispatcher(
+						sobj.environment() ).binder(),
+				[&]( so_5::coop_t & coop ) {
+					for( int i = 0; i != 3; ++i )
+						receivers.push_back( coop.make_agent< a_receiver_t >(
+								buf.data(), ch->as_mbox() )->so_direct_mbox() );
+				} );
+
+			for( const auto & r : receivers )
+				so_5::send< so_5::shared_buffer_message >( r, buf );
+
+			std::size_t acks = 0u;
+			so_5::receive(
+					so_5::from( ch ).handle_n( receivers.size() ),
+					[&]( so_5::mhood_t< so_5::shared_buffer_message > cmd ) {
+						ensure_or_die( cmd->buffer().shares_storage_with( buf ),
+								"ack must share the storage with the original" );
+						ensure_or_die( 4u == cmd->size(), "unexpected ack size" );
+						++acks;
+					} );
+
+			ensure_or_die( receivers.size() == acks, "unexpected count of acks" );
+		},
+		5 );
+}
+
+int
+main()
+{
+	check_slices();
+	check_adopted_buffer();
+	check_mapped_file();
+	check_delivery();
+
+	return 0;
+}
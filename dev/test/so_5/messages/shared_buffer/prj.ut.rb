@@ -0,0 +1,9 @@
+require 'mxx_ru/binary_unittest'
+
+path = "test/so_5/messages/shared_buffer"
+
+MxxRu::setup_target(
+	MxxRu::Binary_unittest_target.new(
+		"#{path}/prj.ut.rb",
+		"#{path}/prj.rb" )
+)
@@ -151,6 +151,10 @@ main()
 		cases.push_back( case_info_t{ "combined_lock(1us)",
 				combined_lock_factory( std::chrono::microseconds(1) ) } );
 		cases.push_back( case_info_t{ "simple_lock", simple_lock_factory() } );
+		cases.push_back( case_info_t{ "busy_poll_lock(infinite)",
+				busy_poll_lock_factory() } );
+		cases.push_back( case_info_t{ "busy_poll_lock(1ms)",
+				busy_poll_lock_factory( std::chrono::milliseconds(1) ) } );
 
 		for( const auto & c : cases )
 		{